@@ -0,0 +1,135 @@
+/**
+ * @file demo_cpu_performance_guard.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Compare the wake up jitter of a Spinner loop with and without
+ * pinning the frequency and the idle states of its CPU.
+ *
+ * Usage: demo_cpu_performance_guard [cpu] [nb_cycles]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "real_time_tools/process_manager.hpp"
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief Wake up jitter of a loop, in seconds. */
+struct Jitter
+{
+    /** @brief Number of cycles to measure. */
+    int nb_cycles;
+    /** @brief Period of the loop. */
+    double period;
+    /** @brief Average absolute deviation from the period. */
+    double mean;
+    /** @brief Standard deviation of the measured periods. */
+    double std_dev;
+    /** @brief Largest absolute deviation from the period. */
+    double max;
+};
+
+/** @brief Run a Spinner loop and measure the deviation of each period. */
+THREAD_FUNCTION_RETURN_TYPE measure_jitter(void* jitter_ptr)
+{
+    Jitter& jitter = *static_cast<Jitter*>(jitter_ptr);
+    std::vector<double> periods(jitter.nb_cycles);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(jitter.period);
+    spinner.initialize();
+    spinner.spin();
+    double previous_date = real_time_tools::Timer::get_current_time_sec();
+    for (int i = 0; i < jitter.nb_cycles; ++i)
+    {
+        spinner.spin();
+        double date = real_time_tools::Timer::get_current_time_sec();
+        periods[i] = date - previous_date;
+        previous_date = date;
+    }
+
+    double sum = 0.0, sum_squares = 0.0;
+    jitter.mean = 0.0;
+    jitter.max = 0.0;
+    for (int i = 0; i < jitter.nb_cycles; ++i)
+    {
+        double deviation = std::fabs(periods[i] - jitter.period);
+        jitter.mean += deviation / jitter.nb_cycles;
+        jitter.max = std::max(jitter.max, deviation);
+        sum += periods[i];
+        sum_squares += periods[i] * periods[i];
+    }
+    double mean_period = sum / jitter.nb_cycles;
+    jitter.std_dev = std::sqrt(std::max(
+        0.0, sum_squares / jitter.nb_cycles - mean_period * mean_period));
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Measure the jitter of a 1kHz loop running on a given CPU. */
+Jitter run_measurement(int cpu_id, int nb_cycles)
+{
+    Jitter jitter;
+    jitter.nb_cycles = nb_cycles;
+    jitter.period = 0.001;
+    real_time_tools::RealTimeThread thread;
+    thread.parameters_.cpu_id_ = {cpu_id};
+    thread.create_realtime_thread(&measure_jitter, &jitter);
+    thread.join();
+    return jitter;
+}
+
+/** @brief Measure the jitter without then with the pinning of the CPU. */
+int main(int argc, char* argv[])
+{
+    int cpu_id = argc > 1 ? std::atoi(argv[1]) : 0;
+    int nb_cycles = argc > 2 ? std::atoi(argv[2]) : 5000;
+
+    Jitter free_jitter = run_measurement(cpu_id, nb_cycles);
+    Jitter pinned_jitter;
+    {
+        //! [Usage of CpuPerformanceGuard]
+
+        real_time_tools::CpuPerformanceGuard guard({cpu_id});
+        guard.set_governor("performance");
+        // pin the frequency to the maximum
+        guard.set_min_frequency();
+        // only allow polling
+        guard.disable_idle_states(0);
+        pinned_jitter = run_measurement(cpu_id, nb_cycles);
+        // the previous settings are restored here.
+
+        //! [Usage of CpuPerformanceGuard]
+    }
+
+    printf("wake up jitter of a 1kHz Spinner on cpu %d (%d cycles), us:\n",
+           cpu_id,
+           nb_cycles);
+    printf("%-12s %10s %10s %10s\n", "", "mean", "std_dev", "max");
+    printf("%-12s %10.2f %10.2f %10.2f\n",
+           "not pinned",
+           free_jitter.mean * 1e6,
+           free_jitter.std_dev * 1e6,
+           free_jitter.max * 1e6);
+    printf("%-12s %10.2f %10.2f %10.2f\n",
+           "pinned",
+           pinned_jitter.mean * 1e6,
+           pinned_jitter.std_dev * 1e6,
+           pinned_jitter.max * 1e6);
+    return 0;
+}
+
+/**
+ * \example demo_cpu_performance_guard.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::CpuPerformanceGuard. A 1kHz Spinner loop is run twice on
+ * the same CPU, first with the current frequency and idle state settings,
+ * then with the performance governor, the minimum frequency set to the
+ * maximum and all the idle states but polling disabled. The wake up jitter
+ * of both runs is displayed. It needs to run as root to change the settings.
+ */
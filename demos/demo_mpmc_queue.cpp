@@ -0,0 +1,172 @@
+/**
+ * @file demo_mpmc_queue.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the MpmcQueue against a mutex protected queue, with N
+ * producers sending commands to one consumer polling the queue.
+ *
+ * Usage: demo_mpmc_queue [max_nb_producers]
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "real_time_tools/threadsafe/mpmc_queue.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief A command for the real time loop. */
+struct Command
+{
+    /** @brief Producer of the command. */
+    int producer;
+    /** @brief Desired joint positions. */
+    double positions[6];
+};
+
+/** @brief Capacity of the queues. */
+const size_t CAPACITY = 256;
+
+/** @brief Number of commands sent by each producer. */
+const int NB_COMMANDS = 100000;
+
+/** @brief Ring of commands protected by a mutex, for comparison. */
+class MutexQueue
+{
+public:
+    /** @brief Construct an empty queue. */
+    MutexQueue() : push_position_(0), pop_position_(0)
+    {
+    }
+
+    /** @brief Push a command, false if the queue is full. */
+    bool try_push(const Command& command)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (push_position_ - pop_position_ == CAPACITY)
+        {
+            return false;
+        }
+        commands_[push_position_++ % CAPACITY] = command;
+        return true;
+    }
+
+    /** @brief Pop a command, false if the queue is empty. */
+    bool try_pop(Command& command)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (push_position_ == pop_position_)
+        {
+            return false;
+        }
+        command = commands_[pop_position_++ % CAPACITY];
+        return true;
+    }
+
+private:
+    /** @brief Protects the ring. */
+    std::mutex mutex_;
+    /** @brief The ring. */
+    std::array<Command, CAPACITY> commands_;
+    /** @brief Number of commands pushed. */
+    size_t push_position_;
+    /** @brief Number of commands popped. */
+    size_t pop_position_;
+};
+
+/** @brief Producer, retries while the queue is full. */
+template <typename Queue>
+void producer(Queue* queue, int index, std::atomic<bool>* start)
+{
+    while (!*start)
+    {
+    }
+    Command command = Command();
+    command.producer = index;
+    for (int i = 0; i < NB_COMMANDS; ++i)
+    {
+        command.positions[0] = i;
+        while (!queue->try_push(command))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/** @brief Run the producers and the polling consumer, display the results. */
+template <typename Queue>
+void run(const char* name, int nb_producers)
+{
+    Queue queue;
+    std::atomic<bool> start(false);
+    std::vector<std::thread> producers;
+    for (int index = 0; index < nb_producers; ++index)
+    {
+        producers.push_back(
+            std::thread(&producer<Queue>, &queue, index, &start));
+    }
+
+    // the consumer polls the queue like a real time loop would ------------
+    long nb_received = 0;
+    double max_pop_duration = 0.0;
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    start = true;
+    while (nb_received < static_cast<long>(nb_producers) * NB_COMMANDS)
+    {
+        //! [Usage of MpmcQueue]
+        Command command;
+        double pop_date = real_time_tools::Timer::get_current_time_sec();
+        bool received = queue.try_pop(command);
+        max_pop_duration = std::max(
+            max_pop_duration,
+            real_time_tools::Timer::get_current_time_sec() - pop_date);
+        if (received)
+        {
+            // apply the command ...
+            ++nb_received;
+        }
+        //! [Usage of MpmcQueue]
+    }
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    for (std::thread& producer_thread : producers)
+    {
+        producer_thread.join();
+    }
+    printf("%2d producers, %-11s %7.1f ns per command, "
+           "max try_pop() %8.1f us\n",
+           nb_producers,
+           name,
+           duration / nb_received * 1e9,
+           max_pop_duration * 1e6);
+}
+
+/** @brief Compare the queues with more and more producers. */
+int main(int argc, char* argv[])
+{
+    int max_nb_producers = argc > 1 ? std::atoi(argv[1]) : 4;
+    for (int nb_producers = 1; nb_producers <= max_nb_producers;
+         nb_producers *= 2)
+    {
+        run<real_time_tools::MpmcQueue<Command, CAPACITY>>("MpmcQueue",
+                                                           nb_producers);
+        run<MutexQueue>("MutexQueue", nb_producers);
+    }
+    return 0;
+}
+
+/**
+ * \example demo_mpmc_queue.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::MpmcQueue. N producers send commands to a consumer that
+ * polls the queue like a real time loop. The MpmcQueue is compared to a
+ * ring protected by a mutex: the consumer of the mutex queue waits whenever
+ * a producer holds the mutex, which shows in the maximum duration of
+ * try_pop().
+ */
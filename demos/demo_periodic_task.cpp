@@ -0,0 +1,52 @@
+/**
+ * @file demo_periodic_task.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Demo of the PeriodicTask class usage
+ */
+
+#include <cmath>
+#include "real_time_tools/periodic_task.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief Some computation to run at 1kHz. */
+void control()
+{
+    volatile double value = 0.0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        value = value + std::sin(static_cast<double>(i));
+    }
+}
+
+/** @brief This a demo on how to use the PeriodicTask class. */
+int main(int, char* [])
+{
+    //! [Usage of PeriodicTask]
+
+    // 1kHz, priority 80, pinned to CPU 0.
+    real_time_tools::PeriodicTask task(&control, 0.001, 80, 0);
+    task.start();
+    for (int i = 0; i < 5; ++i)
+    {
+        real_time_tools::Timer::sleep_sec(1.0);
+        // does not block the real time loop.
+        task.print_statistics();
+    }
+    task.stop();
+
+    //! [Usage of PeriodicTask]
+    return 0;
+}
+
+/**
+ * \example demo_periodic_task.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::PeriodicTask. It replaces the combination of a
+ * RealTimeThread, a Spinner, a RealTimeCheck and a Timer: the user function
+ * is called on a drift-free grid of deadlines and the execution time and the
+ * wakeup latency are measured separately.
+ */
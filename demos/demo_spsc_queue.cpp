@@ -0,0 +1,196 @@
+/**
+ * @file demo_spsc_queue.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the throughput of the SpscQueue with batches of
+ * different sizes, and the latency and the wake ups of a logger fed by a
+ * 4kHz force sensor thread with different watermarks.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/mpmc_queue.hpp"
+#include "real_time_tools/threadsafe/spsc_queue.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief A sample of a 6 axis force sensor. */
+struct ForceSample
+{
+    /** @brief Date of the sample, in seconds. */
+    double date;
+    /** @brief Forces and torques. */
+    double wrench[6];
+};
+
+/** @brief Queue between the sensor and the logger. */
+typedef real_time_tools::SpscQueue<ForceSample, 1024> SampleQueue;
+
+/** @brief Number of samples of the throughput benchmarks. */
+const int NB_THROUGHPUT_SAMPLES = 2000000;
+
+/** @brief Number of samples of the latency benchmarks, 2 s at 4kHz. */
+const int NB_LATENCY_SAMPLES = 8000;
+
+/** @brief Push and pop the samples by batches as fast as possible. */
+void throughput(size_t batch_size)
+{
+    SampleQueue queue;
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    std::thread producer([&queue, batch_size]() {
+        ForceSample batch[64] = {};
+        int nb_pushed = 0;
+        while (nb_pushed < NB_THROUGHPUT_SAMPLES)
+        {
+            size_t nb_elements = std::min(
+                batch_size,
+                static_cast<size_t>(NB_THROUGHPUT_SAMPLES - nb_pushed));
+            size_t nb_new = queue.push_n(batch, nb_elements);
+            if (nb_new == 0)
+            {
+                // the queue is full, let the consumer run.
+                std::this_thread::yield();
+            }
+            nb_pushed += nb_new;
+        }
+    });
+    ForceSample batch[64];
+    int nb_popped = 0;
+    while (nb_popped < NB_THROUGHPUT_SAMPLES)
+    {
+        size_t nb_new = queue.pop_n(batch, batch_size);
+        if (nb_new == 0)
+        {
+            // the queue is empty, let the producer run.
+            std::this_thread::yield();
+        }
+        nb_popped += nb_new;
+    }
+    producer.join();
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    printf("SpscQueue, batches of %2lu: %6.1f ns per sample\n",
+           static_cast<unsigned long>(batch_size),
+           duration / NB_THROUGHPUT_SAMPLES * 1e9);
+}
+
+/** @brief Same as throughput() with a MpmcQueue, one sample at a time. */
+void mpmc_throughput()
+{
+    real_time_tools::MpmcQueue<ForceSample, 1024> queue;
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    std::thread producer([&queue]() {
+        ForceSample sample = {};
+        for (int i = 0; i < NB_THROUGHPUT_SAMPLES; ++i)
+        {
+            while (!queue.try_push(sample))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    ForceSample sample;
+    int nb_popped = 0;
+    while (nb_popped < NB_THROUGHPUT_SAMPLES)
+    {
+        if (queue.try_pop(sample))
+        {
+            ++nb_popped;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    printf("MpmcQueue, one by one:     %6.1f ns per sample\n",
+           duration / NB_THROUGHPUT_SAMPLES * 1e9);
+}
+
+/** @brief Force sensor acquisition at 4kHz. */
+THREAD_FUNCTION_RETURN_TYPE sensor_acquisition(void* queue_ptr)
+{
+    SampleQueue& queue = *static_cast<SampleQueue*>(queue_ptr);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(2.5e-4);
+    for (int i = 0; i < NB_LATENCY_SAMPLES; ++i)
+    {
+        ForceSample sample = {};
+        sample.date = real_time_tools::Timer::get_current_time_sec();
+        sample.wrench[2] = i;
+        queue.try_push(sample);
+        spinner.spin();
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Logger sleeping until watermark samples are queued. */
+void latency(size_t watermark)
+{
+    SampleQueue queue(watermark);
+    real_time_tools::RealTimeThread sensor_thread;
+    sensor_thread.create_realtime_thread(&sensor_acquisition, &queue);
+
+    int nb_logged = 0;
+    int nb_wake_ups = 0;
+    double total_latency = 0.0;
+    double max_latency = 0.0;
+    while (nb_logged < NB_LATENCY_SAMPLES)
+    {
+        //! [Usage of SpscQueue]
+        // sleep until a batch is ready, or flush what is there after 50 ms.
+        queue.wait_for_elements_for(std::chrono::milliseconds(50));
+        ++nb_wake_ups;
+        real_time_tools::SpscSpan<const ForceSample> samples = queue.peek();
+        double now = real_time_tools::Timer::get_current_time_sec();
+        for (const ForceSample& sample : samples)
+        {
+            // write the sample in the log ...
+            total_latency += now - sample.date;
+            max_latency = std::max(max_latency, now - sample.date);
+        }
+        queue.consume(samples.size());
+        //! [Usage of SpscQueue]
+        nb_logged += samples.size();
+    }
+    sensor_thread.join();
+    printf("watermark %2lu: %5d wake ups, "
+           "latency mean %6.3f ms, max %6.3f ms\n",
+           static_cast<unsigned long>(watermark),
+           nb_wake_ups,
+           total_latency / nb_logged * 1e3,
+           max_latency * 1e3);
+}
+
+/** @brief Run the benchmarks. */
+int main(int, char* [])
+{
+    for (size_t batch_size : {1, 16, 64})
+    {
+        throughput(batch_size);
+    }
+    mpmc_throughput();
+    for (size_t watermark : {1, 16, 64})
+    {
+        latency(watermark);
+    }
+    return 0;
+}
+
+/**
+ * \example demo_spsc_queue.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::SpscQueue. First a producer and a consumer exchange
+ * samples as fast as possible with batches of different sizes, and with a
+ * real_time_tools::MpmcQueue for comparison. Then a real time thread pushes
+ * the samples of a force sensor at 4kHz to a logger that sleeps until the
+ * queue reaches its watermark: a higher watermark means less wake ups and a
+ * higher latency.
+ */
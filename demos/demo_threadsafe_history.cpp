@@ -0,0 +1,92 @@
+/**
+ * @file demo_threadsafe_history.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Log the samples of a sensor from a real time thread with a
+ * ThreadsafeHistory, with a fast and a slow reader.
+ */
+
+#include <eigen3/Eigen/Core>
+#include <thread>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_history.hpp"
+
+/** @brief A sample of the sensor. */
+typedef Eigen::Matrix<double, 6, 1> Sample;
+
+/** @brief The last 100 ms of samples at 1kHz. */
+typedef real_time_tools::ThreadsafeHistory<Sample, 100> SampleHistory;
+
+/** @brief Number of samples acquired. */
+const int NB_SAMPLES = 2000;
+
+/** @brief Real time acquisition at 1kHz. */
+THREAD_FUNCTION_RETURN_TYPE acquisition(void* history_ptr)
+{
+    SampleHistory& history = *static_cast<SampleHistory*>(history_ptr);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-3);
+    for (int i = 0; i < NB_SAMPLES; ++i)
+    {
+        // timestamped with the current date.
+        history.add(Sample::Constant(i));
+        spinner.spin();
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Reads all the samples, sleeping after each of them. */
+void logger(const SampleHistory* history, double sleep_duration)
+{
+    //! [Usage of ThreadsafeHistory]
+    real_time_tools::HistoryElement<Sample> element;
+    element.id_ = history->get_oldest_id();
+    int nb_read = 1;
+    int nb_lost = 0;
+    while (element.id_ + 1 < NB_SAMPLES)
+    {
+        size_t id = element.id_;
+        // waits for the sample after id.
+        if (history->get_next(id, element) ==
+            real_time_tools::HistoryStatus::OVERWRITTEN)
+        {
+            // the logger fell behind, it skips the samples up to element.id_
+            // and reads the next one.
+            nb_lost += element.id_ - id;
+            continue;
+        }
+        ++nb_read;
+        real_time_tools::Timer::sleep_sec(sleep_duration);
+    }
+    //! [Usage of ThreadsafeHistory]
+    printf("logger sleeping %5.1f ms per sample: %4d read, %4d lost\n",
+           sleep_duration * 1e3,
+           nb_read,
+           nb_lost);
+}
+
+/** @brief Run the acquisition and the two loggers. */
+int main(int, char* [])
+{
+    SampleHistory history;
+    std::thread fast_logger(&logger, &history, 0.0);
+    std::thread slow_logger(&logger, &history, 2e-3);
+    real_time_tools::RealTimeThread acquisition_thread;
+    acquisition_thread.create_realtime_thread(&acquisition, &history);
+    acquisition_thread.join();
+    fast_logger.join();
+    slow_logger.join();
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_history.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::ThreadsafeHistory. A real time thread adds sensor
+ * samples at 1kHz in a history of 100 samples. A fast logger reads all of
+ * them, a slow logger falls behind and is told how many samples it lost.
+ */
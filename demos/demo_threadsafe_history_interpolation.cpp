@@ -0,0 +1,143 @@
+/**
+ * @file demo_threadsafe_history_interpolation.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Look up the joint positions and the orientation of a robot at the
+ * date of camera images, from the histories of a 1kHz encoder thread and a
+ * 200Hz IMU thread.
+ */
+
+#include <cmath>
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/Geometry>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_history.hpp"
+
+/** @brief Joint positions. */
+typedef Eigen::Matrix<double, 12, 1> JointPositions;
+
+/** @brief Last second of joint positions at 1kHz. */
+typedef real_time_tools::ThreadsafeHistory<JointPositions, 1000>
+    EncoderHistory;
+
+/** @brief Last second of orientations at 200Hz. */
+typedef real_time_tools::ThreadsafeHistory<Eigen::Quaterniond, 200>
+    ImuHistory;
+
+/** @brief Duration of the acquisitions. */
+const double DURATION = 2.0;
+
+/** @brief Date of the start of the acquisitions. */
+const double START_DATE = real_time_tools::Timer::get_current_time_sec();
+
+/** @brief The joints move at 1 rad/s. */
+JointPositions get_joint_positions(double date)
+{
+    return JointPositions::Constant(date - START_DATE);
+}
+
+/** @brief The robot turns around z at 1 rad/s. */
+Eigen::Quaterniond get_orientation(double date)
+{
+    return Eigen::Quaterniond(
+        Eigen::AngleAxisd(date - START_DATE, Eigen::Vector3d::UnitZ()));
+}
+
+/** @brief Acquisition of the encoders at 1kHz. */
+THREAD_FUNCTION_RETURN_TYPE encoder_acquisition(void* history_ptr)
+{
+    EncoderHistory& history = *static_cast<EncoderHistory*>(history_ptr);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-3);
+    for (int i = 0; i < DURATION * 1000; ++i)
+    {
+        double date = real_time_tools::Timer::get_current_time_sec();
+        history.add(get_joint_positions(date), date);
+        spinner.spin();
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Acquisition of the IMU at 200Hz. */
+THREAD_FUNCTION_RETURN_TYPE imu_acquisition(void* history_ptr)
+{
+    ImuHistory& history = *static_cast<ImuHistory*>(history_ptr);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(5e-3);
+    for (int i = 0; i < DURATION * 200; ++i)
+    {
+        double date = real_time_tools::Timer::get_current_time_sec();
+        history.add(get_orientation(date), date);
+        spinner.spin();
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Fuse the streams at the dates of the images, at 30Hz. */
+int main(int, char* [])
+{
+    EncoderHistory encoders;
+    ImuHistory imu;
+    real_time_tools::RealTimeThread encoder_thread, imu_thread;
+    encoder_thread.create_realtime_thread(&encoder_acquisition, &encoders);
+    imu_thread.create_realtime_thread(&imu_acquisition, &imu);
+
+    // the images arrive 50 ms after they are taken.
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1.0 / 30.0);
+    double max_position_error = 0.0;
+    double max_orientation_error = 0.0;
+    int nb_fused = 0;
+    for (int i = 3; i < DURATION * 30; ++i)
+    {
+        spinner.spin();
+        double image_date =
+            real_time_tools::Timer::get_current_time_sec() - 0.05;
+
+        //! [Usage of at]
+        real_time_tools::HistoryElement<JointPositions> positions;
+        real_time_tools::HistoryElement<Eigen::Quaterniond> orientation;
+        if (encoders.at(image_date,
+                        positions,
+                        real_time_tools::HistoryLookup::INTERPOLATE) !=
+                real_time_tools::HistoryStatus::OK ||
+            imu.at(image_date,
+                   orientation,
+                   real_time_tools::HistoryLookup::INTERPOLATE) !=
+                real_time_tools::HistoryStatus::OK)
+        {
+            // the date is too old or the sensors are late.
+            continue;
+        }
+        //! [Usage of at]
+
+        max_position_error = std::max(
+            max_position_error,
+            (positions.datum_ - get_joint_positions(image_date)).norm());
+        max_orientation_error = std::max(
+            max_orientation_error,
+            orientation.datum_.angularDistance(get_orientation(image_date)));
+        ++nb_fused;
+    }
+    encoder_thread.join();
+    imu_thread.join();
+
+    printf("%d images fused, max errors: positions %g, orientation %g rad\n",
+           nb_fused,
+           max_position_error,
+           max_orientation_error);
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_history_interpolation.cpp
+ *
+ * This demos has for purpose to present real_time_tools::ThreadsafeHistory
+ * ::at(). Two real time threads add joint positions at 1kHz and IMU
+ * orientations at 200Hz to their histories. At 30Hz, the main thread looks
+ * up both streams at the date of a camera image: the joint positions are
+ * interpolated linearly and the orientations with a slerp.
+ */
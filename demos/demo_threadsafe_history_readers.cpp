@@ -0,0 +1,245 @@
+/**
+ * @file demo_threadsafe_history_readers.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark a ThreadsafeHistory broadcasting the state of a robot
+ * from 1 writer to 8 HistoryReader: first as fast as possible, then with a
+ * 1kHz real time writer and readers of different speeds.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_history.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief State of a 12 joints robot, published at every control cycle. */
+struct RobotState
+{
+    /** @brief Number of the control cycle. */
+    int cycle;
+    /** @brief Joint positions. */
+    double positions[12];
+    /** @brief Joint velocities. */
+    double velocities[12];
+};
+
+namespace real_time_tools
+{
+/** @brief RobotState is copied with memcpy, the writer never waits. */
+template <>
+struct use_seqlock_storage<RobotState> : std::true_type
+{
+};
+}  // namespace real_time_tools
+
+/** @brief Number of states kept by the history. */
+const size_t CAPACITY = 256;
+
+/** @brief History of the states. */
+typedef real_time_tools::ThreadsafeHistory<RobotState, CAPACITY> StateHistory;
+
+/** @brief Cursor of a reader of the history. */
+typedef real_time_tools::HistoryReader<RobotState, CAPACITY> StateReader;
+
+/** @brief Number of readers. */
+const int NB_READERS = 8;
+
+/** @brief Number of states of the throughput benchmark. */
+const int NB_THROUGHPUT_STATES = 1000000;
+
+/** @brief Number of states of the real time benchmark, 2 s at 1kHz. */
+const int NB_CYCLES = 2000;
+
+/** @brief Statistics of a reader. */
+struct ReaderStatistics
+{
+    /** @brief Number of states read. */
+    long nb_read;
+    /** @brief Largest lag seen before a read. */
+    size_t max_lag;
+};
+
+/** @brief Display the statistics of the readers. */
+void print_readers(const std::vector<StateReader>& readers,
+                   const std::vector<ReaderStatistics>& statistics)
+{
+    for (size_t r = 0; r < readers.size(); ++r)
+    {
+        printf("    reader %lu: %7ld read, %7lu lost in %5lu overruns, "
+               "max lag %4lu\n",
+               static_cast<unsigned long>(r),
+               statistics[r].nb_read,
+               static_cast<unsigned long>(readers[r].get_nb_lost_elements()),
+               static_cast<unsigned long>(readers[r].get_nb_overruns()),
+               static_cast<unsigned long>(statistics[r].max_lag));
+    }
+}
+
+/**
+ * @brief Add states as fast as possible while readers poll the history,
+ * display the cost of an add().
+ */
+void throughput(int nb_readers)
+{
+    StateHistory history;
+    std::vector<StateReader> readers(nb_readers, StateReader(history));
+    std::vector<ReaderStatistics> statistics(nb_readers, ReaderStatistics());
+    std::atomic<bool> done(false);
+    std::vector<std::thread> reader_threads;
+    for (int r = 0; r < nb_readers; ++r)
+    {
+        reader_threads.push_back(std::thread([&, r]() {
+            real_time_tools::HistoryElement<RobotState> element;
+            while (!done || readers[r].get_lag() > 0)
+            {
+                statistics[r].max_lag =
+                    std::max(statistics[r].max_lag, readers[r].get_lag());
+                real_time_tools::HistoryStatus status =
+                    readers[r].try_read(element);
+                if (status == real_time_tools::HistoryStatus::OK)
+                {
+                    ++statistics[r].nb_read;
+                }
+                else if (status ==
+                         real_time_tools::HistoryStatus::NOT_ADDED_YET)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    RobotState state = RobotState();
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    for (int i = 0; i < NB_THROUGHPUT_STATES; ++i)
+    {
+        state.cycle = i;
+        history.add(state);
+    }
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    done = true;
+    for (std::thread& reader_thread : reader_threads)
+    {
+        reader_thread.join();
+    }
+    printf("%d readers polling: %6.1f ns per add()\n",
+           nb_readers,
+           duration / NB_THROUGHPUT_STATES * 1e9);
+    print_readers(readers, statistics);
+}
+
+/** @brief Arguments of the real time control loop. */
+struct ControlLoop
+{
+    /** @brief The history the states are added to. */
+    StateHistory* history;
+    /** @brief Longest add() duration, in seconds. */
+    double max_add_duration;
+};
+
+/** @brief Control loop at 1kHz publishing the robot state. */
+THREAD_FUNCTION_RETURN_TYPE control_loop(void* loop_ptr)
+{
+    ControlLoop& loop = *static_cast<ControlLoop*>(loop_ptr);
+    RobotState state = RobotState();
+    double date = real_time_tools::Timer::get_current_time_sec();
+    for (int cycle = 0; cycle < NB_CYCLES; ++cycle)
+    {
+        state.cycle = cycle;
+        state.positions[0] = std::sin(date);
+        double add_date = real_time_tools::Timer::get_current_time_sec();
+        // never waits for the readers, however slow they are.
+        loop.history->add(state);
+        loop.max_add_duration = std::max(
+            loop.max_add_duration,
+            real_time_tools::Timer::get_current_time_sec() - add_date);
+        date += 1e-3;
+        real_time_tools::Timer::sleep_until_sec(date);
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Reads all the states, spending processing_duration on each. */
+void reader_loop(StateReader* reader,
+                 ReaderStatistics* statistics,
+                 double processing_duration)
+{
+    //! [Usage of HistoryReader]
+    real_time_tools::HistoryElement<RobotState> element;
+    element.datum_.cycle = -1;
+    while (element.datum_.cycle < NB_CYCLES - 1)
+    {
+        statistics->max_lag = std::max(statistics->max_lag, reader->get_lag());
+        // waits for the next state. if the reader fell more than CAPACITY
+        // states behind, it counts the lost ones and skips them.
+        if (reader->read(element) ==
+            real_time_tools::HistoryStatus::OVERWRITTEN)
+        {
+            continue;
+        }
+        ++statistics->nb_read;
+        // process the state ...
+        real_time_tools::Timer::sleep_sec(processing_duration);
+    }
+    //! [Usage of HistoryReader]
+}
+
+/**
+ * @brief The control loop publishes to sleeping readers, the reader r
+ * spends r * 0.3 ms on every state: the last ones cannot keep up.
+ */
+void real_time()
+{
+    StateHistory history;
+    std::vector<StateReader> readers(NB_READERS, StateReader(history));
+    std::vector<ReaderStatistics> statistics(NB_READERS, ReaderStatistics());
+    std::vector<std::thread> reader_threads;
+    for (int r = 0; r < NB_READERS; ++r)
+    {
+        reader_threads.push_back(
+            std::thread(&reader_loop, &readers[r], &statistics[r], r * 3e-4));
+    }
+
+    ControlLoop loop = {&history, 0.0};
+    real_time_tools::RealTimeThread control_thread;
+    control_thread.create_realtime_thread(&control_loop, &loop);
+    control_thread.join();
+    for (std::thread& reader_thread : reader_threads)
+    {
+        reader_thread.join();
+    }
+    printf("1kHz control loop, %d sleeping readers: max add() %.1f us\n",
+           NB_READERS,
+           loop.max_add_duration * 1e6);
+    print_readers(readers, statistics);
+}
+
+/** @brief Run the benchmarks. */
+int main(int, char* [])
+{
+    throughput(0);
+    throughput(NB_READERS);
+    real_time();
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_history_readers.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::HistoryReader. A writer adds the state of a robot to a
+ * real_time_tools::ThreadsafeHistory read by 8 readers, first as fast as
+ * possible, then from a 1kHz real time loop to readers of different speeds.
+ * The writer never waits for the readers: the ones that fall more than the
+ * capacity of the history behind lose states and count them, the others see
+ * every state. After an overrun, a reader resumes half the capacity behind
+ * the newest state, so that it reads a burst of states before the next
+ * overrun instead of being overrun again on the next state.
+ */
@@ -0,0 +1,99 @@
+/**
+ * @file demo_threadsafe_object_layout.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the layouts of the SingletypeThreadsafeObject with N
+ * writers, each writing its own index.
+ *
+ * Usage: demo_threadsafe_object_layout [nb_writers]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief Maximum number of writers, one index per writer. */
+const size_t MAX_NB_WRITERS = 16;
+
+/** @brief Number of set() calls of each writer. */
+const int NB_SETS = 200000;
+
+/** @brief Writer of one index, as fast as possible. */
+template <typename Object>
+void writer(Object* object, size_t index, std::atomic<bool>* start)
+{
+    while (!*start)
+    {
+    }
+    for (int i = 0; i < NB_SETS; ++i)
+    {
+        object->set(i, index);
+    }
+}
+
+/** @brief Run the writers on one layout and display the throughput. */
+template <real_time_tools::ThreadsafeLayout LAYOUT>
+void run(const char* name, size_t nb_writers)
+{
+    //! [Usage of ThreadsafeLayout]
+    typedef real_time_tools::
+        SingletypeThreadsafeObject<double, MAX_NB_WRITERS, LAYOUT>
+            Object;
+    //! [Usage of ThreadsafeLayout]
+    Object object;
+
+    std::atomic<bool> start(false);
+    std::vector<std::thread> writers;
+    for (size_t index = 0; index < nb_writers; ++index)
+    {
+        writers.push_back(
+            std::thread(&writer<Object>, &object, index, &start));
+    }
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    start = true;
+    for (std::thread& writer_thread : writers)
+    {
+        writer_thread.join();
+    }
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+
+    printf("%-14s %8.1f ns per set(), %12.0f set()/s in total\n",
+           name,
+           duration / NB_SETS * 1e9,
+           nb_writers * NB_SETS / duration);
+}
+
+/** @brief Compare the two layouts. */
+int main(int argc, char* argv[])
+{
+    size_t nb_writers = argc > 1 ? std::atoi(argv[1])
+                                 : std::thread::hardware_concurrency();
+    if (nb_writers < 1 || nb_writers > MAX_NB_WRITERS)
+    {
+        nb_writers = MAX_NB_WRITERS;
+    }
+    printf("%lu writers on %lu indexes\n",
+           static_cast<unsigned long>(nb_writers),
+           static_cast<unsigned long>(nb_writers));
+    run<real_time_tools::ThreadsafeLayout::COMPACT>("compact", nb_writers);
+    run<real_time_tools::ThreadsafeLayout::CACHE_ALIGNED>("cache aligned",
+                                                          nb_writers);
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_layout.cpp
+ *
+ * This demos has for purpose to present the layouts of the
+ * real_time_tools::SingletypeThreadsafeObject. N threads write N different
+ * indexes as fast as possible. In the compact layout, neighbouring slots
+ * share cache lines and every write invalidates the lines of the other
+ * writers (false sharing). In the cache aligned layout, each slot has its
+ * own cache lines and only the count of all the updates is shared.
+ */
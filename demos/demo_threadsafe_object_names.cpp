@@ -0,0 +1,76 @@
+/**
+ * @file demo_threadsafe_object_names.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the accesses by name of the SingletypeThreadsafeObject,
+ * resolved at run time and at compile time, against the access by index.
+ */
+
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/timer.hpp"
+
+//! [Usage of ThreadsafeNames]
+/** @brief The names of the joints of a leg, known at compile time. */
+constexpr real_time_tools::ThreadsafeNames<6> JOINTS(
+    "hip_aa", "hip_fe", "knee", "ankle_fe", "ankle_aa", "toe");
+
+/** @brief The positions of the joints, with their names. */
+typedef real_time_tools::SingletypeThreadsafeObject<double, JOINTS.size()>
+    JointPositions;
+//! [Usage of ThreadsafeNames]
+
+/** @brief Number of set() and get() of each benchmark. */
+const int NB_ACCESSES = 1000000;
+
+/** @brief Run the accesses and display their duration. */
+template <typename Access>
+void run(const char* name, Access access)
+{
+    JointPositions positions(JOINTS);
+    double checksum = 0.0;
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    for (int i = 0; i < NB_ACCESSES; ++i)
+    {
+        checksum += access(positions, i);
+    }
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    printf("%-24s %6.1f ns per set() and get() (checksum %g)\n",
+           name,
+           duration / NB_ACCESSES * 1e9,
+           checksum);
+}
+
+/** @brief Compare the accesses. */
+int main(int, char* [])
+{
+    run("by index", [](JointPositions& positions, int i) {
+        positions.set(i, 2);
+        return positions.get(2);
+    });
+    run("by std::string", [](JointPositions& positions, int i) {
+        positions.set(i, std::string("knee"));
+        return positions.get(std::string("knee"));
+    });
+    run("by name at run time", [](JointPositions& positions, int i) {
+        positions.set(i, "knee");
+        return positions.get("knee");
+    });
+    run("by name at compile time", [](JointPositions& positions, int i) {
+        positions.set<JOINTS.index("knee")>(i);
+        return positions.get<JOINTS.index("knee")>();
+    });
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_names.cpp
+ *
+ * This demos has for purpose to present real_time_tools::ThreadsafeNames.
+ * The names of the data of a real_time_tools::SingletypeThreadsafeObject
+ * are given at compile time. A name resolved with ThreadsafeNames::index()
+ * in a template argument costs the same as an index, a name resolved at run
+ * time is searched in a map, and building a std::string for it allocates.
+ */
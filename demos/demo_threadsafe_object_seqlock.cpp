@@ -0,0 +1,156 @@
+/**
+ * @file demo_threadsafe_object_seqlock.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the mutex and the seqlock storages of the ThreadsafeObject
+ * with one real time writer and several concurrent readers.
+ *
+ * Usage: demo_threadsafe_object_seqlock [nb_readers]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief A sensor sample stored with the default mutex storage. */
+struct MutexSample
+{
+    /** @brief Measured values. */
+    double values[64];
+};
+
+/** @brief The same sensor sample stored with the seqlock storage. */
+struct SeqlockSample
+{
+    /** @brief Measured values. */
+    double values[64];
+};
+
+namespace real_time_tools
+{
+//! [Usage of use_seqlock_storage]
+/** @brief SeqlockSample is read and written through a seqlock. */
+template <>
+struct use_seqlock_storage<SeqlockSample> : std::true_type
+{
+};
+//! [Usage of use_seqlock_storage]
+}  // namespace real_time_tools
+
+/** @brief Number of samples written by the writer. */
+const int NB_SAMPLES = 20000;
+
+/** @brief State shared by the writer and the readers of one benchmark. */
+template <typename Sample>
+struct Benchmark
+{
+    /** @brief The object written and read. */
+    real_time_tools::ThreadsafeObject<Sample> object;
+    /** @brief Set when the writer is done. */
+    std::atomic<bool> stop;
+    /** @brief Number of reads of all the readers. */
+    std::atomic<long> nb_reads;
+    /** @brief Duration of the set() calls. */
+    real_time_tools::Timer set_timer;
+};
+
+/** @brief Real time writer at 10kHz, measures the duration of set(). */
+template <typename Sample>
+THREAD_FUNCTION_RETURN_TYPE writer(void* benchmark_ptr)
+{
+    Benchmark<Sample>& benchmark =
+        *static_cast<Benchmark<Sample>*>(benchmark_ptr);
+    Sample sample;
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-4);
+    for (int i = 0; i < NB_SAMPLES; ++i)
+    {
+        for (double& value : sample.values)
+        {
+            value = i;
+        }
+        benchmark.set_timer.tic();
+        benchmark.object.template set<0>(sample);
+        benchmark.set_timer.tac();
+        spinner.spin();
+    }
+    benchmark.stop = true;
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Non real time reader, reads as fast as possible. */
+template <typename Sample>
+void reader(Benchmark<Sample>* benchmark)
+{
+    long nb_reads = 0;
+    while (!benchmark->stop)
+    {
+        Sample sample = benchmark->object.template get<0>();
+        (void)sample;
+        ++nb_reads;
+    }
+    benchmark->nb_reads += nb_reads;
+}
+
+/** @brief Run one benchmark and display its results. */
+template <typename Sample>
+void run(const char* name, int nb_readers)
+{
+    Benchmark<Sample> benchmark;
+    benchmark.stop = false;
+    benchmark.nb_reads = 0;
+    benchmark.set_timer.set_memory_size(NB_SAMPLES);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < nb_readers; ++i)
+    {
+        readers.push_back(std::thread(&reader<Sample>, &benchmark));
+    }
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    real_time_tools::RealTimeThread writer_thread;
+    writer_thread.create_realtime_thread(&writer<Sample>, &benchmark);
+    writer_thread.join();
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    for (std::thread& reader_thread : readers)
+    {
+        reader_thread.join();
+    }
+
+    printf("%-8s set() avg %8.3f us, max %8.3f us, %12.0f reads/s\n",
+           name,
+           benchmark.set_timer.get_avg_elapsed_sec() * 1e6,
+           benchmark.set_timer.get_max_elapsed_sec() * 1e6,
+           benchmark.nb_reads / duration);
+}
+
+/** @brief Compare the two storages. */
+int main(int argc, char* argv[])
+{
+    int nb_readers = argc > 1 ? std::atoi(argv[1]) : 4;
+    printf("1 writer at 10kHz, %d readers, %lu bytes samples\n",
+           nb_readers,
+           static_cast<unsigned long>(sizeof(MutexSample)));
+    run<MutexSample>("mutex", nb_readers);
+    run<SeqlockSample>("seqlock", nb_readers);
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_seqlock.cpp
+ *
+ * This demos has for purpose to present the storage policies of the
+ * real_time_tools::ThreadsafeObject. A real time thread writes a sample at
+ * 10kHz while several normal threads read it continuously. With the default
+ * mutex storage, a reader holding the mutex delays the writer. With the
+ * seqlock storage, selected by specializing
+ * real_time_tools::use_seqlock_storage, the writer never waits and the
+ * readers retry when they read a sample being written.
+ */
@@ -0,0 +1,128 @@
+/**
+ * @file demo_threadsafe_object_shared_memory.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Share a SingletypeThreadsafeObject between a real time control
+ * process and a logger process.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+
+/** @brief The state of the robot, without pointers. */
+struct RobotState
+{
+    /** @brief Joint positions. */
+    double positions[12];
+    /** @brief Joint velocities. */
+    double velocities[12];
+    /** @brief Control cycle. */
+    long cycle;
+};
+
+namespace real_time_tools
+{
+/** @brief RobotState is copied with memcpy, it can be shared. */
+template <>
+struct use_seqlock_storage<RobotState> : std::true_type
+{
+};
+}  // namespace real_time_tools
+
+/** @brief The state shared between the processes. */
+typedef real_time_tools::SingletypeThreadsafeObject<RobotState, 1> SharedState;
+
+/** @brief Name of the shared memory segment. */
+const char SEGMENT_NAME[] = "demo_threadsafe_object_shared_memory";
+
+/** @brief Number of control cycles. */
+const long NB_CYCLES = 3000;
+
+/** @brief Real time control loop at 1kHz. */
+THREAD_FUNCTION_RETURN_TYPE control(void* state_ptr)
+{
+    SharedState& state = *static_cast<SharedState*>(state_ptr);
+    RobotState robot_state = RobotState();
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-3);
+    for (long cycle = 1; cycle <= NB_CYCLES; ++cycle)
+    {
+        robot_state.cycle = cycle;
+        robot_state.positions[0] = 1e-3 * cycle;
+        state.set(robot_state);
+        spinner.spin();
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief The logger process, waits for the states. */
+int logger()
+{
+    //! [Open the segment]
+    // in the other process: open the segment ...
+    SharedState state;
+    while (!state.open_shared_memory(SEGMENT_NAME))
+    {
+        real_time_tools::Timer::sleep_sec(0.1);
+    }
+    // ... and use the object as usual.
+    size_t last_sequence = state.get_sequence(0);
+    long nb_received = 0;
+    long nb_skipped = 0;
+    while (true)
+    {
+        real_time_tools::ThreadsafeUpdate update =
+            state.wait_for_update(0, last_sequence);
+        last_sequence = update.sequence_;
+        nb_skipped += update.nb_skipped_;
+        ++nb_received;
+        if (state.get().cycle == NB_CYCLES)
+        {
+            break;
+        }
+    }
+    //! [Open the segment]
+    printf("logger process: %ld states received, %ld skipped\n",
+           nb_received,
+           nb_skipped);
+    return 0;
+}
+
+/** @brief Fork the logger and run the control loop. */
+int main(int, char* [])
+{
+    pid_t logger_pid = fork();
+    if (logger_pid == 0)
+    {
+        return logger();
+    }
+
+    //! [Create the segment]
+    // in the control process: create the segment ...
+    SharedState state;
+    if (!state.create_shared_memory(SEGMENT_NAME))
+    {
+        return 1;
+    }
+    //! [Create the segment]
+    real_time_tools::RealTimeThread control_thread;
+    control_thread.create_realtime_thread(&control, &state);
+    control_thread.join();
+    waitpid(logger_pid, nullptr, 0);
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_shared_memory.cpp
+ *
+ * This demos has for purpose to show how to share a
+ * real_time_tools::SingletypeThreadsafeObject between processes. The control
+ * process creates the object in a named shared memory segment and writes
+ * the state of the robot at 1kHz from a real time thread. A logger process
+ * opens the segment and waits for every update, without any serialization.
+ */
@@ -0,0 +1,82 @@
+/**
+ * @file demo_threadsafe_object_timeout.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief A real time controller waits for the samples of a sensor thread
+ * with a timeout, and detects that the sensor thread died.
+ */
+
+#include <chrono>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+
+/** @brief The sensor sample. */
+typedef real_time_tools::SingletypeThreadsafeObject<double, 1> Sensor;
+
+/** @brief Number of samples before the sensor thread dies. */
+const int NB_SAMPLES = 500;
+
+/** @brief Sensor acquisition at 1kHz, that stops without warning. */
+THREAD_FUNCTION_RETURN_TYPE sensor_acquisition(void* sensor_ptr)
+{
+    Sensor& sensor = *static_cast<Sensor*>(sensor_ptr);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-3);
+    for (int i = 1; i <= NB_SAMPLES; ++i)
+    {
+        sensor.set(i);
+        spinner.spin();
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief The controller, waits at most 10 ms for each sample. */
+THREAD_FUNCTION_RETURN_TYPE controller(void* sensor_ptr)
+{
+    Sensor& sensor = *static_cast<Sensor*>(sensor_ptr);
+    size_t last_sequence = 0;
+    int nb_cycles = 0;
+    size_t nb_skipped = 0;
+    //! [Usage of wait_for_update_for]
+    real_time_tools::ThreadsafeUpdate update;
+    while (sensor.wait_for_update_for(
+        0, std::chrono::milliseconds(10), update, last_sequence))
+    {
+        last_sequence = update.sequence_;
+        nb_skipped += update.nb_skipped_;
+        // compute the control from sensor.get() ...
+        ++nb_cycles;
+    }
+    // no sample for 10 ms: the sensor thread is dead, stop the robot.
+    //! [Usage of wait_for_update_for]
+    printf("controller: %d cycles, %lu samples skipped, last sample %g\n",
+           nb_cycles,
+           static_cast<unsigned long>(nb_skipped),
+           sensor.get());
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Run the sensor and the controller threads. */
+int main(int, char* [])
+{
+    Sensor sensor;
+    real_time_tools::RealTimeThread controller_thread, sensor_thread;
+    controller_thread.create_realtime_thread(&controller, &sensor);
+    sensor_thread.create_realtime_thread(&sensor_acquisition, &sensor);
+    sensor_thread.join();
+    controller_thread.join();
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_timeout.cpp
+ *
+ * This demos has for purpose to present
+ * real_time_tools::SingletypeThreadsafeObject::wait_for_update_for(). A
+ * controller waits for the samples of a sensor thread running at 1kHz. When
+ * the sensor thread stops, the controller is not blocked forever: its wait
+ * times out after 10 ms and it can stop the robot.
+ */
@@ -0,0 +1,155 @@
+/**
+ * @file demo_threadsafe_object_transaction.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Publish the state of an estimator field by field or in one
+ * transaction, and count the wake ups and the incoherent states seen by a
+ * consumer.
+ */
+
+#include <atomic>
+#include <eigen3/Eigen/Core>
+#include <thread>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+
+/** @brief Indexes of the estimator state. */
+enum
+{
+    POSITION,
+    VELOCITY,
+    COVARIANCE
+};
+
+/** @brief The estimator state: position, velocity and covariance. */
+typedef real_time_tools::
+    ThreadsafeObject<Eigen::Vector3d, Eigen::Vector3d, Eigen::Matrix3d>
+        EstimatorState;
+
+/** @brief Number of states published. */
+const int NB_STATES = 5000;
+
+/** @brief State shared by the estimator and the consumer of one run. */
+struct Benchmark
+{
+    /** @brief The published state. */
+    EstimatorState state;
+    /** @brief Publish in one transaction or field by field? */
+    bool use_transactions;
+    /** @brief Set when the estimator is done. */
+    std::atomic<bool> stop;
+    /** @brief Number of wake ups of the consumer. */
+    long nb_wakeups;
+    /** @brief Number of states read with fields of different cycles. */
+    long nb_incoherent;
+};
+
+/** @brief Real time estimator at 2kHz, all the fields of cycle i hold i. */
+THREAD_FUNCTION_RETURN_TYPE estimator(void* benchmark_ptr)
+{
+    Benchmark& benchmark = *static_cast<Benchmark*>(benchmark_ptr);
+    real_time_tools::Spinner spinner;
+    spinner.set_period(5e-4);
+    for (int i = 1; i <= NB_STATES; ++i)
+    {
+        Eigen::Vector3d position = Eigen::Vector3d::Constant(i);
+        Eigen::Vector3d velocity = Eigen::Vector3d::Constant(i);
+        Eigen::Matrix3d covariance = Eigen::Matrix3d::Constant(i);
+        if (benchmark.use_transactions)
+        {
+            //! [Usage of set_many]
+            benchmark.state.set_many<POSITION, VELOCITY, COVARIANCE>(
+                position, velocity, covariance);
+            //! [Usage of set_many]
+        }
+        else
+        {
+            benchmark.state.set<POSITION>(position);
+            benchmark.state.set<VELOCITY>(velocity);
+            benchmark.state.set<COVARIANCE>(covariance);
+        }
+        spinner.spin();
+    }
+    // release the consumer without changing the state.
+    benchmark.stop = true;
+    benchmark.state.set<COVARIANCE>(Eigen::Matrix3d::Constant(NB_STATES));
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Consumer of the state, reads it upon every update. */
+void consumer(Benchmark* benchmark)
+{
+    size_t last_sequence = benchmark->state.get_total_sequence();
+    while (!benchmark->stop)
+    {
+        last_sequence =
+            benchmark->state.wait_for_any_update(last_sequence).sequence_;
+        ++benchmark->nb_wakeups;
+
+        double cycle;
+        if (benchmark->use_transactions)
+        {
+            //! [Usage of get_many]
+            std::tuple<Eigen::Vector3d, Eigen::Vector3d, Eigen::Matrix3d>
+                snapshot =
+                    benchmark->state.get_many<POSITION, VELOCITY, COVARIANCE>();
+            cycle = std::get<POSITION>(snapshot)(0);
+            bool coherent = std::get<VELOCITY>(snapshot)(0) == cycle &&
+                            std::get<COVARIANCE>(snapshot)(0, 0) == cycle;
+            //! [Usage of get_many]
+            benchmark->nb_incoherent += !coherent;
+        }
+        else
+        {
+            cycle = benchmark->state.get<POSITION>()(0);
+            bool coherent =
+                benchmark->state.get<VELOCITY>()(0) == cycle &&
+                benchmark->state.get<COVARIANCE>()(0, 0) == cycle;
+            benchmark->nb_incoherent += !coherent;
+        }
+    }
+}
+
+/** @brief Run one benchmark and display its results. */
+void run(const char* name, bool use_transactions)
+{
+    Benchmark benchmark;
+    benchmark.use_transactions = use_transactions;
+    benchmark.stop = false;
+    benchmark.nb_wakeups = 0;
+    benchmark.nb_incoherent = 0;
+
+    std::thread consumer_thread(&consumer, &benchmark);
+    real_time_tools::RealTimeThread estimator_thread;
+    estimator_thread.create_realtime_thread(&estimator, &benchmark);
+    estimator_thread.join();
+    consumer_thread.join();
+
+    printf("%-14s %6ld wake ups, %6ld incoherent states\n",
+           name,
+           benchmark.nb_wakeups,
+           benchmark.nb_incoherent);
+}
+
+/** @brief Compare the two ways to publish the state. */
+int main(int, char* [])
+{
+    printf("%d states published at 2kHz\n", NB_STATES);
+    run("field by field", false);
+    run("transactions", true);
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_transaction.cpp
+ *
+ * This demos has for purpose to present the transactions of the
+ * real_time_tools::ThreadsafeObject. An estimator publishes its position,
+ * velocity and covariance as three indexes. Set one by one, every field
+ * wakes up the consumer, which can read fields of two different cycles.
+ * With set_many() and get_many(), the consumer wakes up once per cycle and
+ * always reads the fields of the same cycle.
+ */
@@ -0,0 +1,128 @@
+/**
+ * @file demo_threadsafe_object_wakeups.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Count the wake ups of the consumers of a
+ * SingletypeThreadsafeObject when one index is updated at 1kHz.
+ *
+ * Usage: demo_threadsafe_object_wakeups [nb_consumers]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief Number of indexes of the object, one per consumer at most. */
+const size_t NB_INDEXES = 16;
+
+/** @brief Number of updates of the index 0. */
+const int NB_UPDATES = 2000;
+
+/** @brief The object, consumer i waits for the updates of the index i. */
+real_time_tools::SingletypeThreadsafeObject<double, NB_INDEXES> object;
+
+/** @brief Number of times each consumer returned from wait_for_update(). */
+std::array<std::atomic<long>, NB_INDEXES> nb_wakeups;
+
+/** @brief Set when the producer is done. */
+std::atomic<bool> stop(false);
+
+/** @brief Duration of the set() calls. */
+real_time_tools::Timer set_timer;
+
+/** @brief Real time producer at 1kHz, updates the index 0 only. */
+THREAD_FUNCTION_RETURN_TYPE producer(void*)
+{
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-3);
+    for (int i = 0; i < NB_UPDATES; ++i)
+    {
+        set_timer.tic();
+        object.set(i, 0);
+        set_timer.tac();
+        spinner.spin();
+    }
+    // release all the consumers.
+    stop = true;
+    for (size_t index = 0; index < NB_INDEXES; ++index)
+    {
+        object.set(0.0, index);
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Consumer of one index. */
+void consumer(size_t index)
+{
+    //! [Usage of wait_for_update]
+    size_t last_sequence = object.get_sequence(index);
+    while (!stop)
+    {
+        // only the updates of this index wake this thread up.
+        last_sequence = object.wait_for_update(index, last_sequence).sequence_;
+        ++nb_wakeups[index];
+    }
+    //! [Usage of wait_for_update]
+}
+
+/** @brief Run the consumers and the producer and display the wake ups. */
+int main(int argc, char* argv[])
+{
+    size_t nb_consumers = argc > 1 ? std::atoi(argv[1]) : 12;
+    if (nb_consumers < 1 || nb_consumers > NB_INDEXES)
+    {
+        printf("the number of consumers must be in [1, %lu]\n",
+               static_cast<unsigned long>(NB_INDEXES));
+        return 1;
+    }
+    for (std::atomic<long>& count : nb_wakeups)
+    {
+        count = 0;
+    }
+    set_timer.set_memory_size(NB_UPDATES);
+
+    std::vector<std::thread> consumers;
+    for (size_t index = 0; index < nb_consumers; ++index)
+    {
+        consumers.push_back(std::thread(&consumer, index));
+    }
+    real_time_tools::RealTimeThread producer_thread;
+    producer_thread.create_realtime_thread(&producer);
+    producer_thread.join();
+    for (std::thread& consumer_thread : consumers)
+    {
+        consumer_thread.join();
+    }
+
+    long nb_other_wakeups = 0;
+    for (size_t index = 1; index < nb_consumers; ++index)
+    {
+        nb_other_wakeups += nb_wakeups[index];
+    }
+    printf("%d updates of index 0, %lu consumers\n",
+           NB_UPDATES,
+           static_cast<unsigned long>(nb_consumers));
+    printf("wake ups of the consumer of index 0: %ld\n", nb_wakeups[0].load());
+    printf("wake ups of the other consumers:     %ld\n", nb_other_wakeups);
+    printf("set() avg %8.3f us, max %8.3f us\n",
+           set_timer.get_avg_elapsed_sec() * 1e6,
+           set_timer.get_max_elapsed_sec() * 1e6);
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_wakeups.cpp
+ *
+ * This demos has for purpose to show how the
+ * real_time_tools::SingletypeThreadsafeObject wakes up its consumers. Each
+ * index has its own futex, so the updates of one index only wake up the
+ * threads waiting for it: the consumers of the other indexes wake up once,
+ * when they are released at the end.
+ */
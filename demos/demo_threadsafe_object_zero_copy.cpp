@@ -0,0 +1,93 @@
+/**
+ * @file demo_threadsafe_object_zero_copy.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the copying set() and get() of the
+ * SingletypeThreadsafeObject against the moving set() and read(), with
+ * payloads of 1 KB and 100 KB.
+ */
+
+#include <vector>
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief A list of contacts, allocated on the heap. */
+typedef std::vector<double> Payload;
+
+/** @brief The object storing the payload. */
+typedef real_time_tools::SingletypeThreadsafeObject<Payload, 1> Object;
+
+/** @brief Number of cycles of each benchmark. */
+const int NB_CYCLES = 20000;
+
+/** @brief The producer builds a new payload every cycle. */
+Payload produce(size_t size, int cycle)
+{
+    return Payload(size, cycle);
+}
+
+/** @brief One cycle with the copies: set(const Type&) and get(). */
+double copy_cycle(Object& object, size_t size, int cycle)
+{
+    Payload payload = produce(size, cycle);
+    object.set(payload);
+    Payload copy = object.get();
+    return copy.back();
+}
+
+/** @brief One cycle without copy: set(Type&&) and read(). */
+double zero_copy_cycle(Object& object, size_t size, int cycle)
+{
+    //! [Usage of set with move]
+    Payload payload = produce(size, cycle);
+    object.set(std::move(payload));
+    //! [Usage of set with move]
+    //! [Usage of read]
+    return object.read([](const Payload& stored) { return stored.back(); });
+    //! [Usage of read]
+}
+
+/** @brief Run the cycles and display their duration. */
+template <typename Cycle>
+void run(const char* name, Cycle cycle, size_t size)
+{
+    Object object;
+    object.set(produce(size, 0));
+    double checksum = 0.0;
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    for (int i = 0; i < NB_CYCLES; ++i)
+    {
+        checksum += cycle(object, size, i);
+    }
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    printf("%6lu KB %-10s %9.1f ns per cycle (checksum %g)\n",
+           static_cast<unsigned long>(size * sizeof(double) / 1000),
+           name,
+           duration / NB_CYCLES * 1e9,
+           checksum);
+}
+
+/** @brief Compare the two APIs for each payload size. */
+int main(int, char* [])
+{
+    for (size_t size : {125, 12500})
+    {
+        run("copy", &copy_cycle, size);
+        run("zero copy", &zero_copy_cycle, size);
+    }
+    return 0;
+}
+
+/**
+ * \example demo_threadsafe_object_zero_copy.cpp
+ *
+ * This demos has for purpose to present the zero copy accesses of the
+ * real_time_tools::SingletypeThreadsafeObject. Every cycle a producer
+ * builds a new payload and a consumer reads its last value. With set() and
+ * get(), the payload is copied in and copied out. With set(Type&&) the
+ * payload is moved in, and read() runs the consumer on the stored payload
+ * under its mutex.
+ */
@@ -0,0 +1,143 @@
+/**
+ * @file demo_triple_buffer.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Benchmark the TripleBuffer against the ThreadsafeObject to publish
+ * a large matrix from a real time thread.
+ */
+
+#include <atomic>
+#include <eigen3/Eigen/Core>
+#include <thread>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/threadsafe/triple_buffer.hpp"
+#include "real_time_tools/timer.hpp"
+
+/** @brief The published state, 3.2 kB. */
+typedef Eigen::Matrix<double, 20, 20> State;
+
+/** @brief Number of states published. */
+const int NB_STATES = 20000;
+
+/** @brief State shared by the writer and the reader of one benchmark. */
+struct Benchmark
+{
+    /** @brief Mutex based handoff. */
+    real_time_tools::ThreadsafeObject<State> threadsafe_object;
+    /** @brief Wait-free handoff. */
+    real_time_tools::TripleBuffer<State> triple_buffer;
+    /** @brief Use the triple buffer or the threadsafe object? */
+    bool use_triple_buffer;
+    /** @brief Set when the writer is done. */
+    std::atomic<bool> stop;
+    /** @brief Number of reads of the reader. */
+    long nb_reads;
+    /** @brief Duration of the publications. */
+    real_time_tools::Timer publish_timer;
+};
+
+/** @brief Real time writer at 10kHz, measures the duration of the handoff. */
+THREAD_FUNCTION_RETURN_TYPE writer(void* benchmark_ptr)
+{
+    Benchmark& benchmark = *static_cast<Benchmark*>(benchmark_ptr);
+    State state;
+    real_time_tools::Spinner spinner;
+    spinner.set_period(1e-4);
+    for (int i = 0; i < NB_STATES; ++i)
+    {
+        if (benchmark.use_triple_buffer)
+        {
+            //! [Usage of TripleBuffer]
+
+            // compute the state in place ...
+            benchmark.triple_buffer.get_back_buffer().setConstant(i);
+            // ... and hand it to the reader.
+            benchmark.publish_timer.tic();
+            benchmark.triple_buffer.publish();
+            benchmark.publish_timer.tac();
+
+            //! [Usage of TripleBuffer]
+        }
+        else
+        {
+            state.setConstant(i);
+            benchmark.publish_timer.tic();
+            benchmark.threadsafe_object.set<0>(state);
+            benchmark.publish_timer.tac();
+        }
+        spinner.spin();
+    }
+    benchmark.stop = true;
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief Non real time reader, reads as fast as possible. */
+void reader(Benchmark* benchmark)
+{
+    volatile double sum = 0.0;
+    while (!benchmark->stop)
+    {
+        if (benchmark->use_triple_buffer)
+        {
+            // by reference, valid until the next update().
+            const State& state = benchmark->triple_buffer.get();
+            sum = sum + state(19, 19);
+        }
+        else
+        {
+            State state = benchmark->threadsafe_object.get<0>();
+            sum = sum + state(19, 19);
+        }
+        ++benchmark->nb_reads;
+    }
+}
+
+/** @brief Run one benchmark and display its results. */
+void run(const char* name, bool use_triple_buffer)
+{
+    Benchmark benchmark;
+    benchmark.use_triple_buffer = use_triple_buffer;
+    benchmark.stop = false;
+    benchmark.nb_reads = 0;
+    benchmark.publish_timer.set_memory_size(NB_STATES);
+
+    std::thread reader_thread(&reader, &benchmark);
+    double start_date = real_time_tools::Timer::get_current_time_sec();
+    real_time_tools::RealTimeThread writer_thread;
+    writer_thread.create_realtime_thread(&writer, &benchmark);
+    writer_thread.join();
+    double duration =
+        real_time_tools::Timer::get_current_time_sec() - start_date;
+    reader_thread.join();
+
+    printf("%-18s publish avg %8.3f us, max %8.3f us, %12.0f reads/s\n",
+           name,
+           benchmark.publish_timer.get_avg_elapsed_sec() * 1e6,
+           benchmark.publish_timer.get_max_elapsed_sec() * 1e6,
+           benchmark.nb_reads / duration);
+}
+
+/** @brief Compare the two handoffs. */
+int main(int, char* [])
+{
+    printf("1 writer at 10kHz, 1 reader, %lu bytes states\n",
+           static_cast<unsigned long>(sizeof(State)));
+    run("ThreadsafeObject", false);
+    run("TripleBuffer", true);
+    return 0;
+}
+
+/**
+ * \example demo_triple_buffer.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::TripleBuffer. A real time thread publishes a 20x20 matrix
+ * at 10kHz while a normal thread reads it continuously. The
+ * real_time_tools::ThreadsafeObject copies the matrix under a mutex upon
+ * set() and get(), the triple buffer swaps buffer indexes with one atomic
+ * operation and the reader reads the matrix by reference.
+ */
@@ -0,0 +1,86 @@
+/**
+ * @file demo_worker_pool.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Demo of the WorkerPool class usage
+ */
+
+#include <array>
+#include <cmath>
+#include "real_time_tools/spinner.hpp"
+#include "real_time_tools/thread.hpp"
+#include "real_time_tools/timer.hpp"
+#include "real_time_tools/worker_pool.hpp"
+
+/** @brief Some computation per leg of a quadruped. */
+void compute_leg(std::array<double, 4>& results, std::size_t leg)
+{
+    double value = 0.0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        value += std::sin(static_cast<double>(i + leg));
+    }
+    results[leg] = value;
+}
+
+/** @brief implement a 1kHz real time loop with parallel phases */
+THREAD_FUNCTION_RETURN_TYPE thread_function(void* pool_ptr)
+{
+    real_time_tools::WorkerPool* pool =
+        static_cast<real_time_tools::WorkerPool*>(pool_ptr);
+    std::array<double, 4> results;
+
+    real_time_tools::Spinner spinner;
+    spinner.set_frequency(1000.0);
+    real_time_tools::Timer sequential_timer;
+    sequential_timer.set_name("sequential");
+    real_time_tools::Timer parallel_timer;
+    parallel_timer.set_name("parallel_for");
+
+    for (int i = 0; i < 2000; i++)
+    {
+        sequential_timer.tic();
+        for (std::size_t leg = 0; leg < results.size(); ++leg)
+        {
+            compute_leg(results, leg);
+        }
+        sequential_timer.tac();
+
+        parallel_timer.tic();
+        pool->parallel_for(results.size(), [&results](std::size_t leg) {
+            compute_leg(results, leg);
+        });
+        parallel_timer.tac();
+
+        spinner.spin();
+    }
+
+    sequential_timer.print_statistics();
+    parallel_timer.print_statistics();
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+/** @brief This a demo on how to use the WorkerPool class. */
+int main(int, char* [])
+{
+    // The workers run on CPUs 1, 2 and 3, the control loop on CPU 0.
+    real_time_tools::WorkerPool pool;
+    pool.start({1, 2, 3});
+
+    real_time_tools::RealTimeThread thread;
+    thread.parameters_.cpu_id_ = {0};
+    thread.create_realtime_thread(thread_function, &pool);
+    thread.join();
+}
+
+/**
+ * \example demo_worker_pool.cpp
+ *
+ * This demos has for purpose to present the class
+ * real_time_tools::WorkerPool. The pool spawns real time threads pinned to
+ * the given CPUs once, then real_time_tools::WorkerPool::parallel_for()
+ * distributes a fixed number of tasks among the workers and the calling
+ * thread without allocating memory nor taking locks.
+ */
@@ -0,0 +1,204 @@
+/**
+ * @file cpu_topology.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Discover the CPU topology of the machine and choose the CPUs of the
+ * real time threads from it.
+ */
+
+#ifndef CPU_TOPOLOGY_HPP
+#define CPU_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+
+namespace real_time_tools
+{
+/**
+ * @brief Description of one cache of a CPU, read from
+ * <sys_root>/devices/system/cpu/cpu<N>/cache/index<K>/.
+ */
+struct CpuCache
+{
+    /**
+     * @brief Level of the cache (1, 2, 3).
+     */
+    int level_;
+    /**
+     * @brief "Data", "Instruction" or "Unified".
+     */
+    std::string type_;
+    /**
+     * @brief Size of the cache in kilo-bytes.
+     */
+    int size_kb_;
+    /**
+     * @brief CPUs sharing this cache, sorted.
+     */
+    std::vector<int> shared_cpu_ids_;
+};
+
+/**
+ * @brief Description of one online logical CPU.
+ */
+struct CpuInfo
+{
+    /**
+     * @brief Index of the logical CPU, as used in
+     * RealTimeThreadParameters::cpu_id_.
+     */
+    int id_;
+    /**
+     * @brief Physical package (socket) of the CPU.
+     */
+    int package_id_;
+    /**
+     * @brief Physical core of the CPU inside its package.
+     */
+    int core_id_;
+    /**
+     * @brief Logical CPUs of the same physical core (SMT siblings),
+     * including this one, sorted.
+     */
+    std::vector<int> thread_siblings_;
+    /**
+     * @brief Caches of the CPU.
+     */
+    std::vector<CpuCache> caches_;
+    /**
+     * @brief Is the CPU isolated from the scheduler (isolcpus)?
+     */
+    bool isolated_;
+};
+
+/**
+ * @brief Topology of the online CPUs: packages, physical cores, SMT siblings,
+ * cache sharing and isolated CPUs, parsed from sysfs.
+ *
+ * The placement helpers return logical CPU indexes to be used in
+ * RealTimeThreadParameters::cpu_id_ or fix_current_process_to_cpu() instead
+ * of numbers hard coded for one machine.
+ */
+class CpuTopology
+{
+public:
+    /**
+     * @brief Construct an empty CpuTopology object, see load().
+     */
+    CpuTopology();
+
+    /**
+     * @brief Parse the topology from sysfs.
+     *
+     * @param sys_root is the mount point of sysfs, can be changed for tests.
+     * @return true if at least one CPU was found.
+     */
+    bool load(const std::string& sys_root = "/sys");
+
+    /**
+     * @brief Get the online CPUs, sorted by index.
+     *
+     * @return const std::vector<CpuInfo>&
+     */
+    const std::vector<CpuInfo>& get_cpus() const
+    {
+        return cpus_;
+    }
+
+    /**
+     * @brief Get the description of one CPU.
+     *
+     * @param cpu_id is the index of the CPU.
+     * @param[out] cpu is the description.
+     * @return true if the CPU is online.
+     */
+    bool get_cpu(int cpu_id, CpuInfo& cpu) const;
+
+    /**
+     * @brief Get the isolated CPUs.
+     *
+     * @return std::vector<int>
+     */
+    std::vector<int> get_isolated_cpus() const;
+
+    /**
+     * @brief Get the physical cores, each one as the list of its logical
+     * CPUs.
+     *
+     * @return std::vector<std::vector<int> >
+     */
+    std::vector<std::vector<int> > get_physical_cores() const;
+
+    /**
+     * @brief Get the CPUs sharing the unified or data cache of a given level
+     * with a CPU, including the CPU itself.
+     *
+     * @param cpu_id is the index of the CPU.
+     * @param level is the cache level.
+     * @return std::vector<int> empty if the cache is unknown.
+     */
+    std::vector<int> get_cache_shared_cpus(int cpu_id, int level) const;
+
+    /**
+     * @brief Find an isolated physical core whose SMT siblings are all
+     * isolated too, so they stay idle.
+     *
+     * @param excluded_cpu_ids are CPUs already used, their cores are skipped.
+     * @return int the first logical CPU of the core, -1 if there is none.
+     */
+    int find_isolated_core(
+        const std::vector<int>& excluded_cpu_ids = std::vector<int>()) const;
+
+    /**
+     * @brief Find several distinct isolated physical cores, see
+     * find_isolated_core().
+     *
+     * @param nb_cores is the number of cores to find.
+     * @param[out] cpu_ids is the first logical CPU of each core.
+     * @return true if enough cores were found.
+     */
+    bool find_isolated_cores(int nb_cores, std::vector<int>& cpu_ids) const;
+
+    /**
+     * @brief Find two CPUs on distinct physical cores that share a cache of
+     * the given level, e.g. for a producer and a consumer thread.
+     *
+     * The SMT siblings of a core are never returned as a pair: they share
+     * every cache level but also the execution units, so two busy threads
+     * on them slow each other down. Use CpuInfo::thread_siblings_ to place
+     * two threads on the same core on purpose. Isolated cores with idle
+     * siblings are preferred, then any two cores.
+     *
+     * @param level is the cache level, 2 for the L2.
+     * @param[out] first_cpu_id is the first logical CPU of the first core.
+     * @param[out] second_cpu_id is the first logical CPU of the second core.
+     * @return true if such a pair exists.
+     */
+    bool find_physical_cores_sharing_cache(int level,
+                                           int& first_cpu_id,
+                                           int& second_cpu_id) const;
+
+    /**
+     * @brief Display the topology.
+     */
+    void print() const;
+
+private:
+    /**
+     * @brief Is a physical core isolated with all its siblings and free of
+     * excluded CPUs?
+     */
+    bool is_core_available(const CpuInfo& cpu,
+                           const std::vector<int>& excluded_cpu_ids) const;
+
+    /**
+     * @brief The online CPUs, sorted by index.
+     */
+    std::vector<CpuInfo> cpus_;
+};
+
+}  // namespace real_time_tools
+
+#endif  // CPU_TOPOLOGY_HPP
@@ -0,0 +1,335 @@
+/**
+ * @file futex.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Thin wrappers around the linux futex system call and a busy-wait
+ * hint, used to build lock-free primitives that can still go to sleep, a
+ * mutex that works across processes and a condition without mutex.
+ *
+ * On platforms without futex (macOS) the wait degrades to a yield and the
+ * wake is a no-op, so callers must always re-check their condition in a
+ * loop.
+ */
+
+#ifndef RT_FUTEX_HPP
+#define RT_FUTEX_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifndef __APPLE__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace real_time_tools
+{
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex words must have the size of a 32 bits integer");
+
+/**
+ * @brief Tell the CPU that we are busy waiting (pause instruction on x86).
+ */
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Sleep as long as word == expected, until futex_wake() is called on
+ * the same word or until the absolute CLOCK_MONOTONIC deadline is reached.
+ * Spurious wake ups are possible.
+ *
+ * @param word is the futex word.
+ * @param expected is the value of the word that makes the caller sleep.
+ * @param deadline is an absolute CLOCK_MONOTONIC date, nullptr for none.
+ * @param shared must be true if the word lives in memory shared between
+ * processes.
+ * @return true if woken up (or the word had changed).
+ * @return false if the deadline was reached.
+ */
+inline bool futex_wait(std::atomic<uint32_t>& word,
+                       uint32_t expected,
+                       const struct timespec* deadline = nullptr,
+                       bool shared = false)
+{
+#ifdef __APPLE__
+    (void)expected;
+    (void)deadline;
+    (void)shared;
+    (void)word;
+    std::this_thread::yield();
+    return true;
+#else
+    // FUTEX_WAIT_BITSET takes an absolute timeout, FUTEX_WAIT a relative
+    // one.
+    int operation = FUTEX_WAIT_BITSET | (shared ? 0 : FUTEX_PRIVATE_FLAG);
+    long ret = syscall(SYS_futex,
+                       reinterpret_cast<uint32_t*>(&word),
+                       operation,
+                       expected,
+                       deadline,
+                       nullptr,
+                       FUTEX_BITSET_MATCH_ANY);
+    return !(ret == -1 && errno == ETIMEDOUT);
+#endif
+}
+
+/**
+ * @brief Wake up to nb_waiters threads sleeping in futex_wait() on word.
+ *
+ * @param word is the futex word.
+ * @param nb_waiters is the maximum number of threads to wake up.
+ * @param shared must be true if the word lives in memory shared between
+ * processes.
+ */
+inline void futex_wake(std::atomic<uint32_t>& word,
+                       int nb_waiters = INT32_MAX,
+                       bool shared = false)
+{
+#ifdef __APPLE__
+    (void)word;
+    (void)nb_waiters;
+    (void)shared;
+#else
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(&word),
+            FUTEX_WAKE | (shared ? 0 : FUTEX_PRIVATE_FLAG),
+            nb_waiters,
+            nullptr,
+            nullptr,
+            0);
+#endif
+}
+
+/**
+ * @brief Mutex made of a single futex word, so that it can be placed in
+ * memory shared between processes (see set_process_shared()). It can be
+ * used with std::unique_lock.
+ *
+ * The word is 0 when unlocked, 1 when locked, and 2 when locked with
+ * threads possibly sleeping on it: unlocking only enters the kernel in that
+ * last case.
+ */
+class FutexMutex
+{
+public:
+    /**
+     * @brief Construct a new unlocked FutexMutex object, private to the
+     * process.
+     */
+    FutexMutex() : state_(0), process_shared_(false)
+    {
+    }
+
+    /**
+     * @brief Let threads of different processes use this mutex. Must be
+     * called before the mutex is used, when it lives in shared memory.
+     *
+     * @param process_shared
+     */
+    void set_process_shared(bool process_shared)
+    {
+        process_shared_ = process_shared;
+    }
+
+    /**
+     * @brief Lock the mutex, sleeping while another thread holds it.
+     */
+    void lock()
+    {
+        uint32_t state = 0;
+        if (state_.compare_exchange_strong(state, 1))
+        {
+            return;
+        }
+        if (state != 2)
+        {
+            state = state_.exchange(2);
+        }
+        while (state != 0)
+        {
+            futex_wait(state_, 2, nullptr, process_shared_);
+            state = state_.exchange(2);
+        }
+    }
+
+    /**
+     * @brief Unlock the mutex and wake up a sleeping thread if any.
+     */
+    void unlock()
+    {
+        if (state_.exchange(0) != 1)
+        {
+            futex_wake(state_, 1, process_shared_);
+        }
+    }
+
+private:
+    /**
+     * @brief The futex word.
+     */
+    std::atomic<uint32_t> state_;
+    /**
+     * @brief Is the futex shared between processes?
+     */
+    bool process_shared_;
+};
+
+/**
+ * @brief Lets threads sleep until a condition on some lock-free data becomes
+ * true, like a condition variable without a mutex.
+ *
+ * The notifiers make the condition true, then call notify_one() or
+ * notify_all(), which only enter the kernel if a thread is waiting. The
+ * waiters register before checking the condition a last time, so a
+ * notification cannot be lost between the check and the sleep.
+ */
+class FutexCondition
+{
+public:
+    /**
+     * @brief Construct a new FutexCondition object without waiters.
+     */
+    FutexCondition() : word_(0), nb_waiters_(0)
+    {
+    }
+
+    /**
+     * @brief Wait until the predicate returns true. The predicate is called
+     * again after every notification, it can consume the data it waits for
+     * (e.g. pop an element).
+     *
+     * @tparam Predicate
+     * @param predicate is a callable returning a bool.
+     */
+    template <typename Predicate>
+    void wait(Predicate predicate)
+    {
+        wait_until(predicate, nullptr);
+    }
+
+    /**
+     * @brief Wait until the predicate returns true or until a deadline.
+     *
+     * @tparam Predicate
+     * @param predicate is a callable returning a bool.
+     * @param deadline is a date of std::chrono::steady_clock, which is
+     * CLOCK_MONOTONIC on linux.
+     * @return the last value returned by the predicate.
+     */
+    template <typename Predicate>
+    bool wait_until(Predicate predicate,
+                    const std::chrono::steady_clock::time_point& deadline)
+    {
+        return wait_until(predicate, &deadline);
+    }
+
+    /**
+     * @brief Wake up one waiting thread, if any.
+     */
+    void notify_one()
+    {
+        notify(1);
+    }
+
+    /**
+     * @brief Wake up all the waiting threads.
+     */
+    void notify_all()
+    {
+        notify(INT32_MAX);
+    }
+
+private:
+    /**
+     * @brief Implementation of the waits, without deadline if it is
+     * nullptr.
+     *
+     * @tparam Predicate
+     * @param predicate
+     * @param deadline
+     * @return the last value returned by the predicate.
+     */
+    template <typename Predicate>
+    bool wait_until(Predicate& predicate,
+                    const std::chrono::steady_clock::time_point* deadline)
+    {
+        if (predicate())
+        {
+            return true;
+        }
+        struct timespec deadline_spec = {0, 0};
+        if (deadline != nullptr)
+        {
+            int64_t deadline_ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    deadline->time_since_epoch())
+                    .count();
+            deadline_spec.tv_sec = deadline_ns / 1000000000;
+            deadline_spec.tv_nsec = deadline_ns % 1000000000;
+        }
+        bool ready = true;
+        nb_waiters_.fetch_add(1);
+        // paired with the fence of notify(): either the notifier sees this
+        // waiter, or this waiter sees the data of the notifier.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (true)
+        {
+            uint32_t word = word_.load();
+            if (predicate())
+            {
+                break;
+            }
+            if (deadline != nullptr &&
+                std::chrono::steady_clock::now() >= *deadline)
+            {
+                ready = false;
+                break;
+            }
+            futex_wait(
+                word_, word, deadline != nullptr ? &deadline_spec : nullptr);
+        }
+        nb_waiters_.fetch_sub(1);
+        return ready;
+    }
+
+    /**
+     * @brief Wake up some waiting threads, if any.
+     *
+     * @param nb_waiters is the maximum number of threads to wake up.
+     */
+    void notify(int nb_waiters)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (nb_waiters_.load(std::memory_order_relaxed) > 0)
+        {
+            word_.fetch_add(1);
+            futex_wake(word_, nb_waiters);
+        }
+    }
+
+    /**
+     * @brief Changed by every notification, the waiters sleep on it.
+     */
+    std::atomic<uint32_t> word_;
+    /**
+     * @brief Number of threads in wait().
+     */
+    std::atomic<uint32_t> nb_waiters_;
+};
+
+}  // namespace real_time_tools
+
+#endif  // RT_FUTEX_HPP
@@ -0,0 +1,187 @@
+/**
+ * @file memory.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Tools to pre-fault the stack and the heap of a real time thread and
+ * to count the page faults it takes.
+ */
+
+#ifndef RT_MEMORY_HPP
+#define RT_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace real_time_tools
+{
+/**
+ * @brief Number of page faults taken by a thread.
+ */
+struct PageFaults
+{
+    /**
+     * @brief Page faults serviced without any I/O (e.g. first touch of a
+     * page).
+     */
+    long minor_;
+    /**
+     * @brief Page faults that required I/O (e.g. reading a swapped page).
+     */
+    long major_;
+};
+
+/**
+ * @brief Get the number of page faults taken so far by the calling thread
+ * (getrusage(RUSAGE_THREAD)).
+ *
+ * @param[out] page_faults is the page fault count of the calling thread.
+ * @return true if everything went well.
+ * @return false if the OS does not provide per thread statistics.
+ */
+bool get_current_thread_page_faults(PageFaults& page_faults);
+
+/**
+ * @brief Touch "size" bytes of the calling thread stack so that the
+ * corresponding pages are mapped (and locked if mlockall(MCL_FUTURE) has been
+ * called) before the real time loop starts.
+ *
+ * The size must be smaller than the stack of the thread, keep a margin for the
+ * thread local storage and for the frames already on the stack.
+ *
+ * @param size is the number of bytes to touch.
+ */
+void prefault_stack(std::size_t size);
+
+/**
+ * @brief Grow the heap of the calling thread by "size" bytes, touch it and
+ * hand it back to malloc without returning it to the OS. Subsequent
+ * allocations (up to "size" bytes) in this thread are then served from pages
+ * that are already mapped.
+ *
+ * The first call disables heap trimming (M_TRIM_THRESHOLD) and the use of
+ * mmap for large allocations (M_MMAP_MAX) for the whole process, the next
+ * ones leave the allocator settings untouched. Call it after
+ * mlockall(MCL_CURRENT | MCL_FUTURE) in order to have the reserve locked.
+ *
+ * @param size is the number of bytes to reserve.
+ * @return true if everything went well.
+ * @return false if the allocator could not be configured or the allocation
+ * failed.
+ */
+bool reserve_heap(std::size_t size);
+
+/**
+ * @brief Count the page faults taken by a real time loop during its first
+ * cycles. It is meant to prove that a loop runs fault-free once the memory
+ * has been pre-faulted.
+ *
+ * Usage: call start() right before the loop and tick() once per cycle, from
+ * the thread running the loop. After nb_cycles ticks the count is frozen and
+ * can be read or printed from any thread.
+ */
+class PageFaultCounter
+{
+public:
+    /**
+     * @brief Construct a new PageFaultCounter object.
+     *
+     * @param nb_cycles is the number of cycles after which the page faults
+     * are counted a second time.
+     */
+    PageFaultCounter(unsigned long nb_cycles = 1000);
+
+    /**
+     * @brief Record the page faults of the calling thread before the loop.
+     */
+    void start();
+
+    /**
+     * @brief Inform the counter that one cycle passed. After nb_cycles calls
+     * the page faults of the calling thread are recorded again. Only one
+     * system call is issued, on the last cycle.
+     */
+    void tick();
+
+    /**
+     * @brief Is the count over?
+     *
+     * @return true if nb_cycles ticks have been counted.
+     */
+    bool is_done() const;
+
+    /**
+     * @brief Page faults counted by start().
+     *
+     * @return const PageFaults&
+     */
+    const PageFaults& get_page_faults_before() const
+    {
+        return before_;
+    }
+
+    /**
+     * @brief Page faults counted after nb_cycles ticks.
+     *
+     * @return const PageFaults&
+     */
+    const PageFaults& get_page_faults_after() const
+    {
+        return after_;
+    }
+
+    /**
+     * @brief Number of minor page faults taken during the nb_cycles first
+     * cycles.
+     *
+     * @return long
+     */
+    long get_minor_page_faults() const
+    {
+        return after_.minor_ - before_.minor_;
+    }
+
+    /**
+     * @brief Number of major page faults taken during the nb_cycles first
+     * cycles.
+     *
+     * @return long
+     */
+    long get_major_page_faults() const
+    {
+        return after_.major_ - before_.major_;
+    }
+
+    /**
+     * @brief Display the page faults counted before and after the first
+     * cycles. Not real time safe.
+     */
+    void print() const;
+
+private:
+    /**
+     * @brief Number of cycles to count.
+     */
+    unsigned long nb_cycles_;
+    /**
+     * @brief Number of cycles counted so far.
+     */
+    unsigned long cycles_;
+    /**
+     * @brief Set once after_ has been recorded.
+     */
+    std::atomic<bool> done_;
+    /**
+     * @brief Page faults before the first cycle.
+     */
+    PageFaults before_;
+    /**
+     * @brief Page faults after nb_cycles_ cycles.
+     */
+    PageFaults after_;
+};
+
+}  // namespace real_time_tools
+
+#endif  // RT_MEMORY_HPP
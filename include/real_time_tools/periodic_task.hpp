@@ -0,0 +1,229 @@
+/**
+ * @file periodic_task.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Run a function periodically in a real time thread and measure its
+ * timing.
+ */
+
+#ifndef PERIODIC_TASK_HPP
+#define PERIODIC_TASK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "real_time_tools/thread.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Timing statistics of a PeriodicTask. All durations are in seconds.
+ */
+struct PeriodicTaskStatistics
+{
+    /**
+     * @brief Number of cycles executed.
+     */
+    uint64_t nb_cycles_;
+    /**
+     * @brief Number of cycles that ended after the next deadline.
+     */
+    uint64_t nb_overruns_;
+    /**
+     * @brief Number of deadlines skipped because of overruns.
+     */
+    uint64_t nb_missed_deadlines_;
+    /**
+     * @brief Minimum duration of the user function.
+     */
+    double min_execution_time_;
+    /**
+     * @brief Maximum duration of the user function.
+     */
+    double max_execution_time_;
+    /**
+     * @brief Average duration of the user function.
+     */
+    double avg_execution_time_;
+    /**
+     * @brief Minimum delay between a deadline and the actual wake up.
+     */
+    double min_wakeup_latency_;
+    /**
+     * @brief Maximum delay between a deadline and the actual wake up.
+     */
+    double max_wakeup_latency_;
+    /**
+     * @brief Average delay between a deadline and the actual wake up.
+     */
+    double avg_wakeup_latency_;
+};
+
+/**
+ * @brief Run a function periodically in a real time thread.
+ *
+ * The deadlines are computed on an absolute CLOCK_MONOTONIC grid (deadline
+ * k = start + k * period) so the loop does not drift, unlike
+ * Spinner::spin(). When the function overruns, the missed deadlines are
+ * skipped and counted, the grid is kept.
+ *
+ * Two durations are measured for every cycle: the execution time of the
+ * function and the wakeup latency (the delay between the deadline and the
+ * moment the thread actually runs). start(), stop() and
+ * get_statistics() do not take any lock shared with the real time thread,
+ * the statistics are published through a sequence counter.
+ *
+ * Example:
+ * @snippet demo_periodic_task.cpp Usage of PeriodicTask
+ */
+class PeriodicTask
+{
+public:
+    /**
+     * @brief Construct a new PeriodicTask object. This does not start the
+     * thread.
+     *
+     * @param function is called once per period in the real time thread.
+     * @param period_sec is the period of the loop in seconds.
+     * @param priority is the priority of the thread (see
+     * RealTimeThreadParameters::priority_).
+     * @param cpu_id is the CPU the thread is pinned to, -1 for no pinning.
+     */
+    PeriodicTask(std::function<void()> function,
+                 double period_sec,
+                 int priority = 80,
+                 int cpu_id = -1);
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    PeriodicTask(const PeriodicTask& other) = delete;
+
+    /**
+     * @brief Stop the loop and join the thread.
+     */
+    ~PeriodicTask();
+
+    /**
+     * @brief Parameters of the underlying thread, to be modified before
+     * start().
+     *
+     * @return RealTimeThreadParameters&
+     */
+    RealTimeThreadParameters& get_thread_parameters()
+    {
+        return thread_.parameters_;
+    }
+
+    /**
+     * @brief Reset the statistics and spawn the real time thread. The first
+     * cycle runs right away.
+     *
+     * @return true if the thread was spawned.
+     * @return false if the task is already running or the thread could not
+     * be spawned.
+     */
+    bool start();
+
+    /**
+     * @brief Ask the loop to stop after the current cycle and join the
+     * thread.
+     */
+    void stop();
+
+    /**
+     * @brief Is the loop running?
+     *
+     * @return true if the loop is running.
+     */
+    bool is_running() const
+    {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get a consistent copy of the statistics. Can be called from any
+     * thread while the task is running, it never blocks the task.
+     *
+     * @return PeriodicTaskStatistics
+     */
+    PeriodicTaskStatistics get_statistics() const;
+
+    /**
+     * @brief Display the statistics.
+     */
+    void print_statistics() const;
+
+private:
+    /**
+     * @brief Loop of the real time thread.
+     *
+     * @param task is the PeriodicTask.
+     */
+    static THREAD_FUNCTION_RETURN_TYPE loop(void* task);
+
+    /**
+     * @brief Publish the statistics of one cycle.
+     *
+     * @param execution_time is the duration of the function.
+     * @param wakeup_latency is the delay of the wake up.
+     * @param nb_missed_deadlines is the number of deadlines skipped after
+     * this cycle.
+     */
+    void update_statistics(double execution_time,
+                           double wakeup_latency,
+                           uint64_t nb_missed_deadlines);
+
+    /**
+     * @brief The user function.
+     */
+    std::function<void()> function_;
+
+    /**
+     * @brief Period of the loop in nano-seconds.
+     */
+    int64_t period_ns_;
+
+    /**
+     * @brief The real time thread.
+     */
+    RealTimeThread thread_;
+
+    /**
+     * @brief Is the loop running?
+     */
+    std::atomic<bool> running_;
+
+    /**
+     * @brief Set by stop().
+     */
+    std::atomic<bool> stop_requested_;
+
+    /**
+     * @brief Odd while the statistics are being written.
+     */
+    std::atomic<uint64_t> statistics_sequence_;
+
+    /**
+     * @brief Statistics, only written by the real time thread.
+     */
+    struct
+    {
+        std::atomic<uint64_t> nb_cycles_;
+        std::atomic<uint64_t> nb_overruns_;
+        std::atomic<uint64_t> nb_missed_deadlines_;
+        std::atomic<double> min_execution_time_;
+        std::atomic<double> max_execution_time_;
+        std::atomic<double> sum_execution_time_;
+        std::atomic<double> min_wakeup_latency_;
+        std::atomic<double> max_wakeup_latency_;
+        std::atomic<double> sum_wakeup_latency_;
+    } statistics_;
+};
+
+}  // namespace real_time_tools
+
+#endif  // PERIODIC_TASK_HPP
@@ -16,6 +16,7 @@
 #include <sched.h>
 #endif
 
+#include <string>
 #include <vector>
 
 namespace real_time_tools
@@ -36,12 +37,471 @@ bool fix_current_process_to_cpu(std::vector<int>& cpu_affinities, int pid);
  * @brief Set the _cpu_dma_latency objectWe can set the maximum CPU latency
  * for processes in micro seconds.
  *
+ * The request is held until the end of the process, a new call replaces the
+ * previous request once the new one is in place: if the new request fails,
+ * the previous one is kept. Use a DmaLatencyGuard to control its lifetime.
+ * Calls from different threads are serialized.
+ *
  * @param max_latency_us is the maximum latency in micro-seconds.
  * @return true if everything went well.
  * @return false if something went wrong.
  */
 bool set_cpu_dma_latency(int max_latency_us);
 
+/**
+ * @brief Parse a list of CPUs in the kernel format (e.g. "0-3,5,7-8").
+ * Ranges can select the first CPUs of each group, as accepted by isolcpus
+ * and nohz_full: "0-7:2/4" is 0,1,4,5. Tokens that are not CPU numbers nor
+ * ranges (e.g. the "nohz" and "domain" flags of isolcpus) are ignored, as
+ * well as malformed group suffixes.
+ *
+ * @param cpu_list is the list to parse.
+ * @return std::vector<int> the sorted CPU indexes.
+ */
+std::vector<int> parse_cpu_list(const std::string& cpu_list);
+
+/**
+ * @brief Format a list of CPUs in the kernel format (e.g. "0-3,5").
+ *
+ * @param cpu_ids are the CPU indexes.
+ * @return std::string the formatted list.
+ */
+std::string format_cpu_list(const std::vector<int>& cpu_ids);
+
+/**
+ * @brief Description of one idle state (C-state) of a CPU, read from
+ * <sys_root>/devices/system/cpu/cpu<N>/cpuidle/state<K>/.
+ */
+struct CpuIdleState
+{
+    /**
+     * @brief Name of the state (e.g. "POLL", "C1", "C6").
+     */
+    std::string name_;
+    /**
+     * @brief Exit latency of the state in micro-seconds.
+     */
+    int latency_us_;
+    /**
+     * @brief Has the state been disabled through sysfs?
+     */
+    bool disabled_;
+    /**
+     * @brief Number of times the CPU entered the state since boot.
+     */
+    unsigned long long usage_;
+};
+
+/**
+ * @brief Read the idle states (C-states) of a CPU from sysfs.
+ *
+ * @param cpu_id is the index of the CPU.
+ * @param[out] states are the idle states, from the shallowest to the deepest.
+ * @param sys_root is the mount point of sysfs, can be changed for tests.
+ * @return true if everything went well.
+ * @return false if cpuidle is not available for this CPU.
+ */
+bool get_cpu_idle_states(int cpu_id,
+                         std::vector<CpuIdleState>& states,
+                         const std::string& sys_root = "/sys");
+
+/**
+ * @brief Get the idle states that a CPU entered between two readings of
+ * get_cpu_idle_states(), and that are not disabled.
+ *
+ * @param before are the idle states at the beginning of the interval.
+ * @param after are the idle states at the end of the interval.
+ * @return std::vector<CpuIdleState> the states entered, empty if the two
+ * readings do not describe the same states.
+ */
+std::vector<CpuIdleState> get_entered_idle_states(
+    const std::vector<CpuIdleState>& before,
+    const std::vector<CpuIdleState>& after);
+
+/**
+ * @brief Hold a CPU wake up latency constraint for the lifetime of the
+ * object.
+ *
+ * Either for all CPUs, through /dev/cpu_dma_latency (the constraint lasts as
+ * long as the file stays open), or for some CPUs only, through
+ * <sys_root>/devices/system/cpu/cpu<N>/power/pm_qos_resume_latency_us (the
+ * previous values are restored upon destruction). Whether the kernel
+ * applied the constraint, and the idle states that the CPUs still enter
+ * under it, can be read back.
+ */
+class DmaLatencyGuard
+{
+public:
+    /**
+     * @brief Request a maximum wake up latency for all CPUs through
+     * /dev/cpu_dma_latency.
+     *
+     * @param max_latency_us is the maximum latency in micro-seconds, 0 to
+     * disable all deep idle states.
+     */
+    DmaLatencyGuard(int max_latency_us);
+
+    /**
+     * @brief Request a maximum wake up latency for some CPUs only through
+     * their pm_qos_resume_latency_us attribute.
+     *
+     * @param max_latency_us is the maximum latency in micro-seconds, 0 to
+     * disable all deep idle states.
+     * @param cpu_ids are the CPUs to constrain.
+     * @param sys_root is the mount point of sysfs, can be changed for tests.
+     */
+    DmaLatencyGuard(int max_latency_us,
+                    const std::vector<int>& cpu_ids,
+                    const std::string& sys_root = "/sys");
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    DmaLatencyGuard(const DmaLatencyGuard& other) = delete;
+
+    /**
+     * @brief Release the constraint.
+     */
+    ~DmaLatencyGuard();
+
+    /**
+     * @brief Is the constraint in place? For the per CPU variant, true if it
+     * could be applied to all requested CPUs.
+     *
+     * @return true if the constraint is held.
+     */
+    bool is_active() const
+    {
+        return active_;
+    }
+
+    /**
+     * @brief Get the requested maximum latency.
+     *
+     * @return int the maximum latency in micro-seconds.
+     */
+    int get_max_latency_us() const
+    {
+        return max_latency_us_;
+    }
+
+    /**
+     * @brief Read back the constraint applied by the kernel: the current
+     * value of /dev/cpu_dma_latency must not exceed the requested latency,
+     * or the pm_qos_resume_latency_us of the CPU must hold the requested
+     * value.
+     *
+     * @param cpu_id is the index of the CPU, ignored for the constraint on
+     * all CPUs.
+     * @return true if the constraint is applied to the CPU.
+     * @return false if it is not, or if the CPU is not constrained by this
+     * guard.
+     */
+    bool is_applied(int cpu_id) const;
+
+    /**
+     * @brief Read back the idle states that a CPU still enters under the
+     * constraint: the ones that are not disabled and whose usage counter
+     * increases during an idle interval. A CPU kept busy during the
+     * interval enters no state.
+     *
+     * @param cpu_id is the index of the CPU, one of the constrained CPUs for
+     * the per CPU variant.
+     * @param[out] states are the idle states the CPU entered.
+     * @param idle_interval_sec is the duration of the interval in seconds.
+     * @return true if the idle states could be read.
+     * @return false otherwise.
+     */
+    bool get_enabled_idle_states(int cpu_id,
+                                 std::vector<CpuIdleState>& states,
+                                 double idle_interval_sec = 0.1) const;
+
+    /**
+     * @brief Display, for each given CPU, whether the constraint is applied
+     * and the idle states entered during one common idle interval.
+     *
+     * @param cpu_ids are the CPUs to check.
+     * @param idle_interval_sec is the duration of the interval in seconds.
+     */
+    void print_enabled_idle_states(const std::vector<int>& cpu_ids,
+                                   double idle_interval_sec = 0.1) const;
+
+private:
+    /**
+     * @brief Requested maximum latency.
+     */
+    int max_latency_us_;
+    /**
+     * @brief Mount point of sysfs.
+     */
+    std::string sys_root_;
+    /**
+     * @brief Is the constraint in place?
+     */
+    bool active_;
+    /**
+     * @brief Is the constraint set per CPU, through
+     * pm_qos_resume_latency_us?
+     */
+    bool per_cpu_;
+    /**
+     * @brief Value written to pm_qos_resume_latency_us.
+     */
+    std::string requested_resume_latency_;
+    /**
+     * @brief File descriptor of /dev/cpu_dma_latency, -1 if not used.
+     */
+    int dma_latency_fd_;
+    /**
+     * @brief CPUs constrained through pm_qos_resume_latency_us.
+     */
+    std::vector<int> cpu_ids_;
+    /**
+     * @brief Values of pm_qos_resume_latency_us before the constraint.
+     */
+    std::vector<std::string> previous_resume_latencies_;
+};
+
+/**
+ * @brief Pin the frequency of some CPUs and disable some of their idle states
+ * (C-states) through sysfs, and restore the previous settings upon
+ * destruction.
+ *
+ * Frequency changes and deep idle state exits cause both wake up latency and
+ * varying computation times. The files written are
+ * <sys_root>/devices/system/cpu/cpu<N>/cpufreq/scaling_governor,
+ * .../cpufreq/scaling_min_freq and .../cpuidle/state<K>/disable.
+ *
+ * Example:
+ * @snippet demo_cpu_performance_guard.cpp Usage of CpuPerformanceGuard
+ */
+class CpuPerformanceGuard
+{
+public:
+    /**
+     * @brief Construct a new CpuPerformanceGuard object. Nothing is changed
+     * yet.
+     *
+     * @param cpu_ids are the CPUs to pin.
+     * @param sys_root is the mount point of sysfs, can be changed for tests.
+     */
+    CpuPerformanceGuard(const std::vector<int>& cpu_ids,
+                        const std::string& sys_root = "/sys");
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    CpuPerformanceGuard(const CpuPerformanceGuard& other) = delete;
+
+    /**
+     * @brief Restore the settings, see restore().
+     */
+    ~CpuPerformanceGuard();
+
+    /**
+     * @brief Set the frequency governor of the CPUs.
+     *
+     * @param governor is the governor, e.g. "performance".
+     * @return true if it was set on all the CPUs.
+     */
+    bool set_governor(const std::string& governor = "performance");
+
+    /**
+     * @brief Set the minimum frequency of the CPUs.
+     *
+     * @param frequency_khz is the minimum frequency in kHz, -1 for the
+     * maximum frequency of each CPU (cpuinfo_max_freq), which pins it.
+     * @return true if it was set on all the CPUs.
+     */
+    bool set_min_frequency(int frequency_khz = -1);
+
+    /**
+     * @brief Disable the idle states with an exit latency larger than
+     * max_latency_us.
+     *
+     * @param max_latency_us is the largest exit latency allowed, 0 keeps only
+     * polling.
+     * @return true if the idle states of all the CPUs could be read and
+     * written.
+     */
+    bool disable_idle_states(int max_latency_us);
+
+    /**
+     * @brief Disable one idle state by name.
+     *
+     * @param name is the name of the state, e.g. "C6".
+     * @return true if the state was found and disabled on all the CPUs.
+     */
+    bool disable_idle_state(const std::string& name);
+
+    /**
+     * @brief Restore all the settings changed so far.
+     */
+    void restore();
+
+private:
+    /**
+     * @brief Write a sysfs attribute and save its previous value once.
+     *
+     * @param file_name is the attribute.
+     * @param value is the new value.
+     * @return true if the value was written.
+     */
+    bool write_attribute(const std::string& file_name,
+                         const std::string& value);
+
+    /**
+     * @brief CPUs to pin.
+     */
+    std::vector<int> cpu_ids_;
+    /**
+     * @brief Mount point of sysfs.
+     */
+    std::string sys_root_;
+    /**
+     * @brief Attributes written so far.
+     */
+    std::vector<std::string> modified_files_;
+    /**
+     * @brief Values of the attributes before they were written.
+     */
+    std::vector<std::string> previous_values_;
+};
+
+/**
+ * @brief Description of one interrupt line, read from
+ * <proc_root>/irq/<N>/.
+ */
+struct IrqInfo
+{
+    /**
+     * @brief Number of the IRQ.
+     */
+    int irq_;
+    /**
+     * @brief Names of the handlers registered on the IRQ, i.e. the devices
+     * (e.g. "xhci_hcd" for the USB host controller of a UsbStream device).
+     */
+    std::vector<std::string> devices_;
+    /**
+     * @brief CPUs the IRQ may be delivered to (smp_affinity_list).
+     */
+    std::vector<int> cpu_ids_;
+};
+
+/**
+ * @brief List the interrupt lines of the machine.
+ *
+ * @param[out] irqs are the IRQs, sorted by number.
+ * @param proc_root is the mount point of procfs, can be changed for tests.
+ * @return true if <proc_root>/irq could be read.
+ */
+bool get_irqs(std::vector<IrqInfo>& irqs,
+              const std::string& proc_root = "/proc");
+
+/**
+ * @brief List the interrupt lines of a device.
+ *
+ * @param device_name is matched against the handler names of each IRQ, a
+ * handler matches if its name contains device_name.
+ * @param[out] irqs are the matching IRQs, sorted by number.
+ * @param proc_root is the mount point of procfs, can be changed for tests.
+ * @return true if <proc_root>/irq could be read.
+ */
+bool find_irqs(const std::string& device_name,
+               std::vector<IrqInfo>& irqs,
+               const std::string& proc_root = "/proc");
+
+/**
+ * @brief Steer interrupt lines to or away from CPUs through their
+ * smp_affinity_list, and restore the previous affinities upon destruction.
+ *
+ * Some IRQs cannot be moved (e.g. the per CPU timers), the kernel refuses
+ * the write, this is reported and the IRQ is skipped. irqbalance should be
+ * stopped, otherwise it overrides the affinities.
+ */
+class IrqAffinityGuard
+{
+public:
+    /**
+     * @brief Construct a new IrqAffinityGuard object. No IRQ is moved yet.
+     *
+     * @param proc_root is the mount point of procfs, can be changed for tests.
+     */
+    IrqAffinityGuard(const std::string& proc_root = "/proc");
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    IrqAffinityGuard(const IrqAffinityGuard& other) = delete;
+
+    /**
+     * @brief Restore the affinities, see restore().
+     */
+    ~IrqAffinityGuard();
+
+    /**
+     * @brief Set the affinity of one IRQ.
+     *
+     * @param irq is the number of the IRQ.
+     * @param cpu_ids are the CPUs the IRQ may be delivered to.
+     * @return true if the affinity was written.
+     */
+    bool set_irq_affinity(int irq, const std::vector<int>& cpu_ids);
+
+    /**
+     * @brief Deliver the IRQs of a device to some CPUs only, e.g. to the CPU
+     * of the thread reading the device.
+     *
+     * @param device_name is matched as in find_irqs().
+     * @param cpu_ids are the CPUs the IRQs may be delivered to.
+     * @return int the number of IRQs moved.
+     */
+    int move_irqs_to(const std::string& device_name,
+                     const std::vector<int>& cpu_ids);
+
+    /**
+     * @brief Remove some CPUs from the affinity of the IRQs of a device,
+     * e.g. the real time CPUs. IRQs that would be left without any CPU are
+     * not moved.
+     *
+     * @param device_name is matched as in find_irqs(), "" matches all IRQs.
+     * @param cpu_ids are the CPUs to keep free of these IRQs.
+     * @return int the number of IRQs moved.
+     */
+    int move_irqs_away_from(const std::string& device_name,
+                            const std::vector<int>& cpu_ids);
+
+    /**
+     * @brief Restore the affinities of all the IRQs moved so far.
+     */
+    void restore();
+
+    /**
+     * @brief Get the IRQs moved so far.
+     *
+     * @return const std::vector<int>&
+     */
+    const std::vector<int>& get_moved_irqs() const
+    {
+        return moved_irqs_;
+    }
+
+private:
+    /**
+     * @brief Mount point of procfs.
+     */
+    std::string proc_root_;
+    /**
+     * @brief IRQs moved so far.
+     */
+    std::vector<int> moved_irqs_;
+    /**
+     * @brief Values of smp_affinity_list before the IRQs were moved.
+     */
+    std::vector<std::string> previous_affinities_;
+};
+
 }  // namespace real_time_tools
 
 #endif  // PROCESS_MANAGER
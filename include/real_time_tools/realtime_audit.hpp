@@ -0,0 +1,209 @@
+/**
+ * @file realtime_audit.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Check that the host is configured for real time before a
+ * deployment.
+ */
+
+#ifndef REALTIME_AUDIT_HPP
+#define REALTIME_AUDIT_HPP
+
+#include <string>
+#include <vector>
+
+namespace real_time_tools
+{
+/**
+ * @brief Outcome of one check of the audit.
+ */
+enum class AuditStatus
+{
+    PASS,
+    WARN,
+    FAIL
+};
+
+/**
+ * @brief Result of one check of the audit.
+ */
+struct AuditCheck
+{
+    /**
+     * @brief Short name of the check (e.g. "isolcpus").
+     */
+    std::string name_;
+    /**
+     * @brief Outcome of the check.
+     */
+    AuditStatus status_;
+    /**
+     * @brief What was found.
+     */
+    std::string message_;
+    /**
+     * @brief How to fix the setting, empty if the check passed.
+     */
+    std::string fix_;
+};
+
+/**
+ * @brief Parameters of the real time readiness audit.
+ */
+class RealTimeAuditParameters
+{
+public:
+    /**
+     * @brief Construct a new RealTimeAuditParameters object for the live
+     * system.
+     */
+    RealTimeAuditParameters();
+
+    /**
+     * @brief CPUs that will run the real time threads.
+     */
+    std::vector<int> rt_cpu_ids_;
+    /**
+     * @brief Priority that the real time threads will request.
+     */
+    int priority_;
+    /**
+     * @brief Mount point of procfs, can be changed to audit a fixture tree.
+     */
+    std::string proc_root_;
+    /**
+     * @brief Mount point of sysfs, can be changed to audit a fixture tree.
+     */
+    std::string sys_root_;
+    /**
+     * @brief Is the deployed process privileged (root or CAP_SYS_NICE and
+     * CAP_IPC_LOCK)? Privileged processes ignore RLIMIT_RTPRIO and
+     * RLIMIT_MEMLOCK. Defaults to the current effective user being root.
+     */
+    bool privileged_;
+};
+
+/**
+ * @brief Audit the host configuration for real time: kernel command line
+ * (isolcpus, nohz_full, rcu_nocbs), PREEMPT_RT kernel, CPU frequency
+ * governor, SMT siblings of the real time CPUs, IRQs affine to the real time
+ * CPUs, transparent huge pages, RLIMIT_RTPRIO and RLIMIT_MEMLOCK, and real
+ * time throttling (sched_rt_runtime_us).
+ *
+ * Everything is read from the procfs and sysfs roots given in the
+ * parameters, so the audit can be tested against fixture trees.
+ */
+class RealTimeAudit
+{
+public:
+    /**
+     * @brief Construct a new RealTimeAudit object.
+     *
+     * @param parameters of the audit.
+     */
+    RealTimeAudit(const RealTimeAuditParameters& parameters);
+
+    /**
+     * @brief Run all the checks.
+     *
+     * @return const std::vector<AuditCheck>& the result of each check.
+     */
+    const std::vector<AuditCheck>& run();
+
+    /**
+     * @brief Get the results of the last run().
+     *
+     * @return const std::vector<AuditCheck>&
+     */
+    const std::vector<AuditCheck>& get_checks() const
+    {
+        return checks_;
+    }
+
+    /**
+     * @brief Get the worst status of the last run().
+     *
+     * @return AuditStatus
+     */
+    AuditStatus get_status() const;
+
+    /**
+     * @brief Display the report of the last run(), with the fixes.
+     */
+    void print() const;
+
+private:
+    /**
+     * @brief Add a result to the report.
+     */
+    void add(const std::string& name,
+             AuditStatus status,
+             const std::string& message,
+             const std::string& fix = "");
+
+    /**
+     * @brief Check isolcpus, nohz_full and rcu_nocbs in the kernel command
+     * line.
+     */
+    void check_kernel_command_line();
+
+    /**
+     * @brief Check that the kernel is PREEMPT_RT.
+     */
+    void check_preempt_rt();
+
+    /**
+     * @brief Check the scaling governor of the real time CPUs.
+     */
+    void check_cpu_frequency_governor();
+
+    /**
+     * @brief Check that the SMT siblings of the real time CPUs are not used
+     * by anything else.
+     */
+    void check_smt_siblings();
+
+    /**
+     * @brief Check that no IRQ is affine to the real time CPUs.
+     */
+    void check_irq_affinity();
+
+    /**
+     * @brief Check the transparent huge pages setting.
+     */
+    void check_transparent_huge_pages();
+
+    /**
+     * @brief Check RLIMIT_RTPRIO and RLIMIT_MEMLOCK.
+     */
+    void check_resource_limits();
+
+    /**
+     * @brief Check the real time throttling.
+     */
+    void check_rt_throttling();
+
+    /**
+     * @brief Parameters of the audit.
+     */
+    RealTimeAuditParameters parameters_;
+
+    /**
+     * @brief Results of the last run().
+     */
+    std::vector<AuditCheck> checks_;
+};
+
+/**
+ * @brief Convert a status to "PASS", "WARN" or "FAIL".
+ *
+ * @param status is the status to convert.
+ * @return std::string
+ */
+std::string to_string(AuditStatus status);
+
+}  // namespace real_time_tools
+
+#endif  // REALTIME_AUDIT_HPP
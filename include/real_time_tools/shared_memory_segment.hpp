@@ -0,0 +1,152 @@
+/**
+ * @file shared_memory_segment.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Map a named POSIX shared memory segment, to share the threadsafe
+ * objects between processes.
+ */
+
+#ifndef SHARED_MEMORY_SEGMENT_HPP
+#define SHARED_MEMORY_SEGMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace real_time_tools
+{
+/**
+ * @brief A named POSIX shared memory segment (shm_open) mapped in the
+ * address space of the process. The process that creates the segment
+ * removes its name upon destruction, the processes that opened it keep
+ * their mapping until they destroy their own SharedMemorySegment.
+ */
+class SharedMemorySegment
+{
+public:
+    /**
+     * @brief Construct a new SharedMemorySegment object, not mapped yet.
+     */
+    SharedMemorySegment();
+
+    /**
+     * @brief Unmap the segment, and remove its name if we created it.
+     */
+    ~SharedMemorySegment();
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    SharedMemorySegment(const SharedMemorySegment& other) = delete;
+
+    /**
+     * @brief Create a segment filled with zeros and map it.
+     *
+     * A segment with the same name may belong to a running process, so it is
+     * only replaced on request, e.g. when it was left by a process that
+     * crashed. The processes that mapped the replaced segment keep using it
+     * and no longer communicate with the new one.
+     *
+     * @param name of the segment, a '/' is prepended if missing.
+     * @param size of the segment in bytes.
+     * @param replace an existing segment with the same name instead of
+     * failing.
+     * @return true if the segment is mapped.
+     */
+    bool create(const std::string& name,
+                std::size_t size,
+                bool replace = false);
+
+    /**
+     * @brief Map a segment created by another process.
+     *
+     * @param name of the segment, a '/' is prepended if missing.
+     * @param size of the segment in bytes, the segment must be at least as
+     * large.
+     * @return true if the segment is mapped.
+     */
+    bool open(const std::string& name, std::size_t size);
+
+    /**
+     * @brief Get the address of the mapping, nullptr if not mapped.
+     *
+     * @return void*
+     */
+    void* get_address() const
+    {
+        return address_;
+    }
+
+    /**
+     * @brief Get the size of the mapping.
+     *
+     * @return std::size_t
+     */
+    std::size_t get_size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Get the name of the segment.
+     *
+     * @return const std::string&
+     */
+    const std::string& get_name() const
+    {
+        return name_;
+    }
+
+    /**
+     * @brief Did this object create the segment?
+     *
+     * @return true if the name is removed upon destruction.
+     */
+    bool is_owner() const
+    {
+        return owner_;
+    }
+
+private:
+    /**
+     * @brief Map the segment opened in file_descriptor and close it.
+     *
+     * @param file_descriptor
+     * @param size
+     * @return true if the segment is mapped.
+     */
+    bool map(int file_descriptor, std::size_t size);
+
+    /**
+     * @brief Name of the segment, starting with '/'.
+     */
+    std::string name_;
+    /**
+     * @brief Address of the mapping.
+     */
+    void* address_;
+    /**
+     * @brief Size of the mapping.
+     */
+    std::size_t size_;
+    /**
+     * @brief Did we create the segment?
+     */
+    bool owner_;
+};
+
+/**
+ * @brief Hash a type name (FNV-1a), e.g. typeid(Type).name(), so that the
+ * processes sharing a segment can check that they agree on its content. The
+ * hash is the same in all the processes built with the same compiler.
+ *
+ * @param type_name
+ * @return uint64_t
+ */
+uint64_t hash_type_name(const char* type_name);
+
+}  // namespace real_time_tools
+
+#endif  // SHARED_MEMORY_SEGMENT_HPP
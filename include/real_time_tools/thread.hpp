@@ -10,10 +10,12 @@
 #ifndef REALTIME_THREAD_CREATION_HPP
 #define REALTIME_THREAD_CREATION_HPP
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
+#include "real_time_tools/memory.hpp"
 
 #ifdef XENOMAI
 // you MAY need to happend "static" upon declaration
@@ -55,6 +57,8 @@
 
 namespace real_time_tools
 {
+struct ThreadHealth;
+
 /**
  * @brief This class is a data structure allowing the user to share
  * configurations among threads. These parameter allows you to generate
@@ -93,6 +97,8 @@ public:
         delay_ns_ = 0;
         block_memory_ = true;
         cpu_dma_latency_ = 0;
+        prefault_stack_size_ = 0;
+        heap_reserve_size_ = 0;
     }
     /**
      * @brief Destroy the RealTimeThreadParameters object
@@ -141,6 +147,67 @@ public:
      *
      */
     int cpu_dma_latency_;
+
+    /**
+     * @brief Number of bytes of the thread stack that are touched before
+     * the thread function is called, so that the first cycles do not take
+     * page faults on the stack. Must be smaller than stack_size_ (e.g. half
+     * of it). Set to 0 to disable (default). rt_preempt and non real time
+     * only.
+     */
+    int prefault_stack_size_;
+
+    /**
+     * @brief Number of bytes of heap that are allocated, touched and kept
+     * by the allocator before the thread function is called (see
+     * real_time_tools::reserve_heap()). Set to 0 to disable (default).
+     * rt_preempt and non real time only.
+     *
+     * This configures malloc for the whole process, not only for this
+     * thread: heap trimming and the use of mmap for large allocations are
+     * disabled for good, the first time a reserve is made.
+     */
+    int heap_reserve_size_;
+};
+
+/**
+ * @brief Real time settings that the OS actually granted to a thread. In
+ * rt_preempt the thread creation fails if they are not granted, while the
+ * non real time backend applies them on a best effort basis.
+ */
+struct GrantedThreadSettings
+{
+    /**
+     * @brief Construct a new GrantedThreadSettings object, nothing granted.
+     */
+    GrantedThreadSettings()
+        : cpu_affinity_(false),
+          fifo_scheduling_(false),
+          priority_(0),
+          nice_(0),
+          memory_locked_(false)
+    {
+    }
+    /**
+     * @brief Is the thread pinned to RealTimeThreadParameters::cpu_id_?
+     */
+    bool cpu_affinity_;
+    /**
+     * @brief Does the thread run with the SCHED_FIFO policy?
+     */
+    bool fifo_scheduling_;
+    /**
+     * @brief SCHED_FIFO priority of the thread, if fifo_scheduling_.
+     */
+    int priority_;
+    /**
+     * @brief Nice level of the thread, if not fifo_scheduling_ (fallback).
+     */
+    int nice_;
+    /**
+     * @brief Is the memory of the process locked (mlockall)?
+     */
+    bool memory_locked_;
 };
 
 /**
@@ -194,12 +261,141 @@ public:
      */
     void block_memory();
 
+    /**
+     * @brief Get the kernel id (gettid()) of the spawned thread.
+     *
+     * @return int the thread id, -1 if the thread is not running yet or if
+     * the OS does not provide it (xenomai).
+     */
+    int get_thread_id() const
+    {
+        return thread_id_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Sample the context switches, page faults, CPU migrations and
+     * current CPU of the spawned thread from /proc. The spawned thread is not
+     * interrupted. This is not real time safe, call it from a low priority
+     * thread (see ThreadHealthMonitor).
+     *
+     * @param[out] health is the statistics of the spawned thread.
+     * @return true if everything went well.
+     * @return false if the thread is not running or /proc is not available.
+     */
+    bool get_health(ThreadHealth& health) const;
+
+    /**
+     * @brief Get the page faults the spawned thread took while pre-faulting
+     * its stack and its heap reserve (see
+     * RealTimeThreadParameters::prefault_stack_size_ and
+     * RealTimeThreadParameters::heap_reserve_size_).
+     *
+     * @param[out] page_faults is the page faults taken by the pre-faulting.
+     * @return true if everything went well.
+     * @return false if the thread function has not been called yet or if
+     * the OS does not provide per thread statistics.
+     */
+    bool get_prefault_page_faults(PageFaults& page_faults) const;
+
+    /**
+     * @brief Get the page faults the spawned thread took since its memory
+     * was pre-faulted, i.e. in the thread function. A loop that runs
+     * fault-free keeps them at 0. Like get_health(), this reads /proc and is
+     * not real time safe.
+     *
+     * @param[out] page_faults is the page faults taken by the thread
+     * function so far.
+     * @return true if everything went well.
+     * @return false if the thread function has not been called yet or if
+     * /proc is not available.
+     */
+    bool get_page_faults_since_prefault(PageFaults& page_faults) const;
+
+    /**
+     * @brief Get the real time settings that were actually granted to the
+     * spawned thread. Valid once create_realtime_thread() returned.
+     *
+     * @return const GrantedThreadSettings&
+     */
+    const GrantedThreadSettings& get_granted_settings() const
+    {
+        return granted_settings_;
+    }
+
+    /**
+     * @brief Display the real time settings granted to the spawned thread.
+     */
+    void print_granted_settings() const;
+
     /**
      * @brief Paramter of the real time thread
      */
     RealTimeThreadParameters parameters_;
 
 private:
+    /**
+     * @brief Kernel id of the spawned thread, set by the thread itself.
+     */
+    std::atomic<int> thread_id_;
+
+    /**
+     * @brief Page faults taken by the pre-faulting, set by the spawned
+     * thread.
+     */
+    PageFaults prefault_page_faults_;
+
+    /**
+     * @brief Page faults of the spawned thread once its memory was
+     * pre-faulted, set by the spawned thread.
+     */
+    PageFaults page_faults_after_prefault_;
+
+    /**
+     * @brief Set by the spawned thread once the page faults above are
+     * recorded.
+     */
+    std::atomic<bool> page_faults_recorded_;
+
+    /**
+     * @brief Real time settings actually granted to the spawned thread.
+     */
+    GrantedThreadSettings granted_settings_;
+
+#if defined(NON_REAL_TIME)
+    /**
+     * @brief Apply the parameters to the calling thread whenever the
+     * permissions allow it: cpu affinity, SCHED_FIFO or else the lowest
+     * allowed nice level. Fills granted_settings_.
+     */
+    void apply_best_effort_settings();
+
+    /**
+     * @brief Set by the spawned thread once apply_best_effort_settings()
+     * returned.
+     */
+    std::atomic<bool> settings_applied_;
+#endif
+
+#if !defined(XENOMAI)
+    /**
+     * @brief Entry point of the spawned thread. It prepares the memory
+     * according to the parameters and then calls the user thread function.
+     *
+     * @param self is the RealTimeThread that spawned the thread.
+     */
+    static THREAD_FUNCTION_RETURN_TYPE thread_entry(void* self);
+
+    /**
+     * @brief The user thread function.
+     */
+    void* (*thread_function_)(void*);
+
+    /**
+     * @brief The arguments of the user thread function.
+     */
+    void* thread_args_;
+#endif
+
 #if defined(XENOMAI)
     RT_TASK thread_;
 #elif defined(NON_REAL_TIME)
@@ -0,0 +1,227 @@
+/**
+ * @file thread_health.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Tools to sample the scheduling and memory statistics of a thread
+ * (context switches, page faults, CPU migrations) without perf.
+ */
+
+#ifndef THREAD_HEALTH_HPP
+#define THREAD_HEALTH_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace real_time_tools
+{
+class RealTimeThread;
+
+/**
+ * @brief Runtime statistics of one thread. All counters are cumulated since
+ * the creation of the thread. A field is set to -1 when the OS does not
+ * provide it.
+ */
+struct ThreadHealth
+{
+    /**
+     * @brief Construct a new ThreadHealth object with all fields set to -1.
+     */
+    ThreadHealth();
+
+    /**
+     * @brief Number of times the thread gave up the CPU (sleep, blocking
+     * call, page fault I/O...).
+     */
+    long voluntary_context_switches_;
+    /**
+     * @brief Number of times the thread was preempted.
+     */
+    long involuntary_context_switches_;
+    /**
+     * @brief Page faults serviced without any I/O.
+     */
+    long minor_page_faults_;
+    /**
+     * @brief Page faults that required I/O.
+     */
+    long major_page_faults_;
+    /**
+     * @brief Number of times the thread migrated from one CPU to another.
+     */
+    long cpu_migrations_;
+    /**
+     * @brief CPU the thread is running on (or last ran on).
+     */
+    int current_cpu_;
+};
+
+/**
+ * @brief Sample the statistics of the calling thread using
+ * getrusage(RUSAGE_THREAD) and sched_getcpu(). These are system calls without
+ * file access, but it is still better not to call this in every cycle of a
+ * real time loop. The CPU migrations are not available this way.
+ *
+ * @param[out] health is the statistics of the calling thread.
+ * @return true if everything went well.
+ * @return false otherwise.
+ */
+bool get_current_thread_health(ThreadHealth& health);
+
+/**
+ * @brief Sample the statistics of a thread of the current process from
+ * /proc/self/task/<tid>/{stat,status,sched}. This does not interfere with
+ * the sampled thread. It reads files so it is not real time safe.
+ *
+ * @param thread_id is the kernel thread id (gettid()) of the thread.
+ * @param[out] health is the statistics of the thread.
+ * @return true if everything went well.
+ * @return false if the thread does not exist or /proc could not be read.
+ */
+bool get_thread_health(int thread_id, ThreadHealth& health);
+
+/**
+ * @brief Display the statistics of a thread.
+ *
+ * @param name is displayed as header.
+ * @param health is the statistics to display.
+ */
+void print_thread_health(const std::string& name, const ThreadHealth& health);
+
+/**
+ * @brief Low priority thread that periodically samples the statistics of a
+ * set of threads from /proc. The monitored threads are never touched, they
+ * can be real time threads.
+ */
+class ThreadHealthMonitor
+{
+public:
+    /**
+     * @brief Construct a new ThreadHealthMonitor object.
+     *
+     * @param period_sec is the sampling period in seconds.
+     */
+    ThreadHealthMonitor(double period_sec = 1.0);
+
+    /**
+     * @brief Stop the monitoring thread.
+     */
+    ~ThreadHealthMonitor();
+
+    /**
+     * @brief Monitor a RealTimeThread. The RealTimeThread must outlive this
+     * object. The thread is sampled as soon as it is running.
+     *
+     * @param name is used to query and display the statistics.
+     * @param thread is the thread to monitor.
+     */
+    void add_thread(const std::string& name, const RealTimeThread& thread);
+
+    /**
+     * @brief Monitor any thread of the current process.
+     *
+     * @param name is used to query and display the statistics.
+     * @param thread_id is the kernel thread id (gettid()) of the thread.
+     */
+    void add_thread(const std::string& name, int thread_id);
+
+    /**
+     * @brief Spawn the monitoring thread with the lowest nice level.
+     */
+    void start();
+
+    /**
+     * @brief Stop and join the monitoring thread.
+     */
+    void stop();
+
+    /**
+     * @brief Get the latest statistics of a monitored thread.
+     *
+     * If /proc does not provide the CPU migrations (no CONFIG_SCHED_DEBUG),
+     * cpu_migrations_ counts the CPU changes observed between two samples,
+     * which is a lower bound.
+     *
+     * @param name is the name given in add_thread().
+     * @param[out] health is the latest sample.
+     * @return true if the thread has been sampled at least once.
+     * @return false otherwise.
+     */
+    bool get(const std::string& name, ThreadHealth& health) const;
+
+    /**
+     * @brief Display the latest statistics of all monitored threads.
+     */
+    void print() const;
+
+private:
+    /**
+     * @brief One monitored thread.
+     */
+    struct Entry
+    {
+        /** @brief Name of the thread. */
+        std::string name_;
+        /** @brief Thread to sample, nullptr if thread_id_ is used. */
+        const RealTimeThread* thread_;
+        /** @brief Kernel thread id if thread_ is nullptr. */
+        int thread_id_;
+        /** @brief Has the thread been sampled? */
+        bool sampled_;
+        /** @brief CPU changes observed between two samples. */
+        long observed_migrations_;
+        /** @brief Latest sample. */
+        ThreadHealth health_;
+    };
+
+    /**
+     * @brief Sample all the monitored threads.
+     */
+    void sample();
+
+    /**
+     * @brief Loop of the monitoring thread.
+     */
+    void loop();
+
+    /**
+     * @brief Sampling period in seconds.
+     */
+    double period_sec_;
+
+    /**
+     * @brief Monitored threads and their latest samples.
+     */
+    std::vector<Entry> entries_;
+
+    /**
+     * @brief Protects entries_ between the monitor and the user (non real
+     * time threads only).
+     */
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Used to wake the monitoring thread up upon stop().
+     */
+    std::condition_variable condition_;
+
+    /**
+     * @brief Is the monitoring thread running?
+     */
+    std::atomic<bool> running_;
+
+    /**
+     * @brief The monitoring thread.
+     */
+    std::unique_ptr<std::thread> thread_;
+};
+
+}  // namespace real_time_tools
+
+#endif  // THREAD_HEALTH_HPP
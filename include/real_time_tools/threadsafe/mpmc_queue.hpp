@@ -0,0 +1,200 @@
+/**
+ * @file mpmc_queue.hpp
+ * @brief This file declares a bounded lock-free queue with any number of
+ * producers and consumers.
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "real_time_tools/futex.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Fixed capacity FIFO queue for any number of producer and consumer
+ * threads, e.g. to send commands from non real time threads to a real time
+ * loop. It never allocates memory and never takes a lock (Dmitry Vyukov's
+ * bounded MPMC queue).
+ *
+ * Each cell holds a sequence number that tells whether it is ready to be
+ * written for a given push position or read for a given pop position. A
+ * producer claims a position with a compare and swap on the push position,
+ * writes the cell and publishes it through its sequence number, and
+ * symmetrically for the consumers. Producers and consumers only share the
+ * cells they hand over: the push and pop positions are on their own cache
+ * lines.
+ *
+ * try_push() and try_pop() never wait and are meant for the real time
+ * threads. push() and pop() sleep while the queue is full or empty, for the
+ * non real time threads.
+ *
+ * Example:
+ * @snippet demo_mpmc_queue.cpp Usage of MpmcQueue
+ *
+ * @tparam Type is the type of the elements, default constructible and
+ * movable. The cells keep their last element until it is overwritten.
+ * @tparam CAPACITY is the maximum number of elements, a power of 2.
+ */
+template <typename Type, size_t CAPACITY>
+class MpmcQueue
+{
+public:
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "the capacity of the queue must be a power of 2");
+
+    /**
+     * @brief Construct a new empty MpmcQueue object.
+     */
+    MpmcQueue();
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    MpmcQueue(const MpmcQueue& other) = delete;
+
+    /**
+     * @brief Copy an element at the end of the queue, never waits.
+     *
+     * @param datum
+     * @return false if the queue is full.
+     */
+    bool try_push(const Type& datum)
+    {
+        return try_push_datum(datum);
+    }
+
+    /**
+     * @brief Move an element at the end of the queue, never waits. datum is
+     * left untouched if the queue is full.
+     *
+     * @param datum
+     * @return false if the queue is full.
+     */
+    bool try_push(Type&& datum)
+    {
+        return try_push_datum(std::move(datum));
+    }
+
+    /**
+     * @brief Take the element at the front of the queue, never waits.
+     *
+     * @param datum is set if the queue is not empty.
+     * @return false if the queue is empty.
+     */
+    bool try_pop(Type& datum);
+
+    /**
+     * @brief Copy an element at the end of the queue, sleeps while the queue
+     * is full.
+     *
+     * @param datum
+     */
+    void push(const Type& datum)
+    {
+        not_full_.wait([this, &datum]() { return try_push(datum); });
+    }
+
+    /**
+     * @brief Move an element at the end of the queue, sleeps while the queue
+     * is full.
+     *
+     * @param datum
+     */
+    void push(Type&& datum)
+    {
+        not_full_.wait(
+            [this, &datum]() { return try_push(std::move(datum)); });
+    }
+
+    /**
+     * @brief Take the element at the front of the queue, sleeps while the
+     * queue is empty.
+     *
+     * @param datum
+     */
+    void pop(Type& datum)
+    {
+        not_empty_.wait([this, &datum]() { return try_pop(datum); });
+    }
+
+    /**
+     * @brief Get the number of elements in the queue. Only an estimate while
+     * other threads push or pop.
+     *
+     * @return size_t
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the maximum number of elements.
+     *
+     * @return size_t
+     */
+    size_t get_capacity() const
+    {
+        return CAPACITY;
+    }
+
+private:
+    /**
+     * @brief Implementation of try_push().
+     *
+     * @tparam Datum is a reference to a Type.
+     * @param datum is only moved from if the push succeeds.
+     * @return false if the queue is full.
+     */
+    template <typename Datum>
+    bool try_push_datum(Datum&& datum);
+
+    /**
+     * @brief One element of the queue.
+     */
+    struct Cell
+    {
+        /**
+         * @brief Equal to the push position when the cell can be written,
+         * to the pop position + 1 when it can be read.
+         */
+        std::atomic<size_t> sequence_;
+        /**
+         * @brief The element.
+         */
+        Type datum_;
+    };
+
+    /**
+     * @brief The ring of cells, the position p is in the cell
+     * p % CAPACITY.
+     */
+    std::array<Cell, CAPACITY> cells_;
+    /**
+     * @brief Position of the next push, shared by the producers.
+     */
+    alignas(64) std::atomic<size_t> push_position_;
+    /**
+     * @brief Position of the next pop, shared by the consumers.
+     */
+    alignas(64) std::atomic<size_t> pop_position_;
+    /**
+     * @brief The consumers in pop() sleep on it.
+     */
+    alignas(64) FutexCondition not_empty_;
+    /**
+     * @brief The producers in push() sleep on it.
+     */
+    alignas(64) FutexCondition not_full_;
+};
+
+}  // namespace real_time_tools
+
+#include "real_time_tools/threadsafe/mpmc_queue.hxx"
@@ -0,0 +1,113 @@
+/**
+ * @file mpmc_queue.hxx
+ * @brief This file defines the functions from mpmc_queue.hpp
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <utility>
+
+namespace real_time_tools
+{
+template <typename Type, size_t CAPACITY>
+MpmcQueue<Type, CAPACITY>::MpmcQueue()
+    : cells_(), push_position_(0), pop_position_(0)
+{
+    for (size_t i = 0; i < CAPACITY; ++i)
+    {
+        cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename Type, size_t CAPACITY>
+template <typename Datum>
+bool MpmcQueue<Type, CAPACITY>::try_push_datum(Datum&& datum)
+{
+    // claim a cell that the consumers have released -----------------------
+    Cell* cell;
+    size_t position = push_position_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &cells_[position & (CAPACITY - 1)];
+        size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+        intptr_t difference =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0)
+        {
+            if (push_position_.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // the cell still holds the element of the previous lap.
+            return false;
+        }
+        else
+        {
+            // another producer claimed the position.
+            position = push_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // write the element and hand it to the consumers ----------------------
+    cell->datum_ = std::forward<Datum>(datum);
+    cell->sequence_.store(position + 1, std::memory_order_release);
+    not_empty_.notify_one();
+    return true;
+}
+
+template <typename Type, size_t CAPACITY>
+bool MpmcQueue<Type, CAPACITY>::try_pop(Type& datum)
+{
+    // claim a cell that a producer has published --------------------------
+    Cell* cell;
+    size_t position = pop_position_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &cells_[position & (CAPACITY - 1)];
+        size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) -
+                              static_cast<intptr_t>(position + 1);
+        if (difference == 0)
+        {
+            if (pop_position_.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // the cell is not published yet.
+            return false;
+        }
+        else
+        {
+            // another consumer claimed the position.
+            position = pop_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // read the element and release the cell for the next lap --------------
+    datum = std::move(cell->datum_);
+    cell->sequence_.store(position + CAPACITY, std::memory_order_release);
+    not_full_.notify_one();
+    return true;
+}
+
+template <typename Type, size_t CAPACITY>
+size_t MpmcQueue<Type, CAPACITY>::size() const
+{
+    size_t pop_position = pop_position_.load(std::memory_order_relaxed);
+    size_t push_position = push_position_.load(std::memory_order_relaxed);
+    return push_position > pop_position ? push_position - pop_position : 0;
+}
+
+}  // namespace real_time_tools
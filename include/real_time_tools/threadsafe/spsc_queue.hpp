@@ -0,0 +1,292 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief This file declares a wait-free queue between one producer and one
+ * consumer, with batched pushes and pops.
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "real_time_tools/futex.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Contiguous elements of a SpscQueue, see SpscQueue::peek().
+ *
+ * @tparam Type is the type of the elements, const for read only spans.
+ */
+template <typename Type>
+struct SpscSpan
+{
+    /**
+     * @brief First element.
+     */
+    Type* data_;
+    /**
+     * @brief Number of elements.
+     */
+    size_t size_;
+
+    /**
+     * @brief Get the number of elements.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Get an element.
+     *
+     * @param index
+     * @return Type&
+     */
+    Type& operator[](size_t index) const
+    {
+        return data_[index];
+    }
+
+    /**
+     * @brief For range-based for loops.
+     *
+     * @return Type*
+     */
+    Type* begin() const
+    {
+        return data_;
+    }
+
+    /**
+     * @brief For range-based for loops.
+     *
+     * @return Type*
+     */
+    Type* end() const
+    {
+        return data_ + size_;
+    }
+};
+
+/**
+ * @brief Fixed capacity FIFO queue between one producer thread and one
+ * consumer thread, e.g. a high rate sensor thread and a logger. Pushes and
+ * pops never wait, never allocate and move batches of elements at once.
+ *
+ * The push position is written by the producer only and the pop position by
+ * the consumer only, each on its own cache line. Each side also keeps a
+ * cached copy of the position of the other side, on a cache line of its
+ * own, and only reads the shared position when the cached one says that
+ * the queue is full (producer) or empty (consumer). Both sides then rarely
+ * touch the cache lines written by the other core.
+ *
+ * The consumer can sleep until the queue holds a number of elements, the
+ * watermark: the producer only enters the kernel when its push makes the
+ * queue reach the watermark while the consumer sleeps.
+ *
+ * Example:
+ * @snippet demo_spsc_queue.cpp Usage of SpscQueue
+ *
+ * @tparam Type is the type of the elements, default constructible and
+ * copyable.
+ * @tparam CAPACITY is the maximum number of elements, a power of 2.
+ */
+template <typename Type, size_t CAPACITY>
+class SpscQueue
+{
+public:
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "the capacity of the queue must be a power of 2");
+
+    /**
+     * @brief Construct a new empty SpscQueue object.
+     *
+     * @param watermark is the number of elements the consumer waits for in
+     * wait_for_elements(), in [1, CAPACITY].
+     */
+    explicit SpscQueue(size_t watermark = 1);
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    SpscQueue(const SpscQueue& other) = delete;
+
+    /**
+     * Producer side.
+     */
+
+    /**
+     * @brief Copy elements at the end of the queue, as many as there is room
+     * for.
+     *
+     * @param data are the elements to push.
+     * @param nb_elements is the number of elements of data.
+     * @return size_t the number of elements pushed, the first ones of data.
+     */
+    size_t push_n(const Type* data, size_t nb_elements);
+
+    /**
+     * @brief Copy an element at the end of the queue.
+     *
+     * @param datum
+     * @return false if the queue is full.
+     */
+    bool try_push(const Type& datum)
+    {
+        return push_n(&datum, 1) == 1;
+    }
+
+    /**
+     * Consumer side.
+     */
+
+    /**
+     * @brief Copy elements from the front of the queue and remove them.
+     *
+     * @param data receives the elements.
+     * @param max_nb_elements is the size of data.
+     * @return size_t the number of elements popped.
+     */
+    size_t pop_n(Type* data, size_t max_nb_elements);
+
+    /**
+     * @brief Copy the element at the front of the queue and remove it.
+     *
+     * @param datum
+     * @return false if the queue is empty.
+     */
+    bool try_pop(Type& datum)
+    {
+        return pop_n(&datum, 1) == 1;
+    }
+
+    /**
+     * @brief Get the elements at the front of the queue without copying
+     * them. The span stops at the end of the ring: if the queue wraps
+     * around, the next peek() after consume() returns the rest.
+     *
+     * @return SpscSpan<const Type> valid until consume().
+     */
+    SpscSpan<const Type> peek();
+
+    /**
+     * @brief Remove elements from the front of the queue, after peek().
+     *
+     * @param nb_elements is at most the size of the span peeked, larger
+     * values are clamped to the number of elements in the queue.
+     * @return size_t the number of elements removed.
+     */
+    size_t consume(size_t nb_elements);
+
+    /**
+     * @brief Sleep until the queue holds at least watermark elements.
+     */
+    void wait_for_elements()
+    {
+        not_empty_.wait([this]() { return size() >= watermark_; });
+    }
+
+    /**
+     * @brief Sleep until the queue holds at least watermark elements or
+     * until a deadline.
+     *
+     * @param deadline is a date of std::chrono::steady_clock.
+     * @return true if the watermark was reached.
+     */
+    bool wait_for_elements_until(
+        const std::chrono::steady_clock::time_point& deadline)
+    {
+        return not_empty_.wait_until(
+            [this]() { return size() >= watermark_; }, deadline);
+    }
+
+    /**
+     * @brief Sleep until the queue holds at least watermark elements, at
+     * most for a timeout.
+     *
+     * @tparam Rep
+     * @tparam Period
+     * @param timeout
+     * @return true if the watermark was reached.
+     */
+    template <typename Rep, typename Period>
+    bool wait_for_elements_for(
+        const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return wait_for_elements_until(
+            std::chrono::steady_clock::now() +
+            std::chrono::ceil<std::chrono::steady_clock::duration>(timeout));
+    }
+
+    /**
+     * Both sides.
+     */
+
+    /**
+     * @brief Get the number of elements in the queue, a lower bound for the
+     * consumer and an upper bound for the producer.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        size_t pop_position = pop_position_.load(std::memory_order_relaxed);
+        return push_position_.load(std::memory_order_acquire) - pop_position;
+    }
+
+    /**
+     * @brief Get the maximum number of elements.
+     *
+     * @return size_t
+     */
+    size_t get_capacity() const
+    {
+        return CAPACITY;
+    }
+
+private:
+    /**
+     * @brief The ring of elements, the position p is in the element
+     * p % CAPACITY.
+     */
+    std::array<Type, CAPACITY> elements_;
+    /**
+     * @brief Number of elements pushed, written by the producer.
+     */
+    alignas(64) std::atomic<size_t> push_position_;
+    /**
+     * @brief Last pop position read by the producer.
+     */
+    alignas(64) size_t cached_pop_position_;
+    /**
+     * @brief The number of elements wait_for_elements() waits for, read by
+     * the producer after every push.
+     */
+    const size_t watermark_;
+    /**
+     * @brief Number of elements popped, written by the consumer.
+     */
+    alignas(64) std::atomic<size_t> pop_position_;
+    /**
+     * @brief Last push position read by the consumer.
+     */
+    alignas(64) size_t cached_push_position_;
+    /**
+     * @brief The consumer sleeps on it.
+     */
+    alignas(64) FutexCondition not_empty_;
+};
+
+}  // namespace real_time_tools
+
+#include "real_time_tools/threadsafe/spsc_queue.hxx"
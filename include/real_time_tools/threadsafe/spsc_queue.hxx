@@ -0,0 +1,124 @@
+/**
+ * @file spsc_queue.hxx
+ * @brief This file defines the functions from spsc_queue.hpp
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+
+namespace real_time_tools
+{
+template <typename Type, size_t CAPACITY>
+SpscQueue<Type, CAPACITY>::SpscQueue(size_t watermark)
+    : elements_(),
+      push_position_(0),
+      cached_pop_position_(0),
+      watermark_(std::min(std::max(watermark, size_t(1)), CAPACITY)),
+      pop_position_(0),
+      cached_push_position_(0)
+{
+}
+
+template <typename Type, size_t CAPACITY>
+size_t SpscQueue<Type, CAPACITY>::push_n(const Type* data,
+                                         size_t nb_elements)
+{
+    // look at the pop position only if the cached one says it is full ---
+    size_t push_position = push_position_.load(std::memory_order_relaxed);
+    if (CAPACITY - (push_position - cached_pop_position_) < nb_elements)
+    {
+        // acquire: the consumer is done with the elements it popped.
+        cached_pop_position_ = pop_position_.load(std::memory_order_acquire);
+    }
+    size_t nb_pushed = std::min(
+        nb_elements, CAPACITY - (push_position - cached_pop_position_));
+    if (nb_pushed == 0)
+    {
+        return 0;
+    }
+
+    // copy the elements and publish them ---------------------------------
+    for (size_t i = 0; i < nb_pushed; ++i)
+    {
+        elements_[(push_position + i) & (CAPACITY - 1)] = data[i];
+    }
+    size_t new_push_position = push_position + nb_pushed;
+    push_position_.store(new_push_position, std::memory_order_release);
+
+    // wake up the consumer if this push reached the watermark ------------
+    // the cached size is an upper bound, below the watermark nothing to do.
+    if (new_push_position - cached_pop_position_ >= watermark_)
+    {
+        // paired with the fence of wait_for_elements(): either we see the
+        // pop position of the sleeping consumer, or it sees this push.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cached_pop_position_ = pop_position_.load(std::memory_order_acquire);
+        size_t size = new_push_position - cached_pop_position_;
+        if (size >= watermark_ && size - nb_pushed < watermark_)
+        {
+            not_empty_.notify_one();
+        }
+    }
+    return nb_pushed;
+}
+
+template <typename Type, size_t CAPACITY>
+size_t SpscQueue<Type, CAPACITY>::pop_n(Type* data, size_t max_nb_elements)
+{
+    // look at the push position only if the cached one says it is empty --
+    size_t pop_position = pop_position_.load(std::memory_order_relaxed);
+    if (cached_push_position_ - pop_position < max_nb_elements)
+    {
+        // acquire: the elements pushed are visible.
+        cached_push_position_ = push_position_.load(std::memory_order_acquire);
+    }
+    size_t nb_popped =
+        std::min(max_nb_elements, cached_push_position_ - pop_position);
+
+    // copy the elements and release their room ---------------------------
+    for (size_t i = 0; i < nb_popped; ++i)
+    {
+        data[i] = elements_[(pop_position + i) & (CAPACITY - 1)];
+    }
+    pop_position_.store(pop_position + nb_popped, std::memory_order_release);
+    return nb_popped;
+}
+
+template <typename Type, size_t CAPACITY>
+SpscSpan<const Type> SpscQueue<Type, CAPACITY>::peek()
+{
+    // the span stops at the end of the ring ------------------------------
+    size_t pop_position = pop_position_.load(std::memory_order_relaxed);
+    size_t index = pop_position & (CAPACITY - 1);
+    size_t max_size = CAPACITY - index;
+    if (cached_push_position_ - pop_position < max_size)
+    {
+        cached_push_position_ = push_position_.load(std::memory_order_acquire);
+    }
+    SpscSpan<const Type> span;
+    span.data_ = &elements_[index];
+    span.size_ = std::min(max_size, cached_push_position_ - pop_position);
+    return span;
+}
+
+template <typename Type, size_t CAPACITY>
+size_t SpscQueue<Type, CAPACITY>::consume(size_t nb_elements)
+{
+    // never move the pop position past the elements pushed ---------------
+    size_t pop_position = pop_position_.load(std::memory_order_relaxed);
+    if (cached_push_position_ - pop_position < nb_elements)
+    {
+        cached_push_position_ = push_position_.load(std::memory_order_acquire);
+        nb_elements =
+            std::min(nb_elements, cached_push_position_ - pop_position);
+    }
+    pop_position_.store(pop_position + nb_elements, std::memory_order_release);
+    return nb_elements;
+}
+
+}  // namespace real_time_tools
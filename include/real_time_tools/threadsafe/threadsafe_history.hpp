@@ -0,0 +1,653 @@
+/**
+ * @file threadsafe_history.hpp
+ * @brief This file declares a fixed capacity history of timestamped
+ * elements, written by one thread and read by many. The readers never block
+ * the writer.
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "real_time_tools/threadsafe/threadsafe_storage.hpp"
+#include "real_time_tools/timer.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Result of the reads of a ThreadsafeHistoryInterface.
+ */
+enum class HistoryStatus
+{
+    /**
+     * @brief The requested element was read.
+     */
+    OK,
+    /**
+     * @brief The requested element has not been added yet.
+     */
+    NOT_ADDED_YET,
+    /**
+     * @brief The requested element was overwritten by newer ones, the reader
+     * fell behind, or dropped by a writer that did not wait for a reader.
+     */
+    OVERWRITTEN
+};
+
+/**
+ * @brief Where a reader of a ThreadsafeHistory resumes when the elements it
+ * asked for were overwritten. The fewer elements a reader skips, the sooner
+ * the writer overruns it again.
+ */
+enum class HistoryResume
+{
+    /**
+     * @brief The oldest element: the fewest elements lost, but it is the
+     * next one to be overwritten, so a reader slower than the writer is
+     * overrun again on every read.
+     */
+    OLDEST,
+    /**
+     * @brief Half the capacity behind the newest element: the reader has
+     * half the capacity as a margin before its next overrun.
+     */
+    HALF_CAPACITY,
+    /**
+     * @brief The newest element: the most elements lost, the whole capacity
+     * as a margin.
+     */
+    NEWEST
+};
+
+/**
+ * @brief How ThreadsafeHistory::at() computes the value at a given date.
+ */
+enum class HistoryLookup
+{
+    /**
+     * @brief The newest element added at or before the date.
+     */
+    PREVIOUS,
+    /**
+     * @brief The element the closest to the date.
+     */
+    NEAREST,
+    /**
+     * @brief Interpolation between the elements before and after the date,
+     * see history_interpolation.
+     */
+    INTERPOLATE
+};
+
+/**
+ * @brief Interpolation of the elements of a ThreadsafeHistory.
+ *
+ * By default, the types with a slerp(ratio, other) method
+ * (Eigen::Quaternion) are interpolated with it, the other ones linearly with
+ * before + (after - before) * ratio (numbers, Eigen matrices). Specialize it
+ * for other types:
+ * @code
+ * namespace real_time_tools
+ * {
+ * template <>
+ * struct history_interpolation<Pose>
+ * {
+ *     static Pose interpolate(const Pose& before,
+ *                             const Pose& after,
+ *                             double ratio);
+ * };
+ * }
+ * @endcode
+ *
+ * @tparam Type is the type of the elements.
+ * @tparam Enable is used to detect the slerp() method.
+ */
+template <typename Type, typename Enable = void>
+struct history_interpolation
+{
+    /**
+     * @brief Linear interpolation.
+     *
+     * @param before is the value at the ratio 0.
+     * @param after is the value at the ratio 1.
+     * @param ratio is in [0, 1].
+     * @return Type
+     */
+    static Type interpolate(const Type& before, const Type& after, double ratio)
+    {
+        return before + (after - before) * ratio;
+    }
+};
+
+/**
+ * @brief Spherical linear interpolation of the types with a slerp() method.
+ *
+ * @tparam Type is the type of the elements.
+ */
+template <typename Type>
+struct history_interpolation<
+    Type,
+    decltype(void(std::declval<const Type&>().slerp(
+        0.0, std::declval<const Type&>())))>
+{
+    /**
+     * @brief Spherical linear interpolation.
+     *
+     * @param before is the value at the ratio 0.
+     * @param after is the value at the ratio 1.
+     * @param ratio is in [0, 1].
+     * @return Type
+     */
+    static Type interpolate(const Type& before, const Type& after, double ratio)
+    {
+        return before.slerp(ratio, after);
+    }
+};
+
+/**
+ * @brief One element of a ThreadsafeHistoryInterface.
+ *
+ * @tparam Type is the type of the data to store.
+ */
+template <typename Type>
+struct HistoryElement
+{
+    /**
+     * @brief Id of the element, the n-th element added has the id n - 1.
+     */
+    size_t id_;
+    /**
+     * @brief Date of the element in seconds, see
+     * Timer::get_current_time_sec().
+     */
+    double timestamp_;
+    /**
+     * @brief The datum.
+     */
+    Type datum_;
+};
+
+/**
+ * @brief This is a template abstract interface class that define a data
+ * history. This re-writting of the vector style class is thread safe. So it
+ * allows the user to use the object without having to deal with mutexes nor
+ * condition variables.
+ *
+ * The elements get increasing ids. A history only keeps the newest
+ * elements, readers that fall behind are told that the elements they ask for
+ * were overwritten.
+ *
+ * @tparam Type is the type of the data to store.
+ */
+template <typename Type>
+class ThreadsafeHistoryInterface
+{
+public:
+    /**
+     * @brief Destroy the ThreadsafeHistoryInterface object.
+     */
+    virtual ~ThreadsafeHistoryInterface()
+    {
+    }
+
+    /**
+     * @brief Add an element dated now.
+     *
+     * @param datum
+     * @return size_t the id of the element.
+     */
+    virtual size_t add(const Type& datum) = 0;
+
+    /**
+     * @brief Add an element with a given date, e.g. to replay a log.
+     *
+     * @param datum
+     * @param timestamp in seconds.
+     * @return size_t the id of the element.
+     */
+    virtual size_t add(const Type& datum, double timestamp) = 0;
+
+    /**
+     * @brief Get the element with a given id, does not wait.
+     *
+     * @param id
+     * @param element is set if the status is OK.
+     * @return HistoryStatus
+     */
+    virtual HistoryStatus get(size_t id,
+                              HistoryElement<Type>& element) const = 0;
+
+    /**
+     * @brief Get the element after the one with the given id, does not
+     * wait. If it was overwritten, no element is read: element.id_ is set
+     * to the id to continue from, the elements after id up to element.id_
+     * were lost. The next call then reads the element chosen by resume.
+     *
+     * @param id
+     * @param element is set if the status is OK, only its id_ if the status
+     * is OVERWRITTEN.
+     * @param resume selects the element read after an overrun.
+     * @return HistoryStatus
+     */
+    virtual HistoryStatus try_get_next(
+        size_t id,
+        HistoryElement<Type>& element,
+        HistoryResume resume = HistoryResume::HALF_CAPACITY) const = 0;
+
+    /**
+     * @brief Get the element after the one with the given id. if there is no
+     * newer element, then wait until one arrives. See try_get_next().
+     *
+     * @param id
+     * @param element is set if the status is OK, only its id_ if the status
+     * is OVERWRITTEN.
+     * @param resume selects the element read after an overrun.
+     * @return HistoryStatus OK or OVERWRITTEN.
+     */
+    virtual HistoryStatus get_next(
+        size_t id,
+        HistoryElement<Type>& element,
+        HistoryResume resume = HistoryResume::HALF_CAPACITY) const = 0;
+
+    /**
+     * @brief Get the id of the newest element, this function waits if it is
+     * empty.
+     *
+     * @return size_t
+     */
+    virtual size_t get_newest_id() const = 0;
+
+    /**
+     * @brief Get the id of the oldest element still in the history, this
+     * function waits if it is empty.
+     *
+     * @return size_t
+     */
+    virtual size_t get_oldest_id() const = 0;
+
+    /**
+     * @brief Get the newest element, this function waits if it is empty.
+     *
+     * @return HistoryElement<Type>
+     */
+    virtual HistoryElement<Type> get_newest() const
+    {
+        HistoryElement<Type> element;
+        while (get(get_newest_id(), element) != HistoryStatus::OK)
+        {
+        }
+        return element;
+    }
+};
+
+/**
+ * @brief Fixed capacity history written by a single thread and read by any
+ * number of threads, in a ring buffer.
+ *
+ * Each element is stored in its own slot with its id and its timestamp.
+ * The writer marks a slot as being written before overwriting it, the
+ * readers check the id of the slot before and after their copy, so that
+ * they never return an element that was overwritten meanwhile. Readers never
+ * block the writer. When use_seqlock_storage is specialized for Type, the
+ * writer never waits and never drops an element. Otherwise each slot has its
+ * own mutex: if a reader is copying the slot to overwrite, which it would
+ * find overwritten anyway, the writer drops the new element instead of
+ * waiting, and the readers find it OVERWRITTEN.
+ *
+ * Copies of the object share the same history.
+ *
+ * Example:
+ * @snippet demo_threadsafe_history.cpp Usage of ThreadsafeHistory
+ *
+ * @tparam Type is the type of the data to store.
+ * @tparam CAPACITY is the number of elements kept.
+ */
+template <typename Type, size_t CAPACITY>
+class ThreadsafeHistory : public ThreadsafeHistoryInterface<Type>
+{
+public:
+    static_assert(CAPACITY > 0, "a history keeps at least one element");
+
+    /**
+     * @brief Construct a new empty ThreadsafeHistory object.
+     */
+    ThreadsafeHistory();
+
+    size_t add(const Type& datum) override
+    {
+        return add(datum, Timer::get_current_time_sec());
+    }
+
+    /**
+     * @brief Add an element, must be called by a single thread.
+     *
+     * @copydoc ThreadsafeHistoryInterface::add(const Type&, double)
+     */
+    size_t add(const Type& datum, double timestamp) override;
+
+    HistoryStatus get(size_t id,
+                      HistoryElement<Type>& element) const override;
+
+    HistoryStatus try_get_next(
+        size_t id,
+        HistoryElement<Type>& element,
+        HistoryResume resume = HistoryResume::HALF_CAPACITY) const override;
+
+    HistoryStatus get_next(
+        size_t id,
+        HistoryElement<Type>& element,
+        HistoryResume resume = HistoryResume::HALF_CAPACITY) const override;
+
+    /**
+     * @brief Get the value at a given date, with a binary search over the
+     * timestamps, that must increase with the ids. Does not wait and does
+     * not block the writer.
+     *
+     * Example:
+     * @snippet demo_threadsafe_history_interpolation.cpp Usage of at
+     *
+     * @param timestamp is the date in seconds.
+     * @param element is set if the status is OK. When interpolating, its id
+     * is the one of the element before the date and its timestamp is the
+     * date.
+     * @param lookup selects the previous element, the nearest one or the
+     * interpolation between them.
+     * @return HistoryStatus OVERWRITTEN if the date is older than the oldest
+     * element or if an element it needs was dropped by the writer,
+     * NOT_ADDED_YET if it is newer than the newest element and the lookup
+     * needs the element after it.
+     */
+    HistoryStatus at(double timestamp,
+                     HistoryElement<Type>& element,
+                     HistoryLookup lookup = HistoryLookup::PREVIOUS) const;
+
+    size_t get_newest_id() const override
+    {
+        return wait_for_size(1) - 1;
+    }
+
+    size_t get_oldest_id() const override
+    {
+        return oldest_id(wait_for_size(1));
+    }
+
+    /**
+     * @brief Get the newest element not dropped by the writer, this
+     * function waits if it is empty.
+     *
+     * @return HistoryElement<Type>
+     */
+    HistoryElement<Type> get_newest() const override;
+
+    /**
+     * @brief Get the number of elements added so far.
+     *
+     * @return size_t
+     */
+    size_t get_nb_added() const
+    {
+        return shared_->nb_added_.get();
+    }
+
+    /**
+     * @brief Get the number of elements kept.
+     *
+     * @return size_t
+     */
+    size_t get_capacity() const
+    {
+        return CAPACITY;
+    }
+
+private:
+    /**
+     * @brief Value of the id of a slot being written or never written.
+     */
+    static constexpr size_t INVALID_ID = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief One element of the ring, on its own cache lines.
+     */
+    struct alignas(64) Slot
+    {
+        /**
+         * @brief Id of the element, INVALID_ID while it is written.
+         */
+        std::atomic<size_t> id_{INVALID_ID};
+        /**
+         * @brief Id of the last element dropped in this slot.
+         */
+        std::atomic<size_t> dropped_id_{INVALID_ID};
+        /**
+         * @brief Timestamp of the element.
+         */
+        std::atomic<double> timestamp_{0.0};
+        /**
+         * @brief The datum.
+         */
+        ThreadsafeStorage<Type> storage_;
+    };
+
+    /**
+     * @brief The data shared by the copies of the object.
+     */
+    struct SharedData
+    {
+        /**
+         * @brief The ring buffer, the element id is in the slot
+         * id % CAPACITY.
+         */
+        std::array<Slot, CAPACITY> slots_;
+        /**
+         * @brief Number of elements added, the readers wait on it.
+         */
+        ThreadsafeSequence nb_added_;
+    };
+
+    /**
+     * @brief Wait until at least size elements have been added.
+     *
+     * @param size
+     * @return size_t the number of elements added.
+     */
+    size_t wait_for_size(size_t size) const
+    {
+        return shared_->nb_added_.wait(size - 1);
+    }
+
+    /**
+     * @brief Was the element dropped by the writer instead of waiting for a
+     * reader? To call once a read of it failed.
+     *
+     * @param id
+     * @return true if the writer dropped the element.
+     */
+    bool is_dropped(size_t id) const;
+
+    /**
+     * @brief Get the timestamp of an element, does not wait.
+     *
+     * @param id
+     * @param timestamp is set if the element was read.
+     * @return true if the element is added and not overwritten.
+     */
+    bool get_timestamp(size_t id, double& timestamp) const;
+
+    /**
+     * @brief Id of the oldest element still in the ring.
+     *
+     * @param nb_added is the number of elements added.
+     * @return size_t
+     */
+    static size_t oldest_id(size_t nb_added)
+    {
+        return nb_added < CAPACITY ? 0 : nb_added - CAPACITY;
+    }
+
+    /**
+     * @brief Id of the element a reader resumes at after an overrun.
+     *
+     * @param nb_added is the number of elements added, at least 1.
+     * @param resume
+     * @return size_t
+     */
+    static size_t resume_id(size_t nb_added, HistoryResume resume)
+    {
+        switch (resume)
+        {
+            case HistoryResume::OLDEST:
+                return oldest_id(nb_added);
+            case HistoryResume::NEWEST:
+                return nb_added - 1;
+            default:
+                return nb_added - std::min(nb_added, (CAPACITY + 1) / 2);
+        }
+    }
+
+    /**
+     * @brief The ring buffer and the count of elements added.
+     */
+    std::shared_ptr<SharedData> shared_;
+};
+
+/**
+ * @brief Cursor of one reader of a ThreadsafeHistory, to broadcast every
+ * element of a writer, e.g. a real time loop, to several readers, e.g. a
+ * logger, a visualizer and a safety monitor, each at its own pace.
+ *
+ * Each reader thread owns its HistoryReader: the readers share nothing but
+ * the history, and the writer does not know about them. A reader sees every
+ * element as long as it stays less than CAPACITY elements behind the
+ * writer. Otherwise it is overrun: a read returns OVERWRITTEN without
+ * element, counts the elements lost and moves the cursor to the element
+ * chosen by its HistoryResume, half the capacity behind the newest one by
+ * default. The writer never waits for the readers.
+ *
+ * Example:
+ * @snippet demo_threadsafe_history_readers.cpp Usage of HistoryReader
+ *
+ * @tparam Type is the type of the data stored.
+ * @tparam CAPACITY is the number of elements kept by the history.
+ */
+template <typename Type, size_t CAPACITY>
+class HistoryReader
+{
+public:
+    /**
+     * @brief Construct a new HistoryReader object reading the elements added
+     * from now on.
+     *
+     * @param history
+     * @param resume selects the element read after an overrun.
+     */
+    explicit HistoryReader(
+        const ThreadsafeHistory<Type, CAPACITY>& history,
+        HistoryResume resume = HistoryResume::HALF_CAPACITY);
+
+    /**
+     * @brief Read the next element, does not wait.
+     *
+     * @param element is set if the status is OK.
+     * @return HistoryStatus OVERWRITTEN if the reader was overrun: no
+     * element is read, the lost elements are counted and the next read
+     * resumes after them.
+     */
+    HistoryStatus try_read(HistoryElement<Type>& element);
+
+    /**
+     * @brief Read the next element, waits until it is added. See
+     * try_read().
+     *
+     * @param element is set if the status is OK.
+     * @return HistoryStatus OK or OVERWRITTEN.
+     */
+    HistoryStatus read(HistoryElement<Type>& element);
+
+    /**
+     * @brief Get the number of elements added and not read yet, more than
+     * CAPACITY if the reader is overrun.
+     *
+     * @return size_t
+     */
+    size_t get_lag() const
+    {
+        return history_.get_nb_added() - cursor_;
+    }
+
+    /**
+     * @brief Get the id of the next element to read.
+     *
+     * @return size_t
+     */
+    size_t get_cursor() const
+    {
+        return cursor_;
+    }
+
+    /**
+     * @brief Get the number of elements overwritten before this reader could
+     * read them.
+     *
+     * @return size_t
+     */
+    size_t get_nb_lost_elements() const
+    {
+        return nb_lost_elements_;
+    }
+
+    /**
+     * @brief Get the number of times the writer overran this reader.
+     *
+     * @return size_t
+     */
+    size_t get_nb_overruns() const
+    {
+        return nb_overruns_;
+    }
+
+private:
+    /**
+     * @brief Move the cursor after the element read.
+     *
+     * @param status
+     * @param element
+     * @return HistoryStatus status.
+     */
+    HistoryStatus advance(HistoryStatus status,
+                          const HistoryElement<Type>& element);
+
+    /**
+     * @brief The history read, a copy sharing its elements.
+     */
+    ThreadsafeHistory<Type, CAPACITY> history_;
+    /**
+     * @brief Where to resume after an overrun.
+     */
+    HistoryResume resume_;
+    /**
+     * @brief Id of the next element to read.
+     */
+    size_t cursor_;
+    /**
+     * @brief Number of elements lost.
+     */
+    size_t nb_lost_elements_;
+    /**
+     * @brief Number of overruns.
+     */
+    size_t nb_overruns_;
+};
+
+}  // namespace real_time_tools
+
+#include "real_time_tools/threadsafe/threadsafe_history.hxx"
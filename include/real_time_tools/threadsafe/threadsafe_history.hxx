@@ -0,0 +1,328 @@
+/**
+ * @file threadsafe_history.hxx
+ * @brief This file defines the functions from threadsafe_history.hpp
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+namespace real_time_tools
+{
+template <typename Type, size_t CAPACITY>
+ThreadsafeHistory<Type, CAPACITY>::ThreadsafeHistory()
+{
+    shared_ = std::make_shared<SharedData>();
+}
+
+template <typename Type, size_t CAPACITY>
+size_t ThreadsafeHistory<Type, CAPACITY>::add(const Type& datum,
+                                              double timestamp)
+{
+    size_t id = shared_->nb_added_.get();
+    Slot& slot = shared_->slots_[id % CAPACITY];
+
+    // invalidate the slot before overwriting it ---------------------------
+    slot.id_.store(INVALID_ID, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // write the element, or drop it rather than wait for a reader copying
+    // the slot (mutex storage only) ----------------------------------------
+    slot.timestamp_.store(timestamp, std::memory_order_relaxed);
+    if (slot.storage_.try_set(datum))
+    {
+        slot.id_.store(id, std::memory_order_release);
+    }
+    else
+    {
+        slot.dropped_id_.store(id, std::memory_order_release);
+    }
+
+    // notify the readers --------------------------------------------------
+    shared_->nb_added_.increment();
+    return id;
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus ThreadsafeHistory<Type, CAPACITY>::get(
+    size_t id, HistoryElement<Type>& element) const
+{
+    if (id >= shared_->nb_added_.get())
+    {
+        return HistoryStatus::NOT_ADDED_YET;
+    }
+
+    // copy the element if the slot still holds it -------------------------
+    const Slot& slot = shared_->slots_[id % CAPACITY];
+    if (slot.id_.load(std::memory_order_acquire) != id)
+    {
+        return HistoryStatus::OVERWRITTEN;
+    }
+    element.datum_ = slot.storage_.get();
+    element.timestamp_ = slot.timestamp_.load(std::memory_order_relaxed);
+
+    // check that the writer did not start overwriting it meanwhile --------
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.id_.load(std::memory_order_relaxed) != id)
+    {
+        return HistoryStatus::OVERWRITTEN;
+    }
+    element.id_ = id;
+    return HistoryStatus::OK;
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus ThreadsafeHistory<Type, CAPACITY>::try_get_next(
+    size_t id, HistoryElement<Type>& element, HistoryResume resume) const
+{
+    HistoryStatus status = get(id + 1, element);
+    if (status != HistoryStatus::OVERWRITTEN)
+    {
+        return status;
+    }
+
+    // only this element was dropped, the next ones are still there --------
+    if (is_dropped(id + 1))
+    {
+        element.id_ = id + 1;
+        return status;
+    }
+
+    // the reader fell behind, skip the elements lost and a margin ---------
+    // without reading: the writer may overwrite the next one meanwhile.
+    size_t next_id = resume_id(shared_->nb_added_.get(), resume);
+    element.id_ = std::max(next_id, id + 2) - 1;
+    return status;
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus ThreadsafeHistory<Type, CAPACITY>::get_next(
+    size_t id, HistoryElement<Type>& element, HistoryResume resume) const
+{
+    while (true)
+    {
+        HistoryStatus status = try_get_next(id, element, resume);
+        if (status != HistoryStatus::NOT_ADDED_YET)
+        {
+            return status;
+        }
+        // wait until the element id + 1 is added --------------------------
+        wait_for_size(id + 2);
+    }
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryElement<Type> ThreadsafeHistory<Type, CAPACITY>::get_newest() const
+{
+    HistoryElement<Type> element;
+    while (true)
+    {
+        // take the newest element that was not dropped --------------------
+        size_t nb_added = wait_for_size(1);
+        bool overwritten = false;
+        for (size_t id = nb_added; id-- > oldest_id(nb_added) && !overwritten;)
+        {
+            if (get(id, element) == HistoryStatus::OK)
+            {
+                return element;
+            }
+            // overwritten meanwhile: start again from the newest one.
+            overwritten = !is_dropped(id);
+        }
+        if (!overwritten)
+        {
+            // all the elements left were dropped, wait for a new one.
+            wait_for_size(nb_added + 1);
+        }
+    }
+}
+
+template <typename Type, size_t CAPACITY>
+bool ThreadsafeHistory<Type, CAPACITY>::is_dropped(size_t id) const
+{
+    const Slot& slot = shared_->slots_[id % CAPACITY];
+    return slot.dropped_id_.load(std::memory_order_acquire) == id;
+}
+
+template <typename Type, size_t CAPACITY>
+bool ThreadsafeHistory<Type, CAPACITY>::get_timestamp(size_t id,
+                                                      double& timestamp) const
+{
+    if (id >= shared_->nb_added_.get())
+    {
+        return false;
+    }
+    const Slot& slot = shared_->slots_[id % CAPACITY];
+    if (slot.id_.load(std::memory_order_acquire) != id)
+    {
+        return false;
+    }
+    timestamp = slot.timestamp_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.id_.load(std::memory_order_relaxed) == id;
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus ThreadsafeHistory<Type, CAPACITY>::at(
+    double timestamp,
+    HistoryElement<Type>& element,
+    HistoryLookup lookup) const
+{
+    // start again whenever the writer overwrites an element we read -------
+    while (true)
+    {
+        size_t nb_added = shared_->nb_added_.get();
+        if (nb_added == 0)
+        {
+            return HistoryStatus::NOT_ADDED_YET;
+        }
+
+        // the date must be in [oldest, newest] ----------------------------
+        size_t before_id = oldest_id(nb_added);
+        size_t after_id = nb_added - 1;
+        double before_timestamp, after_timestamp;
+        if (!get_timestamp(before_id, before_timestamp) ||
+            !get_timestamp(after_id, after_timestamp))
+        {
+            if (is_dropped(before_id) || is_dropped(after_id))
+            {
+                return HistoryStatus::OVERWRITTEN;
+            }
+            continue;
+        }
+        if (timestamp < before_timestamp)
+        {
+            return HistoryStatus::OVERWRITTEN;
+        }
+        if (timestamp >= after_timestamp)
+        {
+            if (timestamp > after_timestamp &&
+                lookup == HistoryLookup::INTERPOLATE)
+            {
+                return HistoryStatus::NOT_ADDED_YET;
+            }
+            if (get(after_id, element) != HistoryStatus::OK)
+            {
+                if (is_dropped(after_id))
+                {
+                    return HistoryStatus::OVERWRITTEN;
+                }
+                continue;
+            }
+            return HistoryStatus::OK;
+        }
+
+        // binary search of the elements around the date -------------------
+        bool overwritten = false;
+        while (after_id - before_id > 1 && !overwritten)
+        {
+            size_t middle_id = before_id + (after_id - before_id) / 2;
+            double middle_timestamp;
+            if (!get_timestamp(middle_id, middle_timestamp))
+            {
+                if (is_dropped(middle_id))
+                {
+                    return HistoryStatus::OVERWRITTEN;
+                }
+                overwritten = true;
+            }
+            else if (middle_timestamp <= timestamp)
+            {
+                before_id = middle_id;
+            }
+            else
+            {
+                after_id = middle_id;
+            }
+        }
+        if (overwritten)
+        {
+            continue;
+        }
+        if (get(before_id, element) != HistoryStatus::OK)
+        {
+            if (is_dropped(before_id))
+            {
+                return HistoryStatus::OVERWRITTEN;
+            }
+            continue;
+        }
+        HistoryElement<Type> after;
+        if (lookup != HistoryLookup::PREVIOUS &&
+            get(after_id, after) != HistoryStatus::OK)
+        {
+            if (is_dropped(after_id))
+            {
+                return HistoryStatus::OVERWRITTEN;
+            }
+            continue;
+        }
+
+        // before <= date < after ------------------------------------------
+        if (lookup == HistoryLookup::NEAREST &&
+            after.timestamp_ - timestamp < timestamp - element.timestamp_)
+        {
+            element = after;
+        }
+        else if (lookup == HistoryLookup::INTERPOLATE)
+        {
+            double ratio = (timestamp - element.timestamp_) /
+                           (after.timestamp_ - element.timestamp_);
+            element.datum_ = history_interpolation<Type>::interpolate(
+                element.datum_, after.datum_, ratio);
+            element.timestamp_ = timestamp;
+        }
+        return HistoryStatus::OK;
+    }
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryReader<Type, CAPACITY>::HistoryReader(
+    const ThreadsafeHistory<Type, CAPACITY>& history, HistoryResume resume)
+    : history_(history),
+      resume_(resume),
+      cursor_(history.get_nb_added()),
+      nb_lost_elements_(0),
+      nb_overruns_(0)
+{
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus HistoryReader<Type, CAPACITY>::try_read(
+    HistoryElement<Type>& element)
+{
+    // try_get_next() reads the id after the given one, so cursor_ - 1 wraps
+    // around to read the element 0.
+    return advance(history_.try_get_next(cursor_ - 1, element, resume_),
+                   element);
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus HistoryReader<Type, CAPACITY>::read(
+    HistoryElement<Type>& element)
+{
+    return advance(history_.get_next(cursor_ - 1, element, resume_),
+                   element);
+}
+
+template <typename Type, size_t CAPACITY>
+HistoryStatus HistoryReader<Type, CAPACITY>::advance(
+    HistoryStatus status, const HistoryElement<Type>& element)
+{
+    if (status == HistoryStatus::NOT_ADDED_YET)
+    {
+        return status;
+    }
+    if (status == HistoryStatus::OVERWRITTEN)
+    {
+        // no element was read, the ones up to element.id_ are lost.
+        nb_lost_elements_ += element.id_ + 1 - cursor_;
+        ++nb_overruns_;
+    }
+    cursor_ = element.id_ + 1;
+    return status;
+}
+
+}  // namespace real_time_tools
@@ -13,82 +13,175 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <limits>
 #include <map>
 #include <memory>
+#include <stdexcept>
+#include <string_view>
 #include <tuple>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
+#include "real_time_tools/shared_memory_segment.hpp"
+#include "real_time_tools/threadsafe/threadsafe_history.hpp"
+#include "real_time_tools/threadsafe/threadsafe_storage.hpp"
 #include "real_time_tools/timer.hpp"
 
-#include <condition_variable>
+#include <atomic>
 #include <mutex>
+#include <new>
 
 namespace real_time_tools
 {
 /**
- * @brief This is a template abstract interface class that define a data
- * history. This re-writting of the vector style class is thread safe. So it
- * allows the user to use the object without having to deal with mutexes nor
- * condition variables. This class is not used so far.
+ * @brief Result of a wait_for_update() of the threadsafe objects.
  *
- * @tparam Type is the type of the data to store.
+ * Every set() increments the sequence number of the modified index and the
+ * total sequence number. A reader that passes the last sequence it has seen
+ * to wait_for_update() never misses an update silently: the updates it did
+ * not observe are counted in nb_skipped_ and the reader decides how to
+ * handle them.
  */
-template <typename Type>
-class ThreadsafeHistoryInterface
+struct ThreadsafeUpdate
 {
     /**
-     * @brief Get the element after the one with the given id. if there is no
-     * newer element, then wait until one arrives.
+     * @brief Default value of the last_sequence arguments: wait for the next
+     * update after the call.
+     */
+    static constexpr size_t CURRENT_SEQUENCE =
+        std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Index of the data modified. For the updates of any index, the
+     * index of the latest update.
+     */
+    size_t index_;
+    /**
+     * @brief Sequence number after the update (number of set() of the
+     * index, or of all indexes for the updates of any index).
+     */
+    size_t sequence_;
+    /**
+     * @brief Number of updates that happened between the last sequence given
+     * and this one, and were not observed.
+     */
+    size_t nb_skipped_;
+};
+
+/**
+ * @brief Names of the data of a SingletypeThreadsafeObject, known at compile
+ * time. index() resolves a name in a constant expression, so that the
+ * access by name costs the same as the access by index:
+ * @code
+ * constexpr real_time_tools::ThreadsafeNames LEG("hip", "knee", "ankle");
+ * real_time_tools::SingletypeThreadsafeObject<double, LEG.size()> leg(LEG);
+ * leg.set<LEG.index("knee")>(0.5);
+ * @endcode
+ * An unknown or duplicated name is a compilation error.
+ *
+ * Example:
+ * @snippet demo_threadsafe_object_names.cpp Usage of ThreadsafeNames
+ *
+ * @tparam SIZE is the number of names.
+ */
+template <size_t SIZE>
+class ThreadsafeNames
+{
+public:
+    /**
+     * @brief Construct a new ThreadsafeNames object.
      *
-     * @param id is the index of the element in the buffer.
-     * @return Type the next element.
+     * @tparam Names are string literals or std::string_view.
+     * @param names are all different.
      */
-    virtual Type get_next(size_t id) const
+    template <typename... Names>
+    explicit constexpr ThreadsafeNames(const Names&... names)
+        : names_{std::string_view(names)...}
     {
-        return get(get_next_id(id));
+        static_assert(sizeof...(Names) == SIZE, "one name per datum");
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (names_[i] == names_[j])
+                {
+                    throw std::invalid_argument("duplicated name");
+                }
+            }
+        }
     }
-    virtual size_t get_next_id(size_t id) const = 0;
 
     /**
-     * @brief Get the newest value, this function waits if it is empty.
+     * @brief Get the index of a name.
      *
-     * @return Type the newest element.
+     * @param name
+     * @return size_t
      */
-    virtual Type get_newest() const
+    constexpr size_t index(std::string_view name) const
     {
-        return get(get_newest_id());
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            if (names_[i] == name)
+            {
+                return i;
+            }
+        }
+        throw std::out_of_range("unknown name");
     }
 
     /**
-     * @brief get_newest_id
+     * @brief Get the name of an index.
      *
-     * @return size_t
+     * @param index
+     * @return std::string_view
      */
-    virtual size_t get_newest_id() const = 0;
+    constexpr std::string_view name(size_t index) const
+    {
+        return names_[index];
+    }
 
     /**
-     * @brief Get the value whith a specific id.
+     * @brief Get the number of names.
      *
-     * @param id
-     * @return Type
+     * @return size_t
      */
-    virtual Type get(size_t id) const = 0;
+    constexpr size_t size() const
+    {
+        return SIZE;
+    }
 
+private:
     /**
-     * @brief I guess this is to add a value but with no argument?
-     * \todo Manuel, could you delete this class or provide an implementation?
+     * @brief The names, the name of the datum i is at the index i.
      */
-    virtual void add() = 0;
+    std::array<std::string_view, SIZE> names_;
 };
 
+/**
+ * @brief Deduce the number of names from the arguments.
+ */
+template <typename... Names>
+ThreadsafeNames(const Names&...)->ThreadsafeNames<sizeof...(Names)>;
+
 /**
  * @brief The SingletypeThreadsafeObject is a thread safe object
  *
+ * The data is protected by a mutex, or by a seqlock if
+ * use_seqlock_storage<Type> is specialized to true (see ThreadsafeStorage).
+ * Each datum, its lock and its sequence number are stored together in a
+ * ThreadsafeSlot, all the slots in one allocation.
+ *
  * @tparam Type is the data type to store in the buffer.
  * @tparam SIZE is the size of the buffer. It is better to know it at compile
  * time to be 100% real time safe.
+ * @tparam LAYOUT use ThreadsafeLayout::CACHE_ALIGNED when several threads
+ * write different indexes concurrently.
  */
-template <typename Type, size_t SIZE>
+template <typename Type,
+          size_t SIZE,
+          ThreadsafeLayout LAYOUT = ThreadsafeLayout::COMPACT>
 class SingletypeThreadsafeObject
 {
 public:
@@ -104,29 +197,175 @@ public:
      */
     SingletypeThreadsafeObject(const std::vector<std::string>& names);
 
+    /**
+     * @brief Construct a new SingletypeThreadsafeObject object with names
+     * known at compile time. The data can also be accessed by name at run
+     * time.
+     *
+     * @param names
+     */
+    SingletypeThreadsafeObject(const ThreadsafeNames<SIZE>& names);
+
+    /**
+     * @brief Move this object to a new named POSIX shared memory segment:
+     * other processes can then open_shared_memory() it and get(), set() and
+     * wait_for_update() without any copy nor serialization. The data set
+     * before is dropped. The segment is removed when this object and its
+     * copies are destroyed.
+     *
+     * Only the types for which use_seqlock_storage is specialized can be
+     * shared: they are copied with memcpy and must not contain pointers.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_shared_memory.cpp Create the segment
+     *
+     * @param segment_name
+     * @param replace an existing segment with the same name, e.g. left by
+     * a process that crashed, instead of failing (see
+     * SharedMemorySegment::create()).
+     * @return true if the object is in shared memory.
+     */
+    bool create_shared_memory(const std::string& segment_name,
+                              bool replace = false);
+
+    /**
+     * @brief Use the shared memory segment created by another process with
+     * create_shared_memory(), with the same template arguments.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_shared_memory.cpp Open the segment
+     *
+     * @param segment_name
+     * @return false if the segment does not exist (yet) or does not hold
+     * the same object: same type, size, layout and version of the shared
+     * memory format.
+     */
+    bool open_shared_memory(const std::string& segment_name);
+
     /**
      * @brief Wait until the data at the given index is modified.
      *
      * @param index
+     * @param last_sequence is the last sequence number of this index seen by
+     * the caller. Returns right away if the data has been modified since.
+     * By default, waits for the next update after the call.
+     * @return ThreadsafeUpdate the new sequence number and the number of
+     * updates skipped.
      */
-    void wait_for_update(const size_t& index) const;
+    ThreadsafeUpdate wait_for_update(
+        const size_t& index,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const;
 
     /**
      * @brief Wait until the data at the given name is modified.
      *
      * @param name
+     * @param last_sequence see wait_for_update(const size_t&, size_t).
+     * @return ThreadsafeUpdate
      */
-    void wait_for_update(const std::string& name) const
+    ThreadsafeUpdate wait_for_update(
+        std::string_view name,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const
     {
-        wait_for_update(name_to_index_.at(name));
+        return wait_for_update(get_index(name), last_sequence);
+    }
+
+    /**
+     * @brief Wait until the data at the given index is modified or until a
+     * deadline, so that a real time reader does not hang if the writer
+     * died. Does not read the clock if the data was already modified.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_timeout.cpp Usage of wait_for_update_for
+     *
+     * @param index
+     * @param deadline is a date of std::chrono::steady_clock, which is
+     * CLOCK_MONOTONIC on linux.
+     * @param update is set if the data was modified, see wait_for_update().
+     * @param last_sequence see wait_for_update(const size_t&, size_t).
+     * @return true if the data was modified before the deadline.
+     */
+    bool wait_for_update_until(
+        const size_t& index,
+        const std::chrono::steady_clock::time_point& deadline,
+        ThreadsafeUpdate& update,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const;
+
+    /**
+     * @brief Wait until the data at the given index is modified, at most for
+     * a timeout. See wait_for_update_until().
+     *
+     * @tparam Rep
+     * @tparam Period
+     * @param index
+     * @param timeout
+     * @param update is set if the data was modified.
+     * @param last_sequence see wait_for_update(const size_t&, size_t).
+     * @return true if the data was modified before the timeout.
+     */
+    template <typename Rep, typename Period>
+    bool wait_for_update_for(
+        const size_t& index,
+        const std::chrono::duration<Rep, Period>& timeout,
+        ThreadsafeUpdate& update,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const
+    {
+        // no clock read if the update is already there.
+        if (last_sequence != ThreadsafeUpdate::CURRENT_SEQUENCE &&
+            get_sequence(index) > last_sequence)
+        {
+            update = wait_for_update(index, last_sequence);
+            return true;
+        }
+        return wait_for_update_until(
+            index,
+            std::chrono::steady_clock::now() +
+                std::chrono::ceil<std::chrono::steady_clock::duration>(timeout),
+            update,
+            last_sequence);
     }
 
     /**
      * @brief Wait unitl any data has been changed and return its index.
      *
+     * @return size_t the index of the latest update.
+     */
+    size_t wait_for_update() const
+    {
+        return wait_for_any_update().index_;
+    }
+
+    /**
+     * @brief Wait until any data has been changed.
+     *
+     * @param last_total_sequence is the last total sequence number seen by
+     * the caller, by default waits for the next update after the call.
+     * @return ThreadsafeUpdate the index of the latest update, the new total
+     * sequence number and the number of updates skipped.
+     */
+    ThreadsafeUpdate wait_for_any_update(
+        size_t last_total_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const;
+
+    /**
+     * @brief Get the number of updates of an index so far.
+     *
+     * @param index
      * @return size_t
      */
-    size_t wait_for_update() const;
+    size_t get_sequence(const size_t& index) const
+    {
+        return shared_->slots_[index].sequence_.get();
+    }
+
+    /**
+     * @brief Get the number of updates of all indexes so far.
+     *
+     * @return size_t
+     */
+    size_t get_total_sequence() const
+    {
+        return shared_->total_modification_count_.get();
+    }
 
     /**
      * Getters
@@ -150,19 +389,20 @@ public:
      */
     Type get(const size_t& index = 0) const
     {
-        std::unique_lock<std::mutex> lock((*data_mutexes_)[index]);
-        return (*data_)[index];
+        return shared_->slots_[index].storage_.get();
     }
 
     /**
-     * @brief Get the data by its name in the buffer.
+     * @brief Get the data by its name in the buffer. Prefer
+     * get<NAMES.index(name)>() with ThreadsafeNames, which does not search
+     * the name at run time.
      *
      * @param name
      * @return Type
      */
-    Type get(const std::string& name) const
+    Type get(std::string_view name) const
     {
-        return get(name_to_index_.at(name));
+        return get(get_index(name));
     }
 
     /**
@@ -178,6 +418,41 @@ public:
         return get(INDEX);
     }
 
+    /**
+     * @brief Call a function on the data at an index, without copying it
+     * (see ThreadsafeStorage::read()). The data is locked during the call
+     * with the mutex storage, so the callable must be short and must not
+     * keep a reference to the data.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_zero_copy.cpp Usage of read
+     *
+     * @tparam Callable
+     * @param callable is called with a const Type&.
+     * @param index
+     * @return what the callable returns.
+     */
+    template <typename Callable>
+    auto read(Callable&& callable, const size_t& index = 0) const
+    {
+        return shared_->slots_[index].storage_.read(
+            std::forward<Callable>(callable));
+    }
+
+    /**
+     * @brief Call a function on the data at a name, without copying it.
+     *
+     * @tparam Callable
+     * @param callable is called with a const Type&.
+     * @param name
+     * @return what the callable returns.
+     */
+    template <typename Callable>
+    auto read(Callable&& callable, std::string_view name) const
+    {
+        return read(std::forward<Callable>(callable), get_index(name));
+    }
+
     /**
      * Setters.
      */
@@ -190,6 +465,29 @@ public:
      */
     void set(const Type& datum, const size_t& index = 0);
 
+    /**
+     * @brief Move one element in at a designated index, without copying its
+     * content.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_zero_copy.cpp Usage of set with move
+     *
+     * @param datum
+     * @param index
+     */
+    void set(Type&& datum, const size_t& index = 0);
+
+    /**
+     * @brief Construct one element at a designated index from the arguments
+     * of a constructor of Type.
+     *
+     * @tparam Args
+     * @param index
+     * @param args
+     */
+    template <typename... Args>
+    void emplace(const size_t& index, Args&&... args);
+
     /**
      * @brief Set one element at a designated index.
      * Warning the index is resolved at compile time.
@@ -202,7 +500,7 @@ public:
     template <int INDEX = 0>
     void set(Type datum)
     {
-        set(datum, INDEX);
+        set(std::move(datum), INDEX);
     }
 
     /**
@@ -212,53 +510,130 @@ public:
      * @param datum
      * @param name
      */
-    void set(const Type& datum, const std::string& name)
+    void set(const Type& datum, std::string_view name)
     {
-        set(datum, name_to_index_.at(name));
+        set(datum, get_index(name));
     }
 
-private:
     /**
-     * @brief This is the data buffer.
-     */
-    std::shared_ptr<std::array<Type, SIZE>> data_;
-    /**
-     * @brief This is counting the data modification occurences for each
-     * individual buffers.
-     */
-    std::shared_ptr<std::array<size_t, SIZE>> modification_counts_;
-    /**
-     * @brief This is counting the all data modification occurences for all
-     * buffer.
-     * /todo Can't we just some the modification_counts_ array whenever needed?
+     * @brief Move one element in at a designated name.
+     *
+     * @param datum
+     * @param name
      */
-    std::shared_ptr<size_t> total_modification_count_;
+    void set(Type&& datum, std::string_view name)
+    {
+        set(std::move(datum), get_index(name));
+    }
 
     /**
-     * @brief This is the map that allow to deal with data by their names.
+     * @brief Get the index of a name given to the constructor.
+     *
+     * @param name
+     * @return size_t
+     * @throw std::out_of_range if the name is unknown.
      */
-    std::map<std::string, size_t> name_to_index_;
+    size_t get_index(std::string_view name) const
+    {
+        auto name_index = name_to_index_.find(name);
+        if (name_index == name_to_index_.end())
+        {
+            throw std::out_of_range("SingletypeThreadsafeObject: unknown name");
+        }
+        return name_index->second;
+    }
 
+private:
     /**
-     * @brief This condition variable is used to wait untils any data has been
-     * changed.
-     */
-    mutable std::shared_ptr<std::condition_variable> condition_;
-    /**
-     * @brief This is the mutex of the condition varaible.
+     * @brief Notify the threads waiting for an index and for any index,
+     * after its datum was set.
+     *
+     * @param index
      */
-    mutable std::shared_ptr<std::mutex> condition_mutex_;
+    void notify_update(const size_t& index);
+
     /**
-     * @brief These are the individual mutexes of each data upon setting and
-     * getting.
+     * @brief The data shared by the copies of the object, in one
+     * allocation.
      */
-    mutable std::shared_ptr<std::array<std::mutex, SIZE>> data_mutexes_;
+    struct SharedData
+    {
+        /**
+         * @brief This is the data buffer. Each slot counts the data
+         * modification occurences of its datum, the threads waiting for one
+         * index sleep on its own futex.
+         */
+        std::array<ThreadsafeSlot<Type, LAYOUT>, SIZE> slots_;
+        /**
+         * @brief This is counting the all data modification occurences for
+         * all buffer, the threads waiting for any update sleep on its futex.
+         * Written by all the writers, so it does not share its cache line
+         * with the slots in the CACHE_ALIGNED layout.
+         */
+        alignas(LAYOUT == ThreadsafeLayout::CACHE_ALIGNED
+                    ? 64
+                    : alignof(ThreadsafeSequence))
+            ThreadsafeSequence total_modification_count_;
+        /**
+         * @brief Index of the latest update.
+         */
+        std::atomic<size_t> last_modified_index_;
+    };
+
+    /**
+     * @brief Layout of the shared memory segments.
+     */
+    struct SharedMemoryData
+    {
+        /**
+         * @brief Version of this layout, to increase whenever SharedData
+         * changes.
+         */
+        static constexpr uint32_t LAYOUT_VERSION = 1;
+        /**
+         * @brief Set by the creator once the data is initialized.
+         */
+        std::atomic<uint32_t> ready_;
+        /**
+         * @brief LAYOUT_VERSION of the creator.
+         */
+        uint32_t layout_version_;
+        /**
+         * @brief Hash of the name of this type, which includes Type, SIZE
+         * and LAYOUT.
+         */
+        uint64_t type_hash_;
+        /**
+         * @brief Size of the data.
+         */
+        uint64_t data_size_;
+        /**
+         * @brief The shared data.
+         */
+        SharedData data_;
+    };
+
+    /**
+     * @brief The data, the sequence numbers and the locks, on the heap or
+     * in a shared memory segment.
+     */
+    std::shared_ptr<SharedData> shared_;
+
+    /**
+     * @brief This is the map that allow to deal with data by their names,
+     * searched without building a std::string.
+     */
+    std::map<std::string, size_t, std::less<>> name_to_index_;
 };
 
 /**
  * @brief This object can have several types depending on what ones want to
  * store.
  *
+ * Each datum is protected by a mutex, or by a seqlock if
+ * use_seqlock_storage is specialized to true for its type (see
+ * ThreadsafeStorage).
+ *
  * @tparam Types
  */
 template <typename... Types>
@@ -287,26 +662,124 @@ public:
      * @brief Wait until the data with the deignated index is changed.
      *
      * @param index
+     * @param last_sequence is the last sequence number of this index seen by
+     * the caller. Returns right away if the data has been modified since.
+     * By default, waits for the next update after the call.
+     * @return ThreadsafeUpdate the new sequence number and the number of
+     * updates skipped.
      */
-    void wait_for_update(unsigned index) const;
+    ThreadsafeUpdate wait_for_update(
+        unsigned index,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const;
 
     /**
      * @brief Wait until the data with the designated index is changed.
      *
      * @tparam INDEX=0
+     * @param last_sequence see wait_for_update(unsigned, size_t).
+     * @return ThreadsafeUpdate
      */
     template <unsigned INDEX = 0>
-    void wait_for_update() const
+    ThreadsafeUpdate wait_for_update(
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const
+    {
+        return wait_for_update(INDEX, last_sequence);
+    }
+
+    /**
+     * @brief Wait until the data with the designated index is changed or
+     * until a deadline. Does not read the clock if the data was already
+     * changed.
+     *
+     * @param index
+     * @param deadline is a date of std::chrono::steady_clock, which is
+     * CLOCK_MONOTONIC on linux.
+     * @param update is set if the data was changed, see wait_for_update().
+     * @param last_sequence see wait_for_update(unsigned, size_t).
+     * @return true if the data was changed before the deadline.
+     */
+    bool wait_for_update_until(
+        unsigned index,
+        const std::chrono::steady_clock::time_point& deadline,
+        ThreadsafeUpdate& update,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const;
+
+    /**
+     * @brief Wait until the data with the designated index is changed, at
+     * most for a timeout. See wait_for_update_until().
+     *
+     * @tparam Rep
+     * @tparam Period
+     * @param index
+     * @param timeout
+     * @param update is set if the data was changed.
+     * @param last_sequence see wait_for_update(unsigned, size_t).
+     * @return true if the data was changed before the timeout.
+     */
+    template <typename Rep, typename Period>
+    bool wait_for_update_for(
+        unsigned index,
+        const std::chrono::duration<Rep, Period>& timeout,
+        ThreadsafeUpdate& update,
+        size_t last_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const
     {
-        wait_for_update(INDEX);
+        // no clock read if the update is already there.
+        if (last_sequence != ThreadsafeUpdate::CURRENT_SEQUENCE &&
+            get_sequence(index) > last_sequence)
+        {
+            update = wait_for_update(index, last_sequence);
+            return true;
+        }
+        return wait_for_update_until(
+            index,
+            std::chrono::steady_clock::now() +
+                std::chrono::ceil<std::chrono::steady_clock::duration>(timeout),
+            update,
+            last_sequence);
     }
 
     /**
      * @brief Wait until any data has been changed.
      *
+     * @return size_t the index of the latest update.
+     */
+    size_t wait_for_update() const
+    {
+        return wait_for_any_update().index_;
+    }
+
+    /**
+     * @brief Wait until any data has been changed.
+     *
+     * @param last_total_sequence is the last total sequence number seen by
+     * the caller, by default waits for the next update after the call.
+     * @return ThreadsafeUpdate the index of the latest update, the new total
+     * sequence number and the number of updates skipped.
+     */
+    ThreadsafeUpdate wait_for_any_update(
+        size_t last_total_sequence = ThreadsafeUpdate::CURRENT_SEQUENCE) const;
+
+    /**
+     * @brief Get the number of updates of an index so far.
+     *
+     * @param index
      * @return size_t
      */
-    size_t wait_for_update() const;
+    size_t get_sequence(unsigned index) const
+    {
+        return (*modification_counts_)[index].get();
+    }
+
+    /**
+     * @brief Get the number of updates of all indexes so far, a set_many()
+     * counts as one update.
+     *
+     * @return size_t
+     */
+    size_t get_total_sequence() const
+    {
+        return total_modification_count_->get();
+    }
 
     /**
      * Getters
@@ -322,13 +795,46 @@ public:
     template <int INDEX = 0>
     Type<INDEX> get() const;
 
+    /**
+     * @brief Get a consistent snapshot of several data: it holds all the
+     * data of a set_many() or none of them. The copies are retried when a
+     * set_many() ran meanwhile, and a set_many() in progress is waited for,
+     * sleeping if it lasts. set() is not a transaction: it never makes
+     * get_many() retry nor wait, and its datum may be seen in the middle of
+     * the snapshot.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_transaction.cpp Usage of get_many
+     *
+     * @tparam INDEXES are the indexes of the data.
+     * @return std::tuple<Type<INDEXES>...> copies of the data.
+     */
+    template <int... INDEXES>
+    std::tuple<Type<INDEXES>...> get_many() const;
+
+    /**
+     * @brief Call a function on the data with the designated index, without
+     * copying it (see ThreadsafeStorage::read()).
+     *
+     * @tparam INDEX=0
+     * @tparam Callable
+     * @param callable is called with a const Type<INDEX>&.
+     * @return what the callable returns.
+     */
+    template <int INDEX = 0, typename Callable>
+    auto read(Callable&& callable) const
+    {
+        return std::get<INDEX>(*data_).read(std::forward<Callable>(callable));
+    }
+
     /**
      * Setters
      */
 
     /**
      * @brief Set the data with the designated index. The index is resolved at
-     * compile time.
+     * compile time. The datum is moved in, so passing an rvalue does not
+     * copy its content.
      *
      * @tparam INDEX=0
      * @param datum
@@ -336,36 +842,61 @@ public:
     template <int INDEX = 0>
     void set(Type<INDEX> datum);
 
-private:
     /**
-     * @brief the actual data buffers.
+     * @brief Construct the data with the designated index from the
+     * arguments of a constructor of Type<INDEX>.
+     *
+     * @tparam INDEX
+     * @tparam Args
+     * @param args
      */
-    std::shared_ptr<std::tuple<Types...>> data_;
+    template <int INDEX, typename... Args>
+    void emplace(Args&&... args);
+
     /**
-     * @brief a condition variable that allow to wait until one data has been
-     * changed in the buffer.
+     * @brief Set several data in one transaction. get_many() sees all of
+     * them or none of them, the threads waiting for any update are notified
+     * once and the threads waiting for one of the indexes once each.
+     * Transactions are serialized between them, but not with set().
+     * The get_many() readers never block it, they wait for it.
+     *
+     * Example:
+     * @snippet demo_threadsafe_object_transaction.cpp Usage of set_many
+     *
+     * @tparam INDEXES are the indexes of the data, all different.
+     * @param data
      */
-    mutable std::shared_ptr<std::condition_variable> condition_;
+    template <int... INDEXES>
+    void set_many(const Type<INDEXES>&... data);
+
+private:
     /**
-     * @brief The mutex of the condition variable.
+     * @brief the actual data buffers.
      */
-    mutable std::shared_ptr<std::mutex> condition_mutex_;
+    std::shared_ptr<std::tuple<ThreadsafeStorage<Types>...>> data_;
     /**
      * @brief This is counting the data modification occurences for each
-     * individual buffers.
+     * individual buffers. The threads waiting for one index sleep on its
+     * own futex.
      */
-    std::shared_ptr<std::array<size_t, SIZE>> modification_counts_;
+    std::shared_ptr<std::array<ThreadsafeSequence, SIZE>> modification_counts_;
     /**
      * @brief This is counting the all data modification occurences for all
-     * buffer.
-     * /todo Can't we just some the modification_counts_ array whenever needed?
+     * buffer, the threads waiting for any update sleep on its futex.
+     */
+    std::shared_ptr<ThreadsafeSequence> total_modification_count_;
+    /**
+     * @brief Index of the latest update.
+     */
+    std::shared_ptr<std::atomic<size_t>> last_modified_index_;
+    /**
+     * @brief Counts the set_many() in progress for get_many().
      */
-    std::shared_ptr<size_t> total_modification_count_;
+    std::shared_ptr<ThreadsafeWriteCounter> write_counter_;
     /**
-     * @brief These are the individual mutexes of each data upon setting and
-     * getting.
+     * @brief Serializes the transactions of set_many().
      */
-    std::shared_ptr<std::array<std::mutex, SIZE>> data_mutexes_;
+    std::shared_ptr<std::mutex> transaction_mutex_;
 };
 
 }  // namespace real_time_tools
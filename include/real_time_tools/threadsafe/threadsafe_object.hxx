@@ -16,38 +16,26 @@
 
 namespace real_time_tools
 {
-template <typename Type, size_t SIZE>
-SingletypeThreadsafeObject<Type, SIZE>::SingletypeThreadsafeObject()
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::SingletypeThreadsafeObject()
 {
-    // initialize shared pointers ------------------------------------------
-    data_ = std::make_shared<std::array<Type, SIZE>>();
-    condition_ = std::make_shared<std::condition_variable>();
-    condition_mutex_ = std::make_shared<std::mutex>();
-    modification_counts_ = std::make_shared<std::array<size_t, SIZE>>();
-    total_modification_count_ = std::make_shared<size_t>();
-    data_mutexes_ = std::make_shared<std::array<std::mutex, SIZE>>();
-
-    // initialize counts ---------------------------------------------------
-    for (size_t i = 0; i < SIZE; i++)
-    {
-        (*modification_counts_)[i] = 0;
-    }
-    *total_modification_count_ = 0;
+    // initialize the shared data in one allocation -----------------------
+    shared_ = std::make_shared<SharedData>();
+    shared_->last_modified_index_ = 0;
 }
 
-template <typename Type, size_t SIZE>
-SingletypeThreadsafeObject<Type, SIZE>::SingletypeThreadsafeObject(
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::SingletypeThreadsafeObject(
     const std::vector<std::string>& names)
+    : SingletypeThreadsafeObject()
 {
-    SingletypeThreadsafeObject();
     if (names.size() != size())
     {
         rt_printf(
             "you passed a list of names of wrong size."
-            "expected size: %d, actual size: %d\n",
-            size(),
-            names.size());
-        rt_printf("name: %s\n", names[0].c_str());
+            "expected size: %lu, actual size: %lu\n",
+            static_cast<unsigned long>(size()),
+            static_cast<unsigned long>(names.size()));
         exit(-1);
     }
 
@@ -55,102 +43,195 @@ SingletypeThreadsafeObject<Type, SIZE>::SingletypeThreadsafeObject(
     {
         name_to_index_[names[i]] = i;
     }
-    //        name_to_index_ = name_to_index;
 }
 
-template <typename Type, size_t SIZE>
-void SingletypeThreadsafeObject<Type, SIZE>::set(const Type& datum,
-                                                 const size_t& index)
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::SingletypeThreadsafeObject(
+    const ThreadsafeNames<SIZE>& names)
+    : SingletypeThreadsafeObject()
+{
+    for (size_t i = 0; i < SIZE; i++)
+    {
+        name_to_index_.emplace(names.name(i), i);
+    }
+}
+
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+bool SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::create_shared_memory(
+    const std::string& segment_name, bool replace)
 {
-    // we sleep for a nanosecond, in case some thread calls set several
-    // times in a row. this way we do hopefully not miss messages
-    real_time_tools::Timer::sleep_sec(1e-9);
-    // set datum in our data_ member ---------------------------------------
+    static_assert(use_seqlock_storage<Type>::value,
+                  "only the types stored in a seqlock can be shared between "
+                  "processes, see use_seqlock_storage");
+    std::shared_ptr<SharedMemorySegment> segment =
+        std::make_shared<SharedMemorySegment>();
+    if (!segment->create(segment_name, sizeof(SharedMemoryData), replace))
     {
-        std::unique_lock<std::mutex> lock((*data_mutexes_)[index]);
-        (*data_)[index] = datum;
+        return false;
     }
 
-    // notify --------------------------------------------------------------
+    // initialize the data in the segment ----------------------------------
+    SharedMemoryData* shared_memory_data =
+        new (segment->get_address()) SharedMemoryData();
+    SharedData& data = shared_memory_data->data_;
+    for (ThreadsafeSlot<Type, LAYOUT>& slot : data.slots_)
     {
-        std::unique_lock<std::mutex> lock(*condition_mutex_);
-        (*modification_counts_)[index] += 1;
-        *total_modification_count_ += 1;
-        condition_->notify_all();
+        slot.storage_.set_process_shared(true);
+        slot.sequence_.set_process_shared(true);
     }
+    data.total_modification_count_.set_process_shared(true);
+    data.last_modified_index_ = 0;
+    shared_memory_data->layout_version_ = SharedMemoryData::LAYOUT_VERSION;
+    shared_memory_data->type_hash_ =
+        hash_type_name(typeid(SharedMemoryData).name());
+    shared_memory_data->data_size_ = sizeof(SharedData);
+    shared_memory_data->ready_.store(1, std::memory_order_release);
+
+    // the data keeps the segment mapped -----------------------------------
+    shared_ = std::shared_ptr<SharedData>(segment, &data);
+    return true;
 }
 
-template <typename Type, size_t SIZE>
-void SingletypeThreadsafeObject<Type, SIZE>::wait_for_update(
-    const size_t& index) const
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+bool SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::open_shared_memory(
+    const std::string& segment_name)
 {
-    std::unique_lock<std::mutex> lock(*condition_mutex_);
-
-    // wait until the datum with the right index is modified ---------------
-    size_t initial_modification_count = (*modification_counts_)[index];
-    while (initial_modification_count == (*modification_counts_)[index])
+    static_assert(use_seqlock_storage<Type>::value,
+                  "only the types stored in a seqlock can be shared between "
+                  "processes, see use_seqlock_storage");
+    std::shared_ptr<SharedMemorySegment> segment =
+        std::make_shared<SharedMemorySegment>();
+    if (!segment->open(segment_name, sizeof(SharedMemoryData)))
     {
-        condition_->wait(lock);
+        return false;
     }
 
-    // check that we did not miss data -------------------------------------
-    if (initial_modification_count + 1 != (*modification_counts_)[index])
+    // check that the creator initialized the same object ------------------
+    SharedMemoryData* shared_memory_data =
+        static_cast<SharedMemoryData*>(segment->get_address());
+    if (shared_memory_data->ready_.load(std::memory_order_acquire) != 1)
     {
-        rt_printf("size: %d, \n other info: %s \n", SIZE, __PRETTY_FUNCTION__);
-        rt_printf("something went wrong, we missed a message.\n");
-        exit(-1);
+        rt_printf("SingletypeThreadsafeObject: %s is not initialized yet\n",
+                  segment->get_name().c_str());
+        return false;
     }
+    if (shared_memory_data->layout_version_ !=
+            SharedMemoryData::LAYOUT_VERSION ||
+        shared_memory_data->type_hash_ !=
+            hash_type_name(typeid(SharedMemoryData).name()) ||
+        shared_memory_data->data_size_ != sizeof(SharedData))
+    {
+        rt_printf(
+            "SingletypeThreadsafeObject: %s holds an object of another "
+            "type\n",
+            segment->get_name().c_str());
+        return false;
+    }
+
+    // the data keeps the segment mapped -----------------------------------
+    shared_ = std::shared_ptr<SharedData>(segment, &shared_memory_data->data_);
+    return true;
 }
 
-template <typename Type, size_t SIZE>
-size_t SingletypeThreadsafeObject<Type, SIZE>::wait_for_update() const
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+void SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::set(const Type& datum,
+                                                         const size_t& index)
 {
-    std::unique_lock<std::mutex> lock(*condition_mutex_);
+    shared_->slots_[index].storage_.set(datum);
+    notify_update(index);
+}
 
-    // wait until any datum is modified ------------------------------------
-    std::array<size_t, SIZE> initial_modification_counts =
-        *modification_counts_;
-    size_t initial_modification_count = *total_modification_count_;
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+void SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::set(Type&& datum,
+                                                         const size_t& index)
+{
+    shared_->slots_[index].storage_.set(std::move(datum));
+    notify_update(index);
+}
+
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+template <typename... Args>
+void SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::emplace(
+    const size_t& index, Args&&... args)
+{
+    shared_->slots_[index].storage_.emplace(std::forward<Args>(args)...);
+    notify_update(index);
+}
 
-    while (initial_modification_count == *total_modification_count_)
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+void SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::notify_update(
+    const size_t& index)
+{
+    // notify the threads waiting for this index and for any index --------
+    shared_->last_modified_index_.store(index, std::memory_order_relaxed);
+    shared_->slots_[index].sequence_.increment();
+    shared_->total_modification_count_.increment();
+}
+
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+ThreadsafeUpdate
+SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::wait_for_update(
+    const size_t& index, size_t last_sequence) const
+{
+    // wait until the datum with the right index is modified ---------------
+    if (last_sequence == ThreadsafeUpdate::CURRENT_SEQUENCE)
     {
-        condition_->wait(lock);
+        last_sequence = shared_->slots_[index].sequence_.get();
     }
+    ThreadsafeUpdate update;
+    update.index_ = index;
+    update.sequence_ = shared_->slots_[index].sequence_.wait(last_sequence);
 
-    // make sure we did not miss any data ----------------------------------
-    if (initial_modification_count + 1 != *total_modification_count_)
-    {
-        rt_printf("size: %d, \n other info: %s \n", SIZE, __PRETTY_FUNCTION__);
+    // report the updates the caller did not see ---------------------------
+    update.nb_skipped_ = update.sequence_ - last_sequence - 1;
+    return update;
+}
 
-        rt_printf("something went wrong, we missed a message.\n");
-        exit(-1);
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+bool SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::wait_for_update_until(
+    const size_t& index,
+    const std::chrono::steady_clock::time_point& deadline,
+    ThreadsafeUpdate& update,
+    size_t last_sequence) const
+{
+    // wait until the datum is modified or the deadline -------------------
+    if (last_sequence == ThreadsafeUpdate::CURRENT_SEQUENCE)
+    {
+        last_sequence = shared_->slots_[index].sequence_.get();
+    }
+    uint64_t sequence;
+    if (!shared_->slots_[index].sequence_.wait_until(
+            last_sequence, deadline, sequence))
+    {
+        return false;
     }
 
-    // figure out which index was modified and return it -------------------
-    int modified_index = -1;
-    for (size_t i = 0; i < SIZE; i++)
+    // report the updates the caller did not see ---------------------------
+    update.index_ = index;
+    update.sequence_ = sequence;
+    update.nb_skipped_ = update.sequence_ - last_sequence - 1;
+    return true;
+}
+
+template <typename Type, size_t SIZE, ThreadsafeLayout LAYOUT>
+ThreadsafeUpdate
+SingletypeThreadsafeObject<Type, SIZE, LAYOUT>::wait_for_any_update(
+    size_t last_total_sequence) const
+{
+    // wait until any datum is modified ------------------------------------
+    if (last_total_sequence == ThreadsafeUpdate::CURRENT_SEQUENCE)
     {
-        if (initial_modification_counts[i] + 1 == (*modification_counts_)[i])
-        {
-            if (modified_index != -1)
-            {
-                rt_printf(
-                    "something in the threadsafe object "
-                    "went horribly wrong\n");
-                exit(-1);
-            }
-
-            modified_index = i;
-        }
-        else if (initial_modification_counts[i] != (*modification_counts_)[i])
-        {
-            rt_printf(
-                "something in the threadsafe object "
-                "went horribly wrong\n");
-            exit(-1);
-        }
+        last_total_sequence = shared_->total_modification_count_.get();
     }
-    return modified_index;
+    ThreadsafeUpdate update;
+    update.sequence_ =
+        shared_->total_modification_count_.wait(last_total_sequence);
+    update.index_ =
+        shared_->last_modified_index_.load(std::memory_order_relaxed);
+
+    // report the updates the caller did not see ---------------------------
+    update.nb_skipped_ = update.sequence_ - last_total_sequence - 1;
+    return update;
 }
 
 // ========================================================================== //
@@ -159,27 +240,20 @@ template <typename... Types>
 ThreadsafeObject<Types...>::ThreadsafeObject()
 {
     // initialize shared pointers ------------------------------------------
-    data_ = std::make_shared<std::tuple<Types...>>();
-    condition_ = std::make_shared<std::condition_variable>();
-    condition_mutex_ = std::make_shared<std::mutex>();
-    modification_counts_ = std::make_shared<std::array<size_t, SIZE>>();
-    total_modification_count_ = std::make_shared<size_t>();
-    data_mutexes_ = std::make_shared<std::array<std::mutex, SIZE>>();
-
-    // initialize counts ---------------------------------------------------
-    for (size_t i = 0; i < SIZE; i++)
-    {
-        (*modification_counts_)[i] = 0;
-    }
-    *total_modification_count_ = 0;
+    data_ = std::make_shared<std::tuple<ThreadsafeStorage<Types>...>>();
+    modification_counts_ =
+        std::make_shared<std::array<ThreadsafeSequence, SIZE>>();
+    total_modification_count_ = std::make_shared<ThreadsafeSequence>();
+    last_modified_index_ = std::make_shared<std::atomic<size_t>>(0);
+    write_counter_ = std::make_shared<ThreadsafeWriteCounter>();
+    transaction_mutex_ = std::make_shared<std::mutex>();
 }
 
 template <class... Types>
 template <int INDEX>
 typename ThreadsafeObject<Types...>::template Type<INDEX> ThreadsafeObject<Types...>::get() const
 {
-    std::unique_lock<std::mutex> lock((*data_mutexes_)[INDEX]);
-    return std::get<INDEX>(*data_);
+    return std::get<INDEX>(*data_).get();
 }
 
 /**
@@ -190,94 +264,117 @@ template <int INDEX>
 void ThreadsafeObject<Types...>::set(
     ThreadsafeObject<Types...>::Type<INDEX> datum)
 {
-    // we sleep for a nanosecond, in case some thread calls set several
-    // times in a row. this way we do hopefully not miss messages
-    real_time_tools::Timer::sleep_sec(1e-9);
-    // set datum in our data_ member ---------------------------------------
-    {
-        std::unique_lock<std::mutex> lock((*data_mutexes_)[INDEX]);
-        std::get<INDEX>(*data_) = datum;
-    }
+    // move datum in our data_ member, not a transaction of get_many() ---
+    std::get<INDEX>(*data_).set(std::move(datum));
 
-    // notify --------------------------------------------------------------
+    // notify the threads waiting for this index and for any index --------
+    last_modified_index_->store(INDEX, std::memory_order_relaxed);
+    (*modification_counts_)[INDEX].increment();
+    total_modification_count_->increment();
+}
+
+template <class... Types>
+template <int INDEX, typename... Args>
+void ThreadsafeObject<Types...>::emplace(Args&&... args)
+{
+    // construct the datum before get_many() readers have to wait for it ---
+    set<INDEX>(Type<INDEX>(std::forward<Args>(args)...));
+}
+
+template <class... Types>
+template <int... INDEXES>
+std::tuple<typename ThreadsafeObject<Types...>::template Type<INDEXES>...>
+ThreadsafeObject<Types...>::get_many() const
+{
+    std::tuple<Type<INDEXES>...> data;
+    uint64_t nb_writes;
+    do
     {
-        std::unique_lock<std::mutex> lock(*condition_mutex_);
-        (*modification_counts_)[INDEX] += 1;
-        *total_modification_count_ += 1;
-        condition_->notify_all();
-    }
+        nb_writes = write_counter_->begin_read();
+        data = std::make_tuple(std::get<INDEXES>(*data_).get()...);
+    } while (!write_counter_->validate_read(nb_writes));
+    return data;
 }
 
 template <class... Types>
-void ThreadsafeObject<Types...>::wait_for_update(unsigned index) const
+template <int... INDEXES>
+void ThreadsafeObject<Types...>::set_many(const Type<INDEXES>&... data)
 {
-    std::unique_lock<std::mutex> lock(*condition_mutex_);
+    static_assert(sizeof...(INDEXES) > 0, "set_many() needs an index");
+    std::unique_lock<std::mutex> lock(*transaction_mutex_);
+
+    // set all the data in our data_ member --------------------------------
+    write_counter_->begin_write();
+    (std::get<INDEXES>(*data_).set(data), ...);
+    write_counter_->end_write();
+
+    // notify the threads waiting for these indexes, then the threads
+    // waiting for any index once -------------------------------------------
+    (last_modified_index_->store(INDEXES, std::memory_order_relaxed), ...);
+    ((*modification_counts_)[INDEXES].increment(), ...);
+    total_modification_count_->increment();
+}
 
+template <class... Types>
+ThreadsafeUpdate ThreadsafeObject<Types...>::wait_for_update(
+    unsigned index, size_t last_sequence) const
+{
     // wait until the datum with the right index is modified ---------------
-    size_t initial_modification_count = (*modification_counts_)[index];
-    while (initial_modification_count == (*modification_counts_)[index])
+    if (last_sequence == ThreadsafeUpdate::CURRENT_SEQUENCE)
     {
-        condition_->wait(lock);
+        last_sequence = (*modification_counts_)[index].get();
     }
+    ThreadsafeUpdate update;
+    update.index_ = index;
+    update.sequence_ = (*modification_counts_)[index].wait(last_sequence);
 
-    // check that we did not miss data -------------------------------------
-    if (initial_modification_count + 1 != (*modification_counts_)[index])
-    {
-        rt_printf("size: %d, \n other info: %s \n", SIZE, __PRETTY_FUNCTION__);
-        rt_printf("something went wrong, we missed a message.\n");
-        exit(-1);
-    }
+    // report the updates the caller did not see ---------------------------
+    update.nb_skipped_ = update.sequence_ - last_sequence - 1;
+    return update;
 }
 
 template <class... Types>
-size_t ThreadsafeObject<Types...>::wait_for_update() const
+bool ThreadsafeObject<Types...>::wait_for_update_until(
+    unsigned index,
+    const std::chrono::steady_clock::time_point& deadline,
+    ThreadsafeUpdate& update,
+    size_t last_sequence) const
 {
-    std::unique_lock<std::mutex> lock(*condition_mutex_);
-
-    // wait until any datum is modified ------------------------------------
-    std::array<size_t, SIZE> initial_modification_counts =
-        *modification_counts_;
-    size_t initial_modification_count = *total_modification_count_;
-
-    while (initial_modification_count == *total_modification_count_)
+    // wait until the datum is modified or the deadline -------------------
+    if (last_sequence == ThreadsafeUpdate::CURRENT_SEQUENCE)
     {
-        condition_->wait(lock);
+        last_sequence = (*modification_counts_)[index].get();
     }
-
-    // make sure we did not miss any data ----------------------------------
-    if (initial_modification_count + 1 != *total_modification_count_)
+    uint64_t sequence;
+    if (!(*modification_counts_)[index].wait_until(
+            last_sequence, deadline, sequence))
     {
-        rt_printf("size: %d, \n other info: %s \n", SIZE, __PRETTY_FUNCTION__);
-
-        rt_printf("something went wrong, we missed a message.\n");
-        exit(-1);
+        return false;
     }
 
-    // figure out which index was modified and return it -------------------
-    int modified_index = -1;
-    for (size_t i = 0; i < SIZE; i++)
+    // report the updates the caller did not see ---------------------------
+    update.index_ = index;
+    update.sequence_ = sequence;
+    update.nb_skipped_ = update.sequence_ - last_sequence - 1;
+    return true;
+}
+
+template <class... Types>
+ThreadsafeUpdate ThreadsafeObject<Types...>::wait_for_any_update(
+    size_t last_total_sequence) const
+{
+    // wait until any datum is modified ------------------------------------
+    if (last_total_sequence == ThreadsafeUpdate::CURRENT_SEQUENCE)
     {
-        if (initial_modification_counts[i] + 1 == (*modification_counts_)[i])
-        {
-            if (modified_index != -1)
-            {
-                rt_printf(
-                    "something in the threadsafe object "
-                    "went horribly wrong\n");
-                exit(-1);
-            }
-
-            modified_index = i;
-        }
-        else if (initial_modification_counts[i] != (*modification_counts_)[i])
-        {
-            rt_printf(
-                "something in the threadsafe object "
-                "went horribly wrong\n");
-            exit(-1);
-        }
+        last_total_sequence = total_modification_count_->get();
     }
-    return modified_index;
+    ThreadsafeUpdate update;
+    update.sequence_ = total_modification_count_->wait(last_total_sequence);
+    update.index_ = last_modified_index_->load(std::memory_order_relaxed);
+
+    // report the updates the caller did not see ---------------------------
+    update.nb_skipped_ = update.sequence_ - last_total_sequence - 1;
+    return update;
 }
 
 }  // namespace real_time_tools
\ No newline at end of file
@@ -0,0 +1,621 @@
+/**
+ * @file threadsafe_storage.hpp
+ * @brief This file declares the storage of one datum of the threadsafe
+ * objects: a mutex protected copy or a seqlock, the sequence numbers used to
+ * wait for the updates, the write counter used for consistent snapshots and
+ * the slots gathering a datum and its sequence number.
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "real_time_tools/futex.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Select the seqlock storage for a type stored in a
+ * SingletypeThreadsafeObject or a ThreadsafeObject. False by default, the
+ * data is then protected by a mutex.
+ *
+ * Specialize it for types that can be copied with memcpy (plain structs of
+ * numbers, fixed size Eigen matrices):
+ * @code
+ * namespace real_time_tools
+ * {
+ * template <>
+ * struct use_seqlock_storage<Eigen::Matrix3d> : std::true_type
+ * {
+ * };
+ * }
+ * @endcode
+ *
+ * @tparam Type is the stored type.
+ */
+template <typename Type>
+struct use_seqlock_storage : std::false_type
+{
+};
+
+/**
+ * @brief Storage of one datum of the threadsafe objects. This default
+ * version protects the datum with a mutex, so a slow reader can block the
+ * writer.
+ *
+ * @tparam Type is the stored type.
+ * @tparam SEQLOCK selects the seqlock version.
+ */
+template <typename Type, bool SEQLOCK = use_seqlock_storage<Type>::value>
+class ThreadsafeStorage
+{
+public:
+    /**
+     * @brief Get a copy of the datum.
+     *
+     * @return Type
+     */
+    Type get() const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return datum_;
+    }
+
+    /**
+     * @brief Set the datum.
+     *
+     * @param datum
+     */
+    void set(const Type& datum)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        datum_ = datum;
+    }
+
+    /**
+     * @brief Move the datum in, without copying its content.
+     *
+     * @param datum
+     */
+    void set(Type&& datum)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        datum_ = std::move(datum);
+    }
+
+    /**
+     * @brief Set the datum unless a reader holds the mutex, never waits.
+     *
+     * @param datum
+     * @return true if the datum was set.
+     */
+    bool try_set(const Type& datum)
+    {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            return false;
+        }
+        datum_ = datum;
+        return true;
+    }
+
+    /**
+     * @brief Construct the datum from args, then move it in. The
+     * construction happens before taking the mutex, so the readers are not
+     * blocked meanwhile.
+     *
+     * @tparam Args
+     * @param args are the arguments of a constructor of Type.
+     */
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        Type datum(std::forward<Args>(args)...);
+        set(std::move(datum));
+    }
+
+    /**
+     * @brief Call a function on the datum, without copying it. The mutex is
+     * held during the call, so the callable must be short and must not keep
+     * a reference to the datum.
+     *
+     * @tparam Callable
+     * @param callable is called with a const Type&.
+     * @return what the callable returns.
+     */
+    template <typename Callable>
+    auto read(Callable&& callable) const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return std::forward<Callable>(callable)(datum_);
+    }
+
+private:
+    /**
+     * @brief The datum.
+     */
+    Type datum_;
+    /**
+     * @brief Protects the datum.
+     */
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief Seqlock storage of one datum of the threadsafe objects.
+ *
+ * The writer increments a sequence number before and after copying the
+ * datum, readers copy the datum and retry if the sequence number was odd or
+ * has changed meanwhile (torn read). Readers never block the writer. The
+ * datum is kept as an array of atomic words so that the concurrent copies
+ * are not data races.
+ *
+ * Concurrent writers are serialized by a mutex that the readers never take.
+ * This storage contains no pointer, so it can live in memory shared between
+ * processes.
+ *
+ * @tparam Type is the stored type, it must be copyable with memcpy.
+ */
+template <typename Type>
+class ThreadsafeStorage<Type, true>
+{
+public:
+    static_assert(std::is_default_constructible<Type>::value,
+                  "the seqlock storage needs a default constructible type");
+
+    /**
+     * @brief Construct a new ThreadsafeStorage object holding a default
+     * constructed datum.
+     */
+    ThreadsafeStorage() : sequence_(0)
+    {
+        set(Type());
+    }
+
+    /**
+     * @brief Get a copy of the datum, retrying until the copy is not torn.
+     *
+     * @return Type
+     */
+    Type get() const
+    {
+        Word words[NB_WORDS];
+        uint64_t sequence_before, sequence_after;
+        do
+        {
+            sequence_before = sequence_.load(std::memory_order_acquire);
+            if (sequence_before % 2 == 1)
+            {
+                cpu_relax();
+                continue;
+            }
+            for (std::size_t i = 0; i < NB_WORDS; ++i)
+            {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            sequence_after = sequence_.load(std::memory_order_relaxed);
+        } while (sequence_before % 2 == 1 || sequence_before != sequence_after);
+
+        Type datum;
+        std::memcpy(static_cast<void*>(&datum), words, sizeof(Type));
+        return datum;
+    }
+
+    /**
+     * @brief Set the datum, never waits for the readers.
+     *
+     * @param datum
+     */
+    void set(const Type& datum)
+    {
+        Word words[NB_WORDS] = {};
+        std::memcpy(words, static_cast<const void*>(&datum), sizeof(Type));
+
+        std::unique_lock<FutexMutex> lock(writer_mutex_);
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < NB_WORDS; ++i)
+        {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Set the datum. The readers never block the writer, so this
+     * only waits for concurrent writers.
+     *
+     * @param datum
+     * @return true, the datum is always set.
+     */
+    bool try_set(const Type& datum)
+    {
+        set(datum);
+        return true;
+    }
+
+    /**
+     * @brief Construct the datum from args and set it.
+     *
+     * @tparam Args
+     * @param args are the arguments of a constructor of Type.
+     */
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        set(Type(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Call a function on a consistent copy of the datum. The words
+     * of the datum may change during a read, so the callable never sees
+     * them directly: the copy is on the stack and the writer is never
+     * blocked.
+     *
+     * @tparam Callable
+     * @param callable is called with a const Type&.
+     * @return what the callable returns.
+     */
+    template <typename Callable>
+    auto read(Callable&& callable) const
+    {
+        const Type datum = get();
+        return std::forward<Callable>(callable)(datum);
+    }
+
+    /**
+     * @brief Let writers of different processes share this storage, when it
+     * lives in shared memory.
+     *
+     * @param process_shared
+     */
+    void set_process_shared(bool process_shared)
+    {
+        writer_mutex_.set_process_shared(process_shared);
+    }
+
+private:
+    /**
+     * @brief Unit of the copies.
+     */
+    typedef uint64_t Word;
+
+    /**
+     * @brief Number of words needed to hold the datum.
+     */
+    static const std::size_t NB_WORDS =
+        (sizeof(Type) + sizeof(Word) - 1) / sizeof(Word);
+
+    /**
+     * @brief Odd while the datum is being written.
+     */
+    std::atomic<uint64_t> sequence_;
+    /**
+     * @brief The datum.
+     */
+    std::atomic<Word> words_[NB_WORDS];
+    /**
+     * @brief Serializes the writers.
+     */
+    FutexMutex writer_mutex_;
+};
+
+/**
+ * @brief Sequence number of the updates of one datum of the threadsafe
+ * objects, with a futex to wait for the next one.
+ *
+ * Waiting threads sleep on a futex word dedicated to this sequence, so an
+ * update only wakes up the threads waiting for it. Waiters do not enter the
+ * kernel if the update is already there, and writers do not enter it if
+ * nobody waits.
+ */
+class ThreadsafeSequence
+{
+public:
+    /**
+     * @brief Construct a new ThreadsafeSequence object at sequence 0.
+     */
+    ThreadsafeSequence()
+        : sequence_(0), futex_word_(0), nb_waiters_(0), process_shared_(false)
+    {
+    }
+
+    /**
+     * @brief Let threads of different processes wait for this sequence,
+     * when it lives in shared memory.
+     *
+     * @param process_shared
+     */
+    void set_process_shared(bool process_shared)
+    {
+        process_shared_ = process_shared;
+    }
+
+    /**
+     * @brief Get the current sequence number.
+     *
+     * @return uint64_t the number of updates so far.
+     */
+    uint64_t get() const
+    {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Count an update and wake up the waiting threads. The data
+     * written before is visible to the threads that see the new sequence.
+     *
+     * @return uint64_t the new sequence number.
+     */
+    uint64_t increment()
+    {
+        uint64_t sequence = sequence_.fetch_add(1) + 1;
+        // seq_cst, paired with wait(): either the waiter registered before
+        // and we wake it up, or it reads the new futex word and does not
+        // sleep.
+        futex_word_.fetch_add(1);
+        if (nb_waiters_.load() > 0)
+        {
+            futex_wake(futex_word_, INT32_MAX, process_shared_);
+        }
+        return sequence;
+    }
+
+    /**
+     * @brief Wait until the sequence number is larger than last_sequence.
+     *
+     * @param last_sequence is the last sequence number seen by the caller.
+     * @return uint64_t the new sequence number.
+     */
+    uint64_t wait(uint64_t last_sequence) const
+    {
+        uint64_t sequence;
+        wait_until(last_sequence, nullptr, sequence);
+        return sequence;
+    }
+
+    /**
+     * @brief Wait until the sequence number is larger than last_sequence or
+     * until a deadline. Does not read the clock if the update is already
+     * there.
+     *
+     * @param last_sequence is the last sequence number seen by the caller.
+     * @param deadline is a date of std::chrono::steady_clock, which is
+     * CLOCK_MONOTONIC on linux.
+     * @param sequence is set to the current sequence number.
+     * @return true if the sequence number is larger than last_sequence.
+     * @return false if the deadline was reached first.
+     */
+    bool wait_until(uint64_t last_sequence,
+                    const std::chrono::steady_clock::time_point& deadline,
+                    uint64_t& sequence) const
+    {
+        return wait_until(last_sequence, &deadline, sequence);
+    }
+
+private:
+    /**
+     * @brief Implementation of the waits, without deadline if it is
+     * nullptr.
+     *
+     * @param last_sequence
+     * @param deadline
+     * @param sequence
+     * @return true if the sequence number is larger than last_sequence.
+     */
+    bool wait_until(uint64_t last_sequence,
+                    const std::chrono::steady_clock::time_point* deadline,
+                    uint64_t& sequence) const
+    {
+        sequence = get();
+        if (sequence > last_sequence)
+        {
+            return true;
+        }
+        struct timespec deadline_spec = {0, 0};
+        if (deadline != nullptr)
+        {
+            int64_t deadline_ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    deadline->time_since_epoch())
+                    .count();
+            deadline_spec.tv_sec = deadline_ns / 1000000000;
+            deadline_spec.tv_nsec = deadline_ns % 1000000000;
+        }
+        bool updated = true;
+        nb_waiters_.fetch_add(1);
+        while (true)
+        {
+            uint32_t futex_word = futex_word_.load();
+            sequence = get();
+            if (sequence > last_sequence)
+            {
+                break;
+            }
+            // the clock is only read before going to sleep.
+            if (deadline != nullptr &&
+                std::chrono::steady_clock::now() >= *deadline)
+            {
+                updated = false;
+                break;
+            }
+            futex_wait(futex_word_,
+                       futex_word,
+                       deadline != nullptr ? &deadline_spec : nullptr,
+                       process_shared_);
+        }
+        nb_waiters_.fetch_sub(1);
+        return updated;
+    }
+
+    /**
+     * @brief Number of updates.
+     */
+    std::atomic<uint64_t> sequence_;
+    /**
+     * @brief Incremented after the sequence, the waiters sleep on it.
+     */
+    mutable std::atomic<uint32_t> futex_word_;
+    /**
+     * @brief Number of threads in wait().
+     */
+    mutable std::atomic<uint32_t> nb_waiters_;
+    /**
+     * @brief Are the futex operations shared between processes?
+     */
+    bool process_shared_;
+};
+
+/**
+ * @brief Memory layout of the data of a SingletypeThreadsafeObject.
+ */
+enum class ThreadsafeLayout
+{
+    /**
+     * @brief The slots are packed, neighbouring slots may share cache lines.
+     */
+    COMPACT,
+    /**
+     * @brief Every slot starts on its own cache line, writers of different
+     * indexes do not invalidate each other's cache lines (no false sharing)
+     * at the cost of some padding.
+     */
+    CACHE_ALIGNED
+};
+
+/**
+ * @brief One datum of a SingletypeThreadsafeObject with its lock (in the
+ * storage) and its sequence number, next to each other in memory.
+ *
+ * @tparam Type is the stored type.
+ * @tparam LAYOUT aligns the slot on a cache line if CACHE_ALIGNED.
+ */
+template <typename Type, ThreadsafeLayout LAYOUT>
+struct alignas(ThreadsafeStorage<Type>)
+    alignas(LAYOUT == ThreadsafeLayout::CACHE_ALIGNED
+                ? 64
+                : alignof(ThreadsafeSequence)) ThreadsafeSlot
+{
+    /**
+     * @brief The datum and its lock.
+     */
+    ThreadsafeStorage<Type> storage_;
+    /**
+     * @brief The number of updates of the datum.
+     */
+    ThreadsafeSequence sequence_;
+};
+
+/**
+ * @brief Counts the writes of the threadsafe objects that are started and
+ * done, so that readers can check that no write happened while they were
+ * copying several data.
+ *
+ * Writers call begin_write() before modifying any datum and end_write()
+ * after. Readers call begin_read(), copy the data and retry while
+ * validate_read() returns false. Several writers may run at once, readers
+ * never block them. A reader that finds a write in progress spins a little,
+ * then sleeps until the write is done.
+ */
+class ThreadsafeWriteCounter
+{
+public:
+    /**
+     * @brief Construct a new ThreadsafeWriteCounter object.
+     */
+    ThreadsafeWriteCounter() : nb_started_(0), nb_done_(0)
+    {
+    }
+
+    /**
+     * @brief To call before modifying the data.
+     */
+    void begin_write()
+    {
+        nb_started_.fetch_add(1);
+    }
+
+    /**
+     * @brief To call after modifying the data. Only enters the kernel when
+     * a reader sleeps in begin_read().
+     */
+    void end_write()
+    {
+        nb_done_.fetch_add(1);
+        write_done_.notify_all();
+    }
+
+    /**
+     * @brief Wait until no write is in progress: spin for short writes,
+     * sleep on a futex for the long ones or when the writer was preempted.
+     *
+     * @return uint64_t the number of writes started, to give to
+     * validate_read().
+     */
+    uint64_t begin_read() const
+    {
+        uint64_t nb_started = 0;
+        auto no_write_in_progress = [this, &nb_started]() {
+            // nb_done_ first: if both are equal, no write was in progress
+            // when nb_started_ was read.
+            uint64_t nb_done = nb_done_.load();
+            nb_started = nb_started_.load();
+            return nb_started == nb_done;
+        };
+        for (int i = 0; i < NB_SPINS; ++i)
+        {
+            if (no_write_in_progress())
+            {
+                return nb_started;
+            }
+            cpu_relax();
+        }
+        write_done_.wait(no_write_in_progress);
+        return nb_started;
+    }
+
+    /**
+     * @brief Check that no write started since begin_read().
+     *
+     * @param nb_started is the value returned by begin_read().
+     * @return true if the data copied since begin_read() is consistent.
+     */
+    bool validate_read(uint64_t nb_started) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return nb_started_.load() == nb_started;
+    }
+
+private:
+    /**
+     * @brief Number of checks begin_read() spins for before sleeping.
+     */
+    static constexpr int NB_SPINS = 100;
+    /**
+     * @brief Number of begin_write() calls.
+     */
+    std::atomic<uint64_t> nb_started_;
+    /**
+     * @brief Number of end_write() calls.
+     */
+    std::atomic<uint64_t> nb_done_;
+    /**
+     * @brief Notified by end_write(), the readers sleep on it.
+     */
+    mutable FutexCondition write_done_;
+};
+
+}  // namespace real_time_tools
@@ -0,0 +1,170 @@
+/**
+ * @file triple_buffer.hpp
+ * @brief This file declares a wait-free triple buffer to hand large objects
+ * from one writer to one reader without copies.
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace real_time_tools
+{
+/**
+ * @brief Wait-free triple buffer between one writer thread and one reader
+ * thread.
+ *
+ * The writer fills the back buffer in place and publishes it, which swaps it
+ * with the middle buffer through a single atomic exchange. The reader swaps
+ * the middle buffer with its front buffer when something new was published
+ * and reads the front buffer by reference. No lock is taken and no copy is
+ * made in the handoff, the reader always sees the latest complete value and
+ * intermediate values are dropped.
+ *
+ * Each buffer sits on its own cache lines so that the writer and the reader
+ * do not share any line but the atomic state.
+ *
+ * Example:
+ * @snippet demo_triple_buffer.cpp Usage of TripleBuffer
+ *
+ * @tparam Type is the type of the buffers, it is never copied by the
+ * buffer itself.
+ */
+template <typename Type>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Construct a new TripleBuffer object with value initialized
+     * buffers.
+     */
+    TripleBuffer();
+
+    /**
+     * @brief Construct a new TripleBuffer object with the three buffers
+     * initialized to the same value, e.g. to pre-allocate dynamic objects.
+     *
+     * @param initial_value
+     */
+    explicit TripleBuffer(const Type& initial_value);
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    TripleBuffer(const TripleBuffer& other) = delete;
+
+    /**
+     * Writer side.
+     */
+
+    /**
+     * @brief Get the buffer to fill before publish(). Its content is the
+     * one of an older value, not necessarily the last published one.
+     *
+     * @return Type&
+     */
+    Type& get_back_buffer()
+    {
+        return buffers_[back_].value_;
+    }
+
+    /**
+     * @brief Publish the back buffer and get a new one.
+     */
+    void publish();
+
+    /**
+     * @brief Copy a value in the back buffer and publish it.
+     *
+     * @param datum
+     */
+    void set(const Type& datum)
+    {
+        get_back_buffer() = datum;
+        publish();
+    }
+
+    /**
+     * Reader side.
+     */
+
+    /**
+     * @brief Has a value been published since the last update()?
+     *
+     * @return true if update() would change the front buffer.
+     */
+    bool has_update() const
+    {
+        return (state_.load(std::memory_order_relaxed) & NEW_DATA) != 0;
+    }
+
+    /**
+     * @brief Get the latest published value in the front buffer.
+     *
+     * @return true if a new value was published since the last call.
+     */
+    bool update();
+
+    /**
+     * @brief Get the front buffer, valid until the next update().
+     *
+     * @return const Type&
+     */
+    const Type& get_front_buffer() const
+    {
+        return buffers_[front_].value_;
+    }
+
+    /**
+     * @brief update() and get the front buffer.
+     *
+     * @return const Type& the latest published value.
+     */
+    const Type& get()
+    {
+        update();
+        return get_front_buffer();
+    }
+
+private:
+    /**
+     * @brief One buffer, aligned on a cache line.
+     */
+    struct alignas(64) Slot
+    {
+        Type value_;
+    };
+
+    /**
+     * @brief Bit of state_ set when the middle buffer holds a value not read
+     * yet, the lower bits hold the index of the middle buffer.
+     */
+    static const uint8_t NEW_DATA = 4;
+
+    /**
+     * @brief The three buffers.
+     */
+    std::array<Slot, 3> buffers_;
+    /**
+     * @brief Index of the middle buffer and NEW_DATA flag.
+     */
+    alignas(64) std::atomic<uint8_t> state_;
+    /**
+     * @brief Index of the buffer owned by the writer.
+     */
+    alignas(64) uint8_t back_;
+    /**
+     * @brief Index of the buffer owned by the reader.
+     */
+    alignas(64) uint8_t front_;
+};
+
+}  // namespace real_time_tools
+
+#include "real_time_tools/threadsafe/triple_buffer.hxx"
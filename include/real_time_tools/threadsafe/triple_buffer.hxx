@@ -0,0 +1,52 @@
+/**
+ * @file triple_buffer.hxx
+ * @brief This file defines the functions from triple_buffer.hpp
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+namespace real_time_tools
+{
+template <typename Type>
+TripleBuffer<Type>::TripleBuffer()
+    : buffers_(), state_(1), back_(0), front_(2)
+{
+}
+
+template <typename Type>
+TripleBuffer<Type>::TripleBuffer(const Type& initial_value)
+    : state_(1), back_(0), front_(2)
+{
+    for (Slot& slot : buffers_)
+    {
+        slot.value_ = initial_value;
+    }
+}
+
+template <typename Type>
+void TripleBuffer<Type>::publish()
+{
+    // release: the content of the back buffer is visible to the reader that
+    // acquires it, acquire: the reader is done with the buffer we get back.
+    uint8_t state = state_.exchange(static_cast<uint8_t>(back_ | NEW_DATA),
+                                    std::memory_order_acq_rel);
+    back_ = state & (NEW_DATA - 1);
+}
+
+template <typename Type>
+bool TripleBuffer<Type>::update()
+{
+    if (!has_update())
+    {
+        return false;
+    }
+    uint8_t state = state_.exchange(front_, std::memory_order_acq_rel);
+    front_ = state & (NEW_DATA - 1);
+    return true;
+}
+
+}  // namespace real_time_tools
@@ -0,0 +1,219 @@
+/**
+ * @file worker_pool.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Pool of pinned real time worker threads for fork-join parallelism
+ * inside a control cycle.
+ */
+
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "real_time_tools/thread.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Fixed pool of real time worker threads, each pinned to one CPU.
+ *
+ * The workers are spawned once by start() (not real time safe). Then
+ * parallel_for() distributes the tasks [0, nb_tasks) among the workers and
+ * the calling thread and returns once all of them are done. parallel_for()
+ * does not allocate nor lock: tasks are claimed with an atomic counter and
+ * the caller spin-waits on the join for at most the spin duration before
+ * sleeping on a futex. Idle workers spin for the same duration waiting for
+ * the next parallel_for() before sleeping.
+ *
+ * parallel_for() must not be called concurrently from several threads.
+ *
+ * Example:
+ * @code
+ * real_time_tools::WorkerPool pool;
+ * pool.start({2, 3});
+ * // in the control loop
+ * pool.parallel_for(4, [&](std::size_t leg) { compute_kinematics(leg); });
+ * @endcode
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief Signature of a task function: it receives the user arguments
+     * and the index of the task to run.
+     */
+    typedef void (*TaskFunction)(void* args, std::size_t task_index);
+
+    /**
+     * @brief Construct a new WorkerPool object without workers.
+     */
+    WorkerPool();
+
+    /**
+     * @brief We do not allow copies of this object.
+     */
+    WorkerPool(const WorkerPool& other) = delete;
+
+    /**
+     * @brief Stop and join the workers.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Spawn one worker per CPU in cpu_ids. Not real time safe.
+     *
+     * @param cpu_ids are the CPUs the workers are pinned to.
+     * @param parameters are the parameters of the worker threads, the
+     * cpu_id_ field is overwritten for each worker.
+     * @return true if all workers could be spawned.
+     * @return false otherwise, in which case no worker is running.
+     */
+    bool start(const std::vector<int>& cpu_ids,
+               const RealTimeThreadParameters& parameters =
+                   RealTimeThreadParameters());
+
+    /**
+     * @brief Stop and join the workers. Not real time safe.
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of worker threads (the calling thread excluded).
+     *
+     * @return std::size_t
+     */
+    std::size_t get_nb_workers() const
+    {
+        return workers_.size();
+    }
+
+    /**
+     * @brief Set how long the workers and the caller of parallel_for()
+     * busy-wait before going to sleep. Spinning keeps the join latency in
+     * the micro-second range but burns the CPU.
+     *
+     * @param spin_duration_sec is the spinning duration in seconds.
+     */
+    void set_spin_duration(double spin_duration_sec)
+    {
+        spin_duration_sec_ = spin_duration_sec;
+    }
+
+    /**
+     * @brief Run task(args, i) for all i in [0, nb_tasks) on the workers and
+     * the calling thread, and wait until all tasks are done. Real time safe.
+     *
+     * @param task is the function to run.
+     * @param args is passed to the task function.
+     * @param nb_tasks is the number of tasks.
+     */
+    void parallel_for(TaskFunction task, void* args, std::size_t nb_tasks);
+
+    /**
+     * @brief Run function(i) for all i in [0, nb_tasks) on the workers and
+     * the calling thread, and wait until all tasks are done. The callable is
+     * not copied, so this does not allocate.
+     *
+     * @tparam Function is a callable taking a std::size_t.
+     * @param nb_tasks is the number of tasks.
+     * @param function is the callable.
+     */
+    template <typename Function>
+    void parallel_for(std::size_t nb_tasks, Function&& function)
+    {
+        typedef typename std::remove_reference<Function>::type FunctionType;
+        parallel_for(&call_function<FunctionType>,
+                     const_cast<void*>(static_cast<const void*>(&function)),
+                     nb_tasks);
+    }
+
+private:
+    /**
+     * @brief Call a callable on a task index.
+     */
+    template <typename FunctionType>
+    static void call_function(void* function, std::size_t task_index)
+    {
+        (*static_cast<FunctionType*>(function))(task_index);
+    }
+
+    /**
+     * @brief Loop of a worker thread.
+     *
+     * @param pool is the WorkerPool.
+     */
+    static THREAD_FUNCTION_RETURN_TYPE worker_loop(void* pool);
+
+    /**
+     * @brief Claim and run tasks of the current job until none is left.
+     */
+    void run_tasks();
+
+    /**
+     * @brief The worker threads.
+     */
+    std::vector<std::unique_ptr<RealTimeThread>> workers_;
+
+    /**
+     * @brief Busy waiting duration before sleeping.
+     */
+    double spin_duration_sec_;
+
+    /**
+     * @brief Incremented by every parallel_for(), workers wait on it.
+     */
+    std::atomic<uint32_t> generation_;
+
+    /**
+     * @brief Number of workers that went to sleep waiting on generation_.
+     */
+    std::atomic<uint32_t> nb_sleeping_workers_;
+
+    /**
+     * @brief Number of workers that did not finish the current job yet.
+     */
+    std::atomic<uint32_t> nb_pending_workers_;
+
+    /**
+     * @brief Is the caller of parallel_for() sleeping on
+     * nb_pending_workers_?
+     */
+    std::atomic<bool> joiner_sleeping_;
+
+    /**
+     * @brief Index of the next task to claim.
+     */
+    std::atomic<std::size_t> next_task_;
+
+    /**
+     * @brief Set by stop() to terminate the workers.
+     */
+    std::atomic<bool> stopping_;
+
+    /**
+     * @brief Task function of the current job.
+     */
+    TaskFunction task_;
+
+    /**
+     * @brief Arguments of the current job.
+     */
+    void* task_args_;
+
+    /**
+     * @brief Number of tasks of the current job.
+     */
+    std::size_t nb_tasks_;
+};
+
+}  // namespace real_time_tools
+
+#endif  // WORKER_POOL_HPP
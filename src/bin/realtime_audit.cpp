@@ -0,0 +1,86 @@
+/**
+ * @file realtime_audit.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Program: check that a machine is configured for real time before a
+ * deployment.
+ *
+ * Usage: realtime_audit [--root <dir>] [--priority <N>] <rt cpu list>...
+ *
+ * The exit code is 0 if every check passed, 1 if some checks raised a warning
+ * and 2 if some checks failed.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "real_time_tools/process_manager.hpp"
+#include "real_time_tools/realtime_audit.hpp"
+
+/** @brief Display the usage of the program. */
+static void print_usage(const char* program)
+{
+    std::cout << "usage: " << program
+              << " [--root <dir>] [--priority <N>] <rt cpu list>...\n"
+              << "  --root <dir>     audit <dir>/proc and <dir>/sys instead "
+                 "of /proc and /sys\n"
+              << "  --priority <N>   priority of the real time threads "
+                 "(default 80)\n"
+              << "  <rt cpu list>    CPUs running the real time threads, "
+                 "e.g. 2-3 5\n"
+              << "exit code: 0 all passed, 1 warnings, 2 failures\n";
+}
+
+/** @brief Parse the arguments, run the audit and print the report. */
+int main(int argc, char* argv[])
+{
+    real_time_tools::RealTimeAuditParameters parameters;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--root") == 0 && i + 1 < argc)
+        {
+            std::string root = argv[++i];
+            parameters.proc_root_ = root + "/proc";
+            parameters.sys_root_ = root + "/sys";
+        }
+        else if (std::strcmp(argv[i], "--priority") == 0 && i + 1 < argc)
+        {
+            parameters.priority_ = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-h") == 0 ||
+                 std::strcmp(argv[i], "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::vector<int> cpus = real_time_tools::parse_cpu_list(argv[i]);
+            if (cpus.empty())
+            {
+                print_usage(argv[0]);
+                return 2;
+            }
+            parameters.rt_cpu_ids_.insert(
+                parameters.rt_cpu_ids_.end(), cpus.begin(), cpus.end());
+        }
+    }
+    parameters.rt_cpu_ids_ = real_time_tools::parse_cpu_list(
+        real_time_tools::format_cpu_list(parameters.rt_cpu_ids_));
+
+    real_time_tools::RealTimeAudit audit(parameters);
+    audit.run();
+    audit.print();
+    switch (audit.get_status())
+    {
+        case real_time_tools::AuditStatus::PASS:
+            return 0;
+        case real_time_tools::AuditStatus::WARN:
+            return 1;
+        case real_time_tools::AuditStatus::FAIL:
+            return 2;
+    }
+    return 2;
+}
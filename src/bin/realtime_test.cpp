@@ -9,14 +9,14 @@
  * @brief Program: test the real time capabilities of a machine
  */
 
-#include "real_time_tools/realtime_test.hpp"
+#include "realtime_test.hpp"
 #include <signal.h>
 #include <atomic>
+#include <iostream>
 #include <memory>
 #include "real_time_tools/realtime_check.hpp"
 #include "real_time_tools/spinner.hpp"
 #include "real_time_tools/thread.hpp"
-#include "shared_memory/shared_memory.hpp"
 
 /** @brief valid modes, creating subclasses of Computation to add new ones
  * (see below)*/
@@ -25,6 +25,9 @@ static int MATRIX_COMPUTATION_NO_EIGEN_64 = 1;
 /** @brief Is the thread running? */
 std::atomic<bool> RUNNING;
 
+/** @brief The statistics shared with realtime_test_display. */
+RealtimeTestObject STATISTICS;
+
 /** @brief Configuration of the test thread */
 class Configuration
 {
@@ -127,7 +130,7 @@ private:
 
 /** @brief This is the real time thread that perform the check and the
  * computations */
-void* thread_function(void* v)
+THREAD_FUNCTION_RETURN_TYPE thread_function(void* v)
 {
     Configuration* config = (Configuration*)(v);
 
@@ -145,15 +148,7 @@ void* thread_function(void* v)
 
     RUNNING = true;
 
-    int ticks, switchs;
-    double target_frequency, switch_frequency;
-    double average_frequency, current_frequency, worse_frequency;
-
-    double shared[7];
-    for (int i = 0; i < 7; i++)
-    {
-        shared[i] = 0.0;
-    }
+    RealtimeTestStatistics statistics;
 
     while (RUNNING.load())
     {
@@ -164,28 +159,21 @@ void* thread_function(void* v)
         checker.tick();
 
         // getting observed frequencies
-        checker.get_statistics(ticks,
-                               switchs,
-                               target_frequency,
-                               switch_frequency,
-                               average_frequency,
-                               current_frequency,
-                               worse_frequency);
+        checker.get_statistics(statistics.ticks,
+                               statistics.switchs,
+                               statistics.target_frequency,
+                               statistics.switch_frequency,
+                               statistics.average_frequency,
+                               statistics.current_frequency,
+                               statistics.worse_frequency);
 
         // putting observed frequency in shared memory
-        shared[0] = static_cast<double>(ticks);
-        shared[1] = static_cast<double>(switchs);
-        shared[2] = target_frequency;
-        shared[3] = switch_frequency;
-        shared[4] = average_frequency;
-        shared[5] = current_frequency;
-        shared[6] = worse_frequency;
-        shared_memory::set(
-            REALTIME_TEST_SEGMENT_ID, REALTIME_TEST_OBJECT_ID, shared, 7);
+        STATISTICS.set(statistics);
 
         // trying to run at desired frequency
         spinner.spin();
     }
+    return THREAD_FUNCTION_RETURN_VALUE;
 }
 
 /** @brief Display the usage in case of a miss-use. */
@@ -221,13 +209,6 @@ bool set_config(int nb_args, char** args, Configuration& config)
     return true;
 }
 
-/** @brief Delete the shared memeory */
-void clean_memory()
-{
-    shared_memory::delete_segment(REALTIME_TEST_SEGMENT_ID);
-    shared_memory::clear_shared_memory(REALTIME_TEST_OBJECT_ID);
-}
-
 /** @brief stop the current thread. This method is called throw a "ctrl+c" */
 void stop(int)
 {
@@ -238,9 +219,6 @@ void stop(int)
  * time thread. */
 int main(int nb_args, char** argv)
 {
-    // in case not correctly cleaned during previous run
-    clean_memory();
-
     // exit on ctrl+c
     struct sigaction stopping;
     stopping.sa_handler = stop;
@@ -252,17 +230,16 @@ int main(int nb_args, char** argv)
     Configuration config;
     bool ok = set_config(nb_args, argv, config);
 
-    if (ok)
+    // the segment is removed when STATISTICS is destroyed, and replaced if
+    // a previous run crashed.
+    if (ok &&
+        STATISTICS.create_shared_memory(REALTIME_TEST_SEGMENT_NAME, true))
     {
         std::cout << "\n\nctrl-c for exiting\n";
         std::cout << "run realtime_test_display to see stats\n";
 
         real_time_tools::RealTimeThread thread;
-        real_time_tools::block_memory();
-        real_time_tools::create_realtime_thread(
-            thread, thread_function, &config);
-        real_time_tools::join_thread(thread);
-
-        clean_memory();
+        thread.create_realtime_thread(thread_function, &config);
+        thread.join();
     }
 }
@@ -0,0 +1,50 @@
+/**
+ * @file realtime_test.hpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Statistics shared by realtime_test and realtime_test_display.
+ */
+
+#ifndef REALTIME_TEST_HPP
+#define REALTIME_TEST_HPP
+
+#include "real_time_tools/threadsafe/threadsafe_object.hpp"
+
+/** @brief Name of the shared memory segment holding the statistics. */
+#define REALTIME_TEST_SEGMENT_NAME "real_time_tools_realtime_test"
+
+/** @brief Statistics of the real time thread of realtime_test. */
+struct RealtimeTestStatistics
+{
+    /** @brief Number of ticks. */
+    int ticks;
+    /** @brief Number of times real time was lost. */
+    int switchs;
+    /** @brief Frequency the thread tries to achieve. */
+    double target_frequency;
+    /** @brief Frequency below which real time is lost. */
+    double switch_frequency;
+    /** @brief Average frequency. */
+    double average_frequency;
+    /** @brief Frequency of the last tick. */
+    double current_frequency;
+    /** @brief Lowest frequency. */
+    double worse_frequency;
+};
+
+namespace real_time_tools
+{
+/** @brief The statistics are shared through a seqlock. */
+template <>
+struct use_seqlock_storage<RealtimeTestStatistics> : std::true_type
+{
+};
+}  // namespace real_time_tools
+
+/** @brief The statistics in shared memory. */
+typedef real_time_tools::SingletypeThreadsafeObject<RealtimeTestStatistics, 1>
+    RealtimeTestObject;
+
+#endif  // REALTIME_TEST_HPP
@@ -10,9 +10,9 @@
  */
 
 #include <signal.h>
-#include "real_time_tools/realtime_test.hpp"
+#include <iostream>
 #include "real_time_tools/spinner.hpp"
-#include "shared_memory/shared_memory.hpp"
+#include "realtime_test.hpp"
 
 /** @brief Global boolean to manage the thread loop stop on ctrl+c. */
 static bool running;
@@ -41,29 +41,28 @@ int main(int, char**)
     real_time_tools::Spinner spinner;
     spinner.set_frequency(2.0);
     running = true;
-    double shared[7];
 
-    while (running)
+    // wait for realtime_test to create the shared memory
+    RealtimeTestObject statistics_object;
+    while (running &&
+           !statistics_object.open_shared_memory(REALTIME_TEST_SEGMENT_NAME))
     {
-        shared_memory::get(
-            REALTIME_TEST_SEGMENT_ID, REALTIME_TEST_OBJECT_ID, shared, 7);
+        spinner.spin();
+    }
 
-        int ticks = static_cast<int>(shared[0]);
-        int switchs = static_cast<int>(shared[1]);
-        double target_frequency = shared[2];
-        double switch_frequency = shared[3];
-        double average_frequency = shared[4];
-        double current_frequency = shared[5];
-        double worse_frequency = shared[6];
+    while (running)
+    {
+        RealtimeTestStatistics statistics = statistics_object.get();
 
-        std::cout << "nb ticks: " << ticks << "\n";
-        std::cout << "nb switchs: " << switchs << "\n";
+        std::cout << "nb ticks: " << statistics.ticks << "\n";
+        std::cout << "nb switchs: " << statistics.switchs << "\n";
         std::cout << "frequencies:\n";
-        std::cout << "\ttarget: " << target_frequency << "\n";
-        std::cout << "\tprovokes switch: " << switch_frequency << "\n";
-        std::cout << "\taverage: " << average_frequency << "\n";
-        std::cout << "\tcurrent: " << current_frequency << "\n";
-        std::cout << "\tworse: " << worse_frequency << "\n";
+        std::cout << "\ttarget: " << statistics.target_frequency << "\n";
+        std::cout << "\tprovokes switch: " << statistics.switch_frequency
+                  << "\n";
+        std::cout << "\taverage: " << statistics.average_frequency << "\n";
+        std::cout << "\tcurrent: " << statistics.current_frequency << "\n";
+        std::cout << "\tworse: " << statistics.worse_frequency << "\n";
         std::cout << "\n\n";
 
         spinner.spin();
@@ -0,0 +1,295 @@
+/**
+ * @file cpu_topology.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the CPU topology discovery.
+ */
+
+#include "real_time_tools/cpu_topology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include "real_time_tools/iostream.hpp"
+#include "real_time_tools/process_manager.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Read the first line of a sysfs file.
+ *
+ * @param file_name is the file to read.
+ * @param[out] line is the first line.
+ * @return true if the file could be read.
+ */
+static bool read_sysfs_line(const std::string& file_name, std::string& line)
+{
+    std::ifstream file(file_name);
+    return static_cast<bool>(std::getline(file, line));
+}
+
+/**
+ * @brief Read an integer from a sysfs file.
+ *
+ * @param file_name is the file to read.
+ * @param default_value is returned if the file cannot be read.
+ * @return int
+ */
+static int read_sysfs_int(const std::string& file_name, int default_value)
+{
+    std::ifstream file(file_name);
+    int value;
+    if (file >> value)
+    {
+        return value;
+    }
+    return default_value;
+}
+
+/**
+ * @brief Is value in the sorted list?
+ */
+static bool contains(const std::vector<int>& sorted_list, int value)
+{
+    return std::binary_search(sorted_list.begin(), sorted_list.end(), value);
+}
+
+CpuTopology::CpuTopology()
+{
+    cpus_.clear();
+}
+
+bool CpuTopology::load(const std::string& sys_root)
+{
+    cpus_.clear();
+    const std::string cpu_root = sys_root + "/devices/system/cpu/";
+    std::string online, isolated;
+    if (!read_sysfs_line(cpu_root + "online", online))
+    {
+        rt_printf("CpuTopology: cannot read %sonline\n", cpu_root.c_str());
+        return false;
+    }
+    // The file is absent on old kernels, nothing is isolated then.
+    read_sysfs_line(cpu_root + "isolated", isolated);
+    const std::vector<int> isolated_cpu_ids = parse_cpu_list(isolated);
+
+    const std::vector<int> online_cpu_ids = parse_cpu_list(online);
+    for (unsigned i = 0; i < online_cpu_ids.size(); ++i)
+    {
+        CpuInfo cpu;
+        cpu.id_ = online_cpu_ids[i];
+        const std::string cpu_dir =
+            cpu_root + "cpu" + std::to_string(cpu.id_) + "/";
+        cpu.package_id_ =
+            read_sysfs_int(cpu_dir + "topology/physical_package_id", 0);
+        cpu.core_id_ = read_sysfs_int(cpu_dir + "topology/core_id", cpu.id_);
+        std::string siblings;
+        read_sysfs_line(cpu_dir + "topology/thread_siblings_list", siblings);
+        cpu.thread_siblings_ = parse_cpu_list(siblings);
+        if (!contains(cpu.thread_siblings_, cpu.id_))
+        {
+            cpu.thread_siblings_ = {cpu.id_};
+        }
+        cpu.isolated_ = contains(isolated_cpu_ids, cpu.id_);
+
+        for (int index = 0;; ++index)
+        {
+            const std::string cache_dir =
+                cpu_dir + "cache/index" + std::to_string(index) + "/";
+            CpuCache cache;
+            cache.level_ = read_sysfs_int(cache_dir + "level", -1);
+            if (cache.level_ < 0)
+            {
+                break;
+            }
+            std::string size, shared_cpus;
+            read_sysfs_line(cache_dir + "type", cache.type_);
+            read_sysfs_line(cache_dir + "size", size);
+            read_sysfs_line(cache_dir + "shared_cpu_list", shared_cpus);
+            // sizes are written "32K" or "8M".
+            cache.size_kb_ = std::atoi(size.c_str());
+            if (!size.empty() && size.back() == 'M')
+            {
+                cache.size_kb_ *= 1024;
+            }
+            cache.shared_cpu_ids_ = parse_cpu_list(shared_cpus);
+            cpu.caches_.push_back(cache);
+        }
+        cpus_.push_back(cpu);
+    }
+    return !cpus_.empty();
+}
+
+bool CpuTopology::get_cpu(int cpu_id, CpuInfo& cpu) const
+{
+    for (unsigned i = 0; i < cpus_.size(); ++i)
+    {
+        if (cpus_[i].id_ == cpu_id)
+        {
+            cpu = cpus_[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<int> CpuTopology::get_isolated_cpus() const
+{
+    std::vector<int> cpu_ids;
+    for (unsigned i = 0; i < cpus_.size(); ++i)
+    {
+        if (cpus_[i].isolated_)
+        {
+            cpu_ids.push_back(cpus_[i].id_);
+        }
+    }
+    return cpu_ids;
+}
+
+std::vector<std::vector<int> > CpuTopology::get_physical_cores() const
+{
+    std::vector<std::vector<int> > cores;
+    for (unsigned i = 0; i < cpus_.size(); ++i)
+    {
+        // a core is reported once, by its first logical CPU.
+        if (cpus_[i].thread_siblings_.front() == cpus_[i].id_)
+        {
+            cores.push_back(cpus_[i].thread_siblings_);
+        }
+    }
+    return cores;
+}
+
+std::vector<int> CpuTopology::get_cache_shared_cpus(int cpu_id,
+                                                    int level) const
+{
+    CpuInfo cpu;
+    if (!get_cpu(cpu_id, cpu))
+    {
+        return std::vector<int>();
+    }
+    for (unsigned i = 0; i < cpu.caches_.size(); ++i)
+    {
+        if (cpu.caches_[i].level_ == level &&
+            cpu.caches_[i].type_ != "Instruction")
+        {
+            return cpu.caches_[i].shared_cpu_ids_;
+        }
+    }
+    return std::vector<int>();
+}
+
+bool CpuTopology::is_core_available(
+    const CpuInfo& cpu, const std::vector<int>& excluded_cpu_ids) const
+{
+    for (unsigned i = 0; i < cpu.thread_siblings_.size(); ++i)
+    {
+        CpuInfo sibling;
+        if (std::find(excluded_cpu_ids.begin(),
+                      excluded_cpu_ids.end(),
+                      cpu.thread_siblings_[i]) != excluded_cpu_ids.end())
+        {
+            return false;
+        }
+        // an offline sibling stays idle.
+        if (get_cpu(cpu.thread_siblings_[i], sibling) && !sibling.isolated_)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int CpuTopology::find_isolated_core(
+    const std::vector<int>& excluded_cpu_ids) const
+{
+    for (unsigned i = 0; i < cpus_.size(); ++i)
+    {
+        if (cpus_[i].thread_siblings_.front() == cpus_[i].id_ &&
+            is_core_available(cpus_[i], excluded_cpu_ids))
+        {
+            return cpus_[i].id_;
+        }
+    }
+    return -1;
+}
+
+bool CpuTopology::find_isolated_cores(int nb_cores,
+                                      std::vector<int>& cpu_ids) const
+{
+    cpu_ids.clear();
+    for (int i = 0; i < nb_cores; ++i)
+    {
+        int cpu_id = find_isolated_core(cpu_ids);
+        if (cpu_id < 0)
+        {
+            return false;
+        }
+        cpu_ids.push_back(cpu_id);
+    }
+    return true;
+}
+
+bool CpuTopology::find_physical_cores_sharing_cache(int level,
+                                                    int& first_cpu_id,
+                                                    int& second_cpu_id) const
+{
+    // first pass: isolated cores only, second pass: any core.
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (unsigned i = 0; i < cpus_.size(); ++i)
+        {
+            const CpuInfo& first = cpus_[i];
+            if (first.thread_siblings_.front() != first.id_ ||
+                (pass == 0 && !is_core_available(first, std::vector<int>())))
+            {
+                continue;
+            }
+            const std::vector<int> shared_cpu_ids =
+                get_cache_shared_cpus(first.id_, level);
+            for (unsigned j = i + 1; j < cpus_.size(); ++j)
+            {
+                const CpuInfo& second = cpus_[j];
+                if (second.thread_siblings_.front() != second.id_ ||
+                    contains(first.thread_siblings_, second.id_) ||
+                    !contains(shared_cpu_ids, second.id_) ||
+                    (pass == 0 &&
+                     !is_core_available(second, std::vector<int>())))
+                {
+                    continue;
+                }
+                first_cpu_id = first.id_;
+                second_cpu_id = second.id_;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void CpuTopology::print() const
+{
+    rt_printf("cpu topology -------------------------------\n");
+    for (unsigned i = 0; i < cpus_.size(); ++i)
+    {
+        const CpuInfo& cpu = cpus_[i];
+        rt_printf("cpu %d: package %d, core %d, siblings %s%s\n",
+                  cpu.id_,
+                  cpu.package_id_,
+                  cpu.core_id_,
+                  format_cpu_list(cpu.thread_siblings_).c_str(),
+                  cpu.isolated_ ? ", isolated" : "");
+        for (unsigned j = 0; j < cpu.caches_.size(); ++j)
+        {
+            rt_printf("    L%d %s %d KB shared with %s\n",
+                      cpu.caches_[j].level_,
+                      cpu.caches_[j].type_.c_str(),
+                      cpu.caches_[j].size_kb_,
+                      format_cpu_list(cpu.caches_[j].shared_cpu_ids_).c_str());
+        }
+    }
+    rt_printf("--------------------------------------------\n");
+}
+
+}  // namespace real_time_tools
@@ -0,0 +1,169 @@
+/**
+ * @file memory.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the stack and heap pre-faulting and the page fault count.
+ */
+
+#include "real_time_tools/memory.hpp"
+#include <alloca.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifndef __APPLE__
+#include <malloc.h>
+#endif
+#include "real_time_tools/iostream.hpp"
+
+namespace real_time_tools
+{
+bool get_current_thread_page_faults(PageFaults& page_faults)
+{
+#ifdef __APPLE__
+    // Apple does not provide per thread resource usage.
+    page_faults.minor_ = 0;
+    page_faults.major_ = 0;
+    return false;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+    {
+        page_faults.minor_ = 0;
+        page_faults.major_ = 0;
+        return false;
+    }
+    page_faults.minor_ = usage.ru_minflt;
+    page_faults.major_ = usage.ru_majflt;
+    return true;
+#endif
+}
+
+void prefault_stack(std::size_t size)
+{
+    // Allocate the memory on the stack of the current frame and write one
+    // byte per page. The memory is released when this function returns but
+    // the pages stay mapped.
+    volatile unsigned char* dummy =
+        static_cast<volatile unsigned char*>(alloca(size));
+    const std::size_t page_size = static_cast<std::size_t>(getpagesize());
+    for (std::size_t i = 0; i < size; i += page_size)
+    {
+        dummy[i] = 0;
+    }
+}
+
+#ifndef __APPLE__
+/**
+ * @brief Never give the memory back to the OS and never use mmap, otherwise
+ * the pages touched by reserve_heap() would be unmapped again. This applies
+ * to the whole process.
+ *
+ * @return true if malloc was configured.
+ */
+static bool keep_heap_mapped()
+{
+    if (!mallopt(M_TRIM_THRESHOLD, -1))
+    {
+        rt_printf("reserve_heap: mallopt(M_TRIM_THRESHOLD) failed\n");
+        return false;
+    }
+    if (!mallopt(M_MMAP_MAX, 0))
+    {
+        rt_printf("reserve_heap: mallopt(M_MMAP_MAX) failed\n");
+        return false;
+    }
+    return true;
+}
+#endif
+
+bool reserve_heap(std::size_t size)
+{
+#ifdef __APPLE__
+    // The Apple allocator cannot be configured this way.
+    return false;
+#else
+    // malloc is configured once for the process, by the first reserve.
+    static const bool heap_kept_mapped = keep_heap_mapped();
+    if (!heap_kept_mapped)
+    {
+        return false;
+    }
+
+    volatile unsigned char* buffer =
+        static_cast<volatile unsigned char*>(malloc(size));
+    if (buffer == nullptr)
+    {
+        rt_printf("reserve_heap: could not allocate %zu bytes\n", size);
+        return false;
+    }
+    const std::size_t page_size = static_cast<std::size_t>(getpagesize());
+    for (std::size_t i = 0; i < size; i += page_size)
+    {
+        buffer[i] = 0;
+    }
+    free(const_cast<unsigned char*>(buffer));
+    return true;
+#endif
+}
+
+PageFaultCounter::PageFaultCounter(unsigned long nb_cycles)
+    : nb_cycles_(nb_cycles), cycles_(0), done_(false)
+{
+    before_.minor_ = 0;
+    before_.major_ = 0;
+    after_ = before_;
+}
+
+void PageFaultCounter::start()
+{
+    cycles_ = 0;
+    done_.store(false, std::memory_order_release);
+    get_current_thread_page_faults(before_);
+}
+
+void PageFaultCounter::tick()
+{
+    if (done_.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    ++cycles_;
+    if (cycles_ >= nb_cycles_)
+    {
+        get_current_thread_page_faults(after_);
+        done_.store(true, std::memory_order_release);
+    }
+}
+
+bool PageFaultCounter::is_done() const
+{
+    return done_.load(std::memory_order_acquire);
+}
+
+void PageFaultCounter::print() const
+{
+    if (!is_done())
+    {
+        rt_printf("page faults: less than %lu cycles counted so far\n",
+                  nb_cycles_);
+        return;
+    }
+    rt_printf("page faults --------------------------------\n");
+    rt_printf(
+        "before the loop: minor %ld, major %ld\n"
+        "after %lu cycles: minor %ld, major %ld\n"
+        "taken during the cycles: minor %ld, major %ld\n",
+        before_.minor_,
+        before_.major_,
+        nb_cycles_,
+        after_.minor_,
+        after_.major_,
+        get_minor_page_faults(),
+        get_major_page_faults());
+    rt_printf("--------------------------------------------\n");
+}
+
+}  // namespace real_time_tools
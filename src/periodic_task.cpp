@@ -0,0 +1,256 @@
+/**
+ * @file periodic_task.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the periodic real time task.
+ */
+
+#include "real_time_tools/periodic_task.hpp"
+#include <errno.h>
+#include <time.h>
+#include <cmath>
+#include <limits>
+#include "real_time_tools/futex.hpp"
+#include "real_time_tools/iostream.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Current CLOCK_MONOTONIC date in nano-seconds.
+ */
+static int64_t get_monotonic_time_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * @brief Sleep until the CLOCK_MONOTONIC date in nano-seconds.
+ */
+static void sleep_until_monotonic_ns(int64_t date_ns)
+{
+    struct timespec date;
+    date.tv_sec = static_cast<time_t>(date_ns / 1000000000);
+    date.tv_nsec = static_cast<long>(date_ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &date, nullptr) ==
+           EINTR)
+    {
+    }
+}
+
+PeriodicTask::PeriodicTask(std::function<void()> function,
+                           double period_sec,
+                           int priority,
+                           int cpu_id)
+    : function_(function),
+      period_ns_(static_cast<int64_t>(std::llround(period_sec * 1e9))),
+      running_(false),
+      stop_requested_(false),
+      statistics_sequence_(0)
+{
+    thread_.parameters_.priority_ = priority;
+    if (cpu_id >= 0)
+    {
+        thread_.parameters_.cpu_id_ = {cpu_id};
+    }
+}
+
+PeriodicTask::~PeriodicTask()
+{
+    stop();
+}
+
+bool PeriodicTask::start()
+{
+    if (running_.exchange(true))
+    {
+        return false;
+    }
+    statistics_sequence_ = 0;
+    statistics_.nb_cycles_ = 0;
+    statistics_.nb_overruns_ = 0;
+    statistics_.nb_missed_deadlines_ = 0;
+    statistics_.min_execution_time_ = std::numeric_limits<double>::infinity();
+    statistics_.max_execution_time_ = -std::numeric_limits<double>::infinity();
+    statistics_.sum_execution_time_ = 0.0;
+    statistics_.min_wakeup_latency_ = std::numeric_limits<double>::infinity();
+    statistics_.max_wakeup_latency_ = -std::numeric_limits<double>::infinity();
+    statistics_.sum_wakeup_latency_ = 0.0;
+    stop_requested_ = false;
+
+    int ret = thread_.create_realtime_thread(&PeriodicTask::loop, this);
+    if (ret != 0)
+    {
+        rt_printf("PeriodicTask: could not start the thread. Ret= %d\n", ret);
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void PeriodicTask::stop()
+{
+    stop_requested_.store(true, std::memory_order_release);
+    thread_.join();
+    running_.store(false, std::memory_order_release);
+}
+
+THREAD_FUNCTION_RETURN_TYPE PeriodicTask::loop(void* task_ptr)
+{
+    PeriodicTask* task = static_cast<PeriodicTask*>(task_ptr);
+    int64_t deadline_ns = get_monotonic_time_ns();
+    while (!task->stop_requested_.load(std::memory_order_acquire))
+    {
+        sleep_until_monotonic_ns(deadline_ns);
+        int64_t wakeup_ns = get_monotonic_time_ns();
+
+        task->function_();
+
+        int64_t end_ns = get_monotonic_time_ns();
+        int64_t wakeup_latency_ns = wakeup_ns - deadline_ns;
+
+        // next deadline on the grid, skipping the ones already passed.
+        deadline_ns += task->period_ns_;
+        uint64_t nb_missed_deadlines = 0;
+        if (end_ns > deadline_ns)
+        {
+            nb_missed_deadlines = static_cast<uint64_t>(
+                (end_ns - deadline_ns) / task->period_ns_ + 1);
+            deadline_ns += static_cast<int64_t>(nb_missed_deadlines) *
+                           task->period_ns_;
+        }
+
+        task->update_statistics(
+            static_cast<double>(end_ns - wakeup_ns) * 1e-9,
+            static_cast<double>(wakeup_latency_ns) * 1e-9,
+            nb_missed_deadlines);
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+void PeriodicTask::update_statistics(double execution_time,
+                                     double wakeup_latency,
+                                     uint64_t nb_missed_deadlines)
+{
+    // Only this thread writes, so relaxed loads of the values are enough.
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    uint64_t sequence = statistics_sequence_.load(relaxed);
+    statistics_sequence_.store(sequence + 1, relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    statistics_.nb_cycles_.store(statistics_.nb_cycles_.load(relaxed) + 1,
+                                 relaxed);
+    if (nb_missed_deadlines > 0)
+    {
+        statistics_.nb_overruns_.store(
+            statistics_.nb_overruns_.load(relaxed) + 1, relaxed);
+        statistics_.nb_missed_deadlines_.store(
+            statistics_.nb_missed_deadlines_.load(relaxed) +
+                nb_missed_deadlines,
+            relaxed);
+    }
+    if (execution_time < statistics_.min_execution_time_.load(relaxed))
+    {
+        statistics_.min_execution_time_.store(execution_time, relaxed);
+    }
+    if (execution_time > statistics_.max_execution_time_.load(relaxed))
+    {
+        statistics_.max_execution_time_.store(execution_time, relaxed);
+    }
+    statistics_.sum_execution_time_.store(
+        statistics_.sum_execution_time_.load(relaxed) + execution_time,
+        relaxed);
+    if (wakeup_latency < statistics_.min_wakeup_latency_.load(relaxed))
+    {
+        statistics_.min_wakeup_latency_.store(wakeup_latency, relaxed);
+    }
+    if (wakeup_latency > statistics_.max_wakeup_latency_.load(relaxed))
+    {
+        statistics_.max_wakeup_latency_.store(wakeup_latency, relaxed);
+    }
+    statistics_.sum_wakeup_latency_.store(
+        statistics_.sum_wakeup_latency_.load(relaxed) + wakeup_latency,
+        relaxed);
+
+    statistics_sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+PeriodicTaskStatistics PeriodicTask::get_statistics() const
+{
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    PeriodicTaskStatistics statistics;
+    double sum_execution_time, sum_wakeup_latency;
+    uint64_t sequence_before, sequence_after;
+    do
+    {
+        sequence_before =
+            statistics_sequence_.load(std::memory_order_acquire);
+        if (sequence_before % 2 == 1)
+        {
+            cpu_relax();
+            continue;
+        }
+        statistics.nb_cycles_ = statistics_.nb_cycles_.load(relaxed);
+        statistics.nb_overruns_ = statistics_.nb_overruns_.load(relaxed);
+        statistics.nb_missed_deadlines_ =
+            statistics_.nb_missed_deadlines_.load(relaxed);
+        statistics.min_execution_time_ =
+            statistics_.min_execution_time_.load(relaxed);
+        statistics.max_execution_time_ =
+            statistics_.max_execution_time_.load(relaxed);
+        sum_execution_time = statistics_.sum_execution_time_.load(relaxed);
+        statistics.min_wakeup_latency_ =
+            statistics_.min_wakeup_latency_.load(relaxed);
+        statistics.max_wakeup_latency_ =
+            statistics_.max_wakeup_latency_.load(relaxed);
+        sum_wakeup_latency = statistics_.sum_wakeup_latency_.load(relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        sequence_after = statistics_sequence_.load(relaxed);
+    } while (sequence_before % 2 == 1 || sequence_before != sequence_after);
+
+    if (statistics.nb_cycles_ > 0)
+    {
+        double nb_cycles = static_cast<double>(statistics.nb_cycles_);
+        statistics.avg_execution_time_ = sum_execution_time / nb_cycles;
+        statistics.avg_wakeup_latency_ = sum_wakeup_latency / nb_cycles;
+    }
+    else
+    {
+        statistics.avg_execution_time_ = 0.0;
+        statistics.avg_wakeup_latency_ = 0.0;
+    }
+    return statistics;
+}
+
+void PeriodicTask::print_statistics() const
+{
+    PeriodicTaskStatistics statistics = get_statistics();
+    rt_printf("periodic task ------------------------------\n");
+    rt_printf(
+        "period_sec: %f\n"
+        "nb_cycles: %lu\n"
+        "nb_overruns: %lu\n"
+        "nb_missed_deadlines: %lu\n"
+        "min_execution_time_sec: %f\n"
+        "max_execution_time_sec: %f\n"
+        "avg_execution_time_sec: %f\n"
+        "min_wakeup_latency_sec: %f\n"
+        "max_wakeup_latency_sec: %f\n"
+        "avg_wakeup_latency_sec: %f\n",
+        static_cast<double>(period_ns_) * 1e-9,
+        static_cast<unsigned long>(statistics.nb_cycles_),
+        static_cast<unsigned long>(statistics.nb_overruns_),
+        static_cast<unsigned long>(statistics.nb_missed_deadlines_),
+        statistics.min_execution_time_,
+        statistics.max_execution_time_,
+        statistics.avg_execution_time_,
+        statistics.min_wakeup_latency_,
+        statistics.max_wakeup_latency_,
+        statistics.avg_wakeup_latency_);
+    rt_printf("--------------------------------------------\n");
+}
+
+}  // namespace real_time_tools
@@ -17,8 +17,16 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <vector>
 #include "real_time_tools/iostream.hpp"
+#include "real_time_tools/timer.hpp"
 
 namespace real_time_tools
 {
@@ -63,23 +71,685 @@ bool set_cpu_dma_latency(int max_latency_us)
 #ifdef XENOMAI
     return false;
 #elif defined(NON_REAL_TIME) || defined(RT_PREEMPT)
-    int fd;
+    // Held until the end of the process, replacing the previous request.
+    static std::mutex guard_mutex;
+    static std::unique_ptr<DmaLatencyGuard> guard;
+    std::lock_guard<std::mutex> lock(guard_mutex);
+    // The previous request is released only once the new one holds, so
+    // that the CPUs are never left without a constraint.
+    std::unique_ptr<DmaLatencyGuard> new_guard(
+        new DmaLatencyGuard(max_latency_us));
+    if (!new_guard->is_active())
+    {
+        return false;
+    }
+    guard.swap(new_guard);
+    return true;
+#endif
+}
+
+std::vector<int> parse_cpu_list(const std::string& cpu_list)
+{
+    std::vector<int> cpu_ids;
+    std::istringstream list_stream(cpu_list);
+    std::string token;
+    while (std::getline(list_stream, token, ','))
+    {
+        token.erase(std::remove_if(token.begin(), token.end(), ::isspace),
+                    token.end());
+        if (token.empty() || !std::isdigit(token[0]))
+        {
+            continue;
+        }
+        // a range may be followed by ":used/group", e.g. "0-7:2/4" is
+        // 0,1,4,5: the first used CPUs of each group of the range.
+        std::size_t colon = token.find(':');
+        int used_size = 1;
+        int group_size = 1;
+        if (colon != std::string::npos)
+        {
+            std::size_t slash = token.find('/', colon);
+            if (slash == std::string::npos)
+            {
+                continue;
+            }
+            used_size = std::atoi(token.substr(colon + 1).c_str());
+            group_size = std::atoi(token.substr(slash + 1).c_str());
+            if (used_size <= 0 || group_size <= 0 || used_size > group_size)
+            {
+                continue;
+            }
+            token = token.substr(0, colon);
+        }
+        std::size_t dash = token.find('-');
+        int first = std::atoi(token.substr(0, dash).c_str());
+        int last = first;
+        if (dash != std::string::npos)
+        {
+            last = std::atoi(token.substr(dash + 1).c_str());
+        }
+        for (int cpu_id = first; cpu_id <= last; ++cpu_id)
+        {
+            if ((cpu_id - first) % group_size < used_size)
+            {
+                cpu_ids.push_back(cpu_id);
+            }
+        }
+    }
+    std::sort(cpu_ids.begin(), cpu_ids.end());
+    cpu_ids.erase(std::unique(cpu_ids.begin(), cpu_ids.end()), cpu_ids.end());
+    return cpu_ids;
+}
+
+std::string format_cpu_list(const std::vector<int>& cpu_ids)
+{
+    std::vector<int> sorted_ids(cpu_ids);
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    sorted_ids.erase(std::unique(sorted_ids.begin(), sorted_ids.end()),
+                     sorted_ids.end());
+    std::ostringstream list;
+    for (std::size_t i = 0; i < sorted_ids.size(); ++i)
+    {
+        std::size_t last = i;
+        while (last + 1 < sorted_ids.size() &&
+               sorted_ids[last + 1] == sorted_ids[last] + 1)
+        {
+            ++last;
+        }
+        if (i > 0)
+        {
+            list << ",";
+        }
+        list << sorted_ids[i];
+        if (last > i)
+        {
+            list << "-" << sorted_ids[last];
+        }
+        i = last;
+    }
+    return list.str();
+}
+
+/**
+ * @brief Path to the sysfs directory of a CPU.
+ */
+static std::string get_cpu_dir(const std::string& sys_root, int cpu_id)
+{
+    return sys_root + "/devices/system/cpu/cpu" + std::to_string(cpu_id) +
+           "/";
+}
+
+bool get_cpu_idle_states(int cpu_id,
+                         std::vector<CpuIdleState>& states,
+                         const std::string& sys_root)
+{
+    states.clear();
+    const std::string cpuidle_dir = get_cpu_dir(sys_root, cpu_id) + "cpuidle/";
+    for (int i = 0;; ++i)
+    {
+        const std::string state_dir =
+            cpuidle_dir + "state" + std::to_string(i) + "/";
+        std::ifstream name_file(state_dir + "name");
+        std::ifstream latency_file(state_dir + "latency");
+        if (!name_file.is_open() || !latency_file.is_open())
+        {
+            break;
+        }
+        CpuIdleState state;
+        int disable = 0;
+        std::ifstream disable_file(state_dir + "disable");
+        std::ifstream usage_file(state_dir + "usage");
+        if (!(name_file >> state.name_) ||
+            !(latency_file >> state.latency_us_))
+        {
+            return false;
+        }
+        disable_file >> disable;
+        state.disabled_ = (disable != 0);
+        state.usage_ = 0;
+        usage_file >> state.usage_;
+        states.push_back(state);
+    }
+    return !states.empty();
+}
+
+std::vector<CpuIdleState> get_entered_idle_states(
+    const std::vector<CpuIdleState>& before,
+    const std::vector<CpuIdleState>& after)
+{
+    std::vector<CpuIdleState> entered_states;
+    if (before.size() != after.size())
+    {
+        return entered_states;
+    }
+    for (unsigned i = 0; i < after.size(); ++i)
+    {
+        if (after[i].name_ != before[i].name_)
+        {
+            return std::vector<CpuIdleState>();
+        }
+        if (!after[i].disabled_ && after[i].usage_ > before[i].usage_)
+        {
+            entered_states.push_back(after[i]);
+        }
+    }
+    return entered_states;
+}
 
-    fd = open("/dev/cpu_dma_latency", O_WRONLY);
-    if (fd < 0)
+DmaLatencyGuard::DmaLatencyGuard(int max_latency_us)
+    : max_latency_us_(max_latency_us),
+      sys_root_("/sys"),
+      active_(false),
+      per_cpu_(false),
+      dma_latency_fd_(-1)
+{
+#if defined(NON_REAL_TIME) || defined(RT_PREEMPT)
+    dma_latency_fd_ = open("/dev/cpu_dma_latency", O_WRONLY);
+    if (dma_latency_fd_ < 0)
     {
         perror("open /dev/cpu_dma_latency");
-        return false;
+        return;
     }
-    if (write(fd, &max_latency_us, sizeof(max_latency_us)) !=
+    if (write(dma_latency_fd_, &max_latency_us, sizeof(max_latency_us)) !=
         sizeof(max_latency_us))
     {
         perror("write to /dev/cpu_dma_latency");
+        close(dma_latency_fd_);
+        dma_latency_fd_ = -1;
+        return;
+    }
+    active_ = true;
+#endif
+}
+
+DmaLatencyGuard::DmaLatencyGuard(int max_latency_us,
+                                 const std::vector<int>& cpu_ids,
+                                 const std::string& sys_root)
+    : max_latency_us_(max_latency_us),
+      sys_root_(sys_root),
+      active_(true),
+      per_cpu_(true),
+      dma_latency_fd_(-1)
+{
+    // In pm_qos_resume_latency_us "0" means no constraint and "n/a" means
+    // that no latency is tolerated.
+    requested_resume_latency_ =
+        max_latency_us == 0 ? "n/a" : std::to_string(max_latency_us);
+    for (unsigned i = 0; i < cpu_ids.size(); ++i)
+    {
+        const std::string file_name = get_cpu_dir(sys_root_, cpu_ids[i]) +
+                                      "power/pm_qos_resume_latency_us";
+        std::string previous_latency;
+        std::ifstream previous_file(file_name);
+        if (!(previous_file >> previous_latency))
+        {
+            rt_printf("DmaLatencyGuard: cannot read %s\n", file_name.c_str());
+            active_ = false;
+            continue;
+        }
+        std::ofstream latency_file(file_name);
+        latency_file << requested_resume_latency_ << std::endl;
+        if (!latency_file.good())
+        {
+            rt_printf("DmaLatencyGuard: cannot write %s\n", file_name.c_str());
+            active_ = false;
+            continue;
+        }
+        cpu_ids_.push_back(cpu_ids[i]);
+        previous_resume_latencies_.push_back(previous_latency);
+    }
+}
+
+DmaLatencyGuard::~DmaLatencyGuard()
+{
+    if (dma_latency_fd_ >= 0)
+    {
+        close(dma_latency_fd_);
+    }
+    for (unsigned i = 0; i < cpu_ids_.size(); ++i)
+    {
+        std::ofstream latency_file(get_cpu_dir(sys_root_, cpu_ids_[i]) +
+                                   "power/pm_qos_resume_latency_us");
+        latency_file << previous_resume_latencies_[i] << std::endl;
+    }
+}
+
+bool DmaLatencyGuard::is_applied(int cpu_id) const
+{
+    if (!per_cpu_)
+    {
+        if (dma_latency_fd_ < 0)
+        {
+            return false;
+        }
+        // Reading the file gives the constraint the kernel currently
+        // applies, the strictest of all the requests.
+        int32_t applied_latency_us = 0;
+        int fd = open("/dev/cpu_dma_latency", O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool read_ok = read(fd, &applied_latency_us, sizeof(int32_t)) ==
+                       sizeof(int32_t);
+        close(fd);
+        return read_ok && applied_latency_us <= max_latency_us_;
+    }
+    if (std::find(cpu_ids_.begin(), cpu_ids_.end(), cpu_id) == cpu_ids_.end())
+    {
         return false;
     }
+    std::string applied_latency;
+    std::ifstream latency_file(get_cpu_dir(sys_root_, cpu_id) +
+                               "power/pm_qos_resume_latency_us");
+    return (latency_file >> applied_latency) &&
+           applied_latency == requested_resume_latency_;
+}
 
+bool DmaLatencyGuard::get_enabled_idle_states(int cpu_id,
+                                              std::vector<CpuIdleState>& states,
+                                              double idle_interval_sec) const
+{
+    states.clear();
+    if (per_cpu_ &&
+        std::find(cpu_ids_.begin(), cpu_ids_.end(), cpu_id) == cpu_ids_.end())
+    {
+        rt_printf("DmaLatencyGuard: cpu %d is not constrained by this guard\n",
+                  cpu_id);
+        return false;
+    }
+    std::vector<CpuIdleState> states_before, states_after;
+    if (!get_cpu_idle_states(cpu_id, states_before, sys_root_))
+    {
+        return false;
+    }
+    Timer::sleep_sec(idle_interval_sec);
+    if (!get_cpu_idle_states(cpu_id, states_after, sys_root_))
+    {
+        return false;
+    }
+    states = get_entered_idle_states(states_before, states_after);
     return true;
-#endif
+}
+
+void DmaLatencyGuard::print_enabled_idle_states(
+    const std::vector<int>& cpu_ids, double idle_interval_sec) const
+{
+    // sample all the CPUs over the same idle interval.
+    std::vector<std::vector<CpuIdleState> > states_before(cpu_ids.size());
+    std::vector<bool> readable(cpu_ids.size());
+    for (unsigned i = 0; i < cpu_ids.size(); ++i)
+    {
+        readable[i] =
+            get_cpu_idle_states(cpu_ids[i], states_before[i], sys_root_);
+    }
+    Timer::sleep_sec(idle_interval_sec);
+    for (unsigned i = 0; i < cpu_ids.size(); ++i)
+    {
+        if (per_cpu_ && std::find(cpu_ids_.begin(), cpu_ids_.end(),
+                                  cpu_ids[i]) == cpu_ids_.end())
+        {
+            rt_printf("cpu %d: not constrained by this guard\n", cpu_ids[i]);
+            continue;
+        }
+        std::vector<CpuIdleState> states_after;
+        if (!readable[i] ||
+            !get_cpu_idle_states(cpu_ids[i], states_after, sys_root_))
+        {
+            rt_printf("cpu %d: no cpuidle information\n", cpu_ids[i]);
+            continue;
+        }
+        std::vector<CpuIdleState> states =
+            get_entered_idle_states(states_before[i], states_after);
+        rt_printf("cpu %d: constraint %s, idle states entered:",
+                  cpu_ids[i],
+                  is_applied(cpu_ids[i]) ? "applied" : "NOT applied");
+        for (unsigned j = 0; j < states.size(); ++j)
+        {
+            rt_printf(" %s (%d us)",
+                      states[j].name_.c_str(),
+                      states[j].latency_us_);
+        }
+        rt_printf("\n");
+    }
+}
+
+CpuPerformanceGuard::CpuPerformanceGuard(const std::vector<int>& cpu_ids,
+                                         const std::string& sys_root)
+    : cpu_ids_(cpu_ids), sys_root_(sys_root)
+{
+}
+
+CpuPerformanceGuard::~CpuPerformanceGuard()
+{
+    restore();
+}
+
+bool CpuPerformanceGuard::write_attribute(const std::string& file_name,
+                                          const std::string& value)
+{
+    std::string previous_value;
+    std::ifstream previous_file(file_name);
+    if (!std::getline(previous_file, previous_value))
+    {
+        rt_printf("CpuPerformanceGuard: cannot read %s\n", file_name.c_str());
+        return false;
+    }
+    std::ofstream file(file_name);
+    file << value << std::endl;
+    if (!file.good())
+    {
+        rt_printf("CpuPerformanceGuard: cannot write %s in %s\n",
+                  value.c_str(),
+                  file_name.c_str());
+        return false;
+    }
+    // Only the value before the first write is restored.
+    if (std::find(modified_files_.begin(), modified_files_.end(), file_name) ==
+        modified_files_.end())
+    {
+        modified_files_.push_back(file_name);
+        previous_values_.push_back(previous_value);
+    }
+    return true;
+}
+
+bool CpuPerformanceGuard::set_governor(const std::string& governor)
+{
+    bool success = true;
+    for (unsigned i = 0; i < cpu_ids_.size(); ++i)
+    {
+        success = write_attribute(get_cpu_dir(sys_root_, cpu_ids_[i]) +
+                                      "cpufreq/scaling_governor",
+                                  governor) &&
+                  success;
+    }
+    return success;
+}
+
+bool CpuPerformanceGuard::set_min_frequency(int frequency_khz)
+{
+    bool success = true;
+    for (unsigned i = 0; i < cpu_ids_.size(); ++i)
+    {
+        const std::string cpufreq_dir =
+            get_cpu_dir(sys_root_, cpu_ids_[i]) + "cpufreq/";
+        int min_frequency_khz = frequency_khz;
+        if (min_frequency_khz < 0)
+        {
+            std::ifstream max_frequency_file(cpufreq_dir + "cpuinfo_max_freq");
+            if (!(max_frequency_file >> min_frequency_khz))
+            {
+                rt_printf("CpuPerformanceGuard: cannot read %s\n",
+                          (cpufreq_dir + "cpuinfo_max_freq").c_str());
+                success = false;
+                continue;
+            }
+        }
+        success = write_attribute(cpufreq_dir + "scaling_min_freq",
+                                  std::to_string(min_frequency_khz)) &&
+                  success;
+    }
+    return success;
+}
+
+bool CpuPerformanceGuard::disable_idle_states(int max_latency_us)
+{
+    bool success = true;
+    for (unsigned i = 0; i < cpu_ids_.size(); ++i)
+    {
+        std::vector<CpuIdleState> states;
+        if (!get_cpu_idle_states(cpu_ids_[i], states, sys_root_))
+        {
+            rt_printf("CpuPerformanceGuard: no cpuidle information for cpu "
+                      "%d\n",
+                      cpu_ids_[i]);
+            success = false;
+            continue;
+        }
+        for (unsigned j = 0; j < states.size(); ++j)
+        {
+            if (states[j].latency_us_ > max_latency_us)
+            {
+                success = write_attribute(get_cpu_dir(sys_root_, cpu_ids_[i]) +
+                                              "cpuidle/state" +
+                                              std::to_string(j) + "/disable",
+                                          "1") &&
+                          success;
+            }
+        }
+    }
+    return success;
+}
+
+bool CpuPerformanceGuard::disable_idle_state(const std::string& name)
+{
+    bool success = true;
+    for (unsigned i = 0; i < cpu_ids_.size(); ++i)
+    {
+        std::vector<CpuIdleState> states;
+        get_cpu_idle_states(cpu_ids_[i], states, sys_root_);
+        unsigned j = 0;
+        while (j < states.size() && states[j].name_ != name)
+        {
+            ++j;
+        }
+        if (j == states.size())
+        {
+            rt_printf("CpuPerformanceGuard: cpu %d has no idle state %s\n",
+                      cpu_ids_[i],
+                      name.c_str());
+            success = false;
+            continue;
+        }
+        success = write_attribute(get_cpu_dir(sys_root_, cpu_ids_[i]) +
+                                      "cpuidle/state" + std::to_string(j) +
+                                      "/disable",
+                                  "1") &&
+                  success;
+    }
+    return success;
+}
+
+void CpuPerformanceGuard::restore()
+{
+    // Undo the writes in reverse order.
+    for (unsigned i = modified_files_.size(); i-- > 0;)
+    {
+        std::ofstream file(modified_files_[i]);
+        file << previous_values_[i] << std::endl;
+    }
+    modified_files_.clear();
+    previous_values_.clear();
+}
+
+/**
+ * @brief Path to the procfs directory of an IRQ.
+ */
+static std::string get_irq_dir(const std::string& proc_root, int irq)
+{
+    return proc_root + "/irq/" + std::to_string(irq) + "/";
+}
+
+bool get_irqs(std::vector<IrqInfo>& irqs, const std::string& proc_root)
+{
+    irqs.clear();
+    const boost::filesystem::path irq_root(proc_root + "/irq");
+    boost::system::error_code error;
+    boost::filesystem::directory_iterator it(irq_root, error), end;
+    if (error)
+    {
+        rt_printf("get_irqs: cannot read %s\n", irq_root.string().c_str());
+        return false;
+    }
+    for (; !error && it != end; it.increment(error))
+    {
+        const std::string irq_name = it->path().filename().string();
+        if (irq_name.empty() ||
+            !std::all_of(irq_name.begin(), irq_name.end(), ::isdigit))
+        {
+            continue;
+        }
+        IrqInfo irq;
+        irq.irq_ = std::atoi(irq_name.c_str());
+        std::ifstream affinity_file(it->path().string() +
+                                    "/smp_affinity_list");
+        std::string affinity;
+        affinity_file >> affinity;
+        irq.cpu_ids_ = parse_cpu_list(affinity);
+        // The kernel creates one directory per handler, named after it.
+        boost::system::error_code handler_error;
+        for (boost::filesystem::directory_iterator
+                 handler(it->path(), handler_error);
+             !handler_error && handler != end;
+             handler.increment(handler_error))
+        {
+            if (boost::filesystem::is_directory(handler->status()))
+            {
+                irq.devices_.push_back(handler->path().filename().string());
+            }
+        }
+        std::sort(irq.devices_.begin(), irq.devices_.end());
+        irqs.push_back(irq);
+    }
+    std::sort(irqs.begin(),
+              irqs.end(),
+              [](const IrqInfo& a, const IrqInfo& b) {
+                  return a.irq_ < b.irq_;
+              });
+    return true;
+}
+
+bool find_irqs(const std::string& device_name,
+               std::vector<IrqInfo>& irqs,
+               const std::string& proc_root)
+{
+    std::vector<IrqInfo> all_irqs;
+    irqs.clear();
+    if (!get_irqs(all_irqs, proc_root))
+    {
+        return false;
+    }
+    for (unsigned i = 0; i < all_irqs.size(); ++i)
+    {
+        for (unsigned j = 0; j < all_irqs[i].devices_.size(); ++j)
+        {
+            if (all_irqs[i].devices_[j].find(device_name) != std::string::npos)
+            {
+                irqs.push_back(all_irqs[i]);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+IrqAffinityGuard::IrqAffinityGuard(const std::string& proc_root)
+    : proc_root_(proc_root)
+{
+}
+
+IrqAffinityGuard::~IrqAffinityGuard()
+{
+    restore();
+}
+
+bool IrqAffinityGuard::set_irq_affinity(int irq,
+                                        const std::vector<int>& cpu_ids)
+{
+    const std::string file_name =
+        get_irq_dir(proc_root_, irq) + "smp_affinity_list";
+    std::string previous_affinity;
+    std::ifstream previous_file(file_name);
+    if (cpu_ids.empty() || !(previous_file >> previous_affinity))
+    {
+        rt_printf("IrqAffinityGuard: cannot read %s\n", file_name.c_str());
+        return false;
+    }
+    std::ofstream affinity_file(file_name);
+    affinity_file << format_cpu_list(cpu_ids) << std::endl;
+    if (!affinity_file.good())
+    {
+        rt_printf("IrqAffinityGuard: cannot move IRQ %d to cpu(s) %s\n",
+                  irq,
+                  format_cpu_list(cpu_ids).c_str());
+        return false;
+    }
+    // Only the affinity before the first move is restored.
+    if (std::find(moved_irqs_.begin(), moved_irqs_.end(), irq) ==
+        moved_irqs_.end())
+    {
+        moved_irqs_.push_back(irq);
+        previous_affinities_.push_back(previous_affinity);
+    }
+    return true;
+}
+
+int IrqAffinityGuard::move_irqs_to(const std::string& device_name,
+                                   const std::vector<int>& cpu_ids)
+{
+    std::vector<IrqInfo> irqs;
+    find_irqs(device_name, irqs, proc_root_);
+    int nb_moved_irqs = 0;
+    for (unsigned i = 0; i < irqs.size(); ++i)
+    {
+        if (set_irq_affinity(irqs[i].irq_, cpu_ids))
+        {
+            ++nb_moved_irqs;
+        }
+    }
+    return nb_moved_irqs;
+}
+
+int IrqAffinityGuard::move_irqs_away_from(const std::string& device_name,
+                                          const std::vector<int>& cpu_ids)
+{
+    std::vector<IrqInfo> irqs;
+    find_irqs(device_name, irqs, proc_root_);
+    int nb_moved_irqs = 0;
+    for (unsigned i = 0; i < irqs.size(); ++i)
+    {
+        std::vector<int> remaining_cpu_ids;
+        for (unsigned j = 0; j < irqs[i].cpu_ids_.size(); ++j)
+        {
+            if (std::find(cpu_ids.begin(),
+                          cpu_ids.end(),
+                          irqs[i].cpu_ids_[j]) == cpu_ids.end())
+            {
+                remaining_cpu_ids.push_back(irqs[i].cpu_ids_[j]);
+            }
+        }
+        if (remaining_cpu_ids.size() == irqs[i].cpu_ids_.size())
+        {
+            continue;
+        }
+        if (remaining_cpu_ids.empty())
+        {
+            rt_printf(
+                "IrqAffinityGuard: IRQ %d only runs on cpu(s) %s, not "
+                "moved\n",
+                irqs[i].irq_,
+                format_cpu_list(irqs[i].cpu_ids_).c_str());
+            continue;
+        }
+        if (set_irq_affinity(irqs[i].irq_, remaining_cpu_ids))
+        {
+            ++nb_moved_irqs;
+        }
+    }
+    return nb_moved_irqs;
+}
+
+void IrqAffinityGuard::restore()
+{
+    for (unsigned i = 0; i < moved_irqs_.size(); ++i)
+    {
+        std::ofstream affinity_file(get_irq_dir(proc_root_, moved_irqs_[i]) +
+                                    "smp_affinity_list");
+        affinity_file << previous_affinities_[i] << std::endl;
+    }
+    moved_irqs_.clear();
+    previous_affinities_.clear();
 }
 
 }  // namespace real_time_tools
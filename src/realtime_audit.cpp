@@ -0,0 +1,529 @@
+/**
+ * @file realtime_audit.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the real time readiness audit.
+ */
+
+#include "real_time_tools/realtime_audit.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "real_time_tools/iostream.hpp"
+#include "real_time_tools/process_manager.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Read the first line of a file.
+ *
+ * @param file_name is the file to read.
+ * @param[out] line is the first line.
+ * @return true if the file could be read.
+ */
+static bool read_first_line(const std::string& file_name, std::string& line)
+{
+    std::ifstream file(file_name);
+    return static_cast<bool>(std::getline(file, line));
+}
+
+/**
+ * @brief Get the value of a kernel command line parameter.
+ *
+ * @param command_line is the content of /proc/cmdline.
+ * @param key is the parameter name (e.g. "isolcpus").
+ * @param[out] value is the value of the parameter.
+ * @return true if the parameter is present.
+ */
+static bool get_kernel_parameter(const std::string& command_line,
+                                 const std::string& key,
+                                 std::string& value)
+{
+    std::istringstream command_line_stream(command_line);
+    std::string token;
+    while (command_line_stream >> token)
+    {
+        if (token.compare(0, key.size() + 1, key + "=") == 0)
+        {
+            value = token.substr(key.size() + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Get the elements of a that are not in b.
+ */
+static std::vector<int> difference(const std::vector<int>& a,
+                                   const std::vector<int>& b)
+{
+    std::vector<int> result;
+    for (unsigned i = 0; i < a.size(); ++i)
+    {
+        if (std::find(b.begin(), b.end(), a[i]) == b.end())
+        {
+            result.push_back(a[i]);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Get the elements of a that are also in b.
+ */
+static std::vector<int> intersection(const std::vector<int>& a,
+                                     const std::vector<int>& b)
+{
+    return difference(a, difference(a, b));
+}
+
+std::string to_string(AuditStatus status)
+{
+    switch (status)
+    {
+        case AuditStatus::PASS:
+            return "PASS";
+        case AuditStatus::WARN:
+            return "WARN";
+        case AuditStatus::FAIL:
+            return "FAIL";
+    }
+    return "";
+}
+
+RealTimeAuditParameters::RealTimeAuditParameters()
+{
+    rt_cpu_ids_.clear();
+    priority_ = 80;
+    proc_root_ = "/proc";
+    sys_root_ = "/sys";
+    privileged_ = (geteuid() == 0);
+}
+
+RealTimeAudit::RealTimeAudit(const RealTimeAuditParameters& parameters)
+    : parameters_(parameters)
+{
+}
+
+const std::vector<AuditCheck>& RealTimeAudit::run()
+{
+    checks_.clear();
+    if (parameters_.rt_cpu_ids_.empty())
+    {
+        add("rt_cpus",
+            AuditStatus::WARN,
+            "no real time CPU given, the per CPU checks are skipped",
+            "pass the CPUs that will run the real time threads");
+    }
+    check_kernel_command_line();
+    check_preempt_rt();
+    check_cpu_frequency_governor();
+    check_smt_siblings();
+    check_irq_affinity();
+    check_transparent_huge_pages();
+    check_resource_limits();
+    check_rt_throttling();
+    return checks_;
+}
+
+AuditStatus RealTimeAudit::get_status() const
+{
+    AuditStatus status = AuditStatus::PASS;
+    for (unsigned i = 0; i < checks_.size(); ++i)
+    {
+        if (checks_[i].status_ == AuditStatus::FAIL)
+        {
+            return AuditStatus::FAIL;
+        }
+        if (checks_[i].status_ == AuditStatus::WARN)
+        {
+            status = AuditStatus::WARN;
+        }
+    }
+    return status;
+}
+
+void RealTimeAudit::print() const
+{
+    rt_printf("real time audit --------------------------------\n");
+    for (unsigned i = 0; i < checks_.size(); ++i)
+    {
+        rt_printf("[%s] %s: %s\n",
+                  to_string(checks_[i].status_).c_str(),
+                  checks_[i].name_.c_str(),
+                  checks_[i].message_.c_str());
+        if (!checks_[i].fix_.empty())
+        {
+            rt_printf("       fix: %s\n", checks_[i].fix_.c_str());
+        }
+    }
+    rt_printf("result: %s\n", to_string(get_status()).c_str());
+    rt_printf("------------------------------------------------\n");
+}
+
+void RealTimeAudit::add(const std::string& name,
+                        AuditStatus status,
+                        const std::string& message,
+                        const std::string& fix)
+{
+    AuditCheck check;
+    check.name_ = name;
+    check.status_ = status;
+    check.message_ = message;
+    check.fix_ = fix;
+    checks_.push_back(check);
+}
+
+void RealTimeAudit::check_kernel_command_line()
+{
+    std::string command_line;
+    if (!read_first_line(parameters_.proc_root_ + "/cmdline", command_line))
+    {
+        add("cmdline",
+            AuditStatus::WARN,
+            "cannot read " + parameters_.proc_root_ + "/cmdline");
+        return;
+    }
+    const std::string rt_cpu_list = format_cpu_list(parameters_.rt_cpu_ids_);
+    const char* keys[] = {"isolcpus", "nohz_full", "rcu_nocbs"};
+    for (const char* key : keys)
+    {
+        std::string value;
+        if (!get_kernel_parameter(command_line, key, value))
+        {
+            add(key,
+                AuditStatus::WARN,
+                std::string(key) + " is not set",
+                "add " + std::string(key) + "=" + rt_cpu_list +
+                    " to the kernel command line");
+            continue;
+        }
+        std::vector<int> missing =
+            difference(parameters_.rt_cpu_ids_, parse_cpu_list(value));
+        if (missing.empty())
+        {
+            add(key,
+                AuditStatus::PASS,
+                std::string(key) + "=" + value + " covers the real time CPUs");
+        }
+        else
+        {
+            add(key,
+                AuditStatus::WARN,
+                std::string(key) + "=" + value + " does not cover CPU(s) " +
+                    format_cpu_list(missing),
+                "add " + std::string(key) + "=" + rt_cpu_list +
+                    " to the kernel command line");
+        }
+    }
+}
+
+void RealTimeAudit::check_preempt_rt()
+{
+    std::string realtime;
+    std::string version;
+    read_first_line(parameters_.sys_root_ + "/kernel/realtime", realtime);
+    read_first_line(parameters_.proc_root_ + "/version", version);
+    if (realtime == "1" || version.find("PREEMPT_RT") != std::string::npos ||
+        version.find("PREEMPT RT") != std::string::npos)
+    {
+        add("preempt_rt", AuditStatus::PASS, "the kernel is PREEMPT_RT");
+    }
+    else
+    {
+        add("preempt_rt",
+            AuditStatus::WARN,
+            "the kernel is not PREEMPT_RT",
+            "boot a kernel built with CONFIG_PREEMPT_RT");
+    }
+}
+
+void RealTimeAudit::check_cpu_frequency_governor()
+{
+    for (unsigned i = 0; i < parameters_.rt_cpu_ids_.size(); ++i)
+    {
+        const std::string cpu = std::to_string(parameters_.rt_cpu_ids_[i]);
+        const std::string file_name = parameters_.sys_root_ +
+                                      "/devices/system/cpu/cpu" + cpu +
+                                      "/cpufreq/scaling_governor";
+        std::string governor;
+        if (!read_first_line(file_name, governor))
+        {
+            add("governor_cpu" + cpu,
+                AuditStatus::PASS,
+                "no frequency scaling on CPU " + cpu);
+        }
+        else if (governor == "performance")
+        {
+            add("governor_cpu" + cpu,
+                AuditStatus::PASS,
+                "CPU " + cpu + " uses the performance governor");
+        }
+        else
+        {
+            add("governor_cpu" + cpu,
+                AuditStatus::WARN,
+                "CPU " + cpu + " uses the " + governor + " governor",
+                "echo performance > " + file_name);
+        }
+    }
+}
+
+void RealTimeAudit::check_smt_siblings()
+{
+    std::string command_line, isolcpus;
+    read_first_line(parameters_.proc_root_ + "/cmdline", command_line);
+    get_kernel_parameter(command_line, "isolcpus", isolcpus);
+    const std::vector<int> isolated_cpus = parse_cpu_list(isolcpus);
+
+    for (unsigned i = 0; i < parameters_.rt_cpu_ids_.size(); ++i)
+    {
+        const int cpu_id = parameters_.rt_cpu_ids_[i];
+        const std::string cpu = std::to_string(cpu_id);
+        std::string siblings_list;
+        read_first_line(parameters_.sys_root_ + "/devices/system/cpu/cpu" +
+                            cpu + "/topology/thread_siblings_list",
+                        siblings_list);
+        std::vector<int> siblings =
+            difference(parse_cpu_list(siblings_list), {cpu_id});
+        if (siblings.empty())
+        {
+            add("smt_cpu" + cpu,
+                AuditStatus::PASS,
+                "CPU " + cpu + " does not share its core");
+            continue;
+        }
+        std::vector<int> busy_siblings;
+        for (unsigned j = 0; j < siblings.size(); ++j)
+        {
+            bool is_rt =
+                !intersection({siblings[j]}, parameters_.rt_cpu_ids_).empty();
+            bool is_isolated =
+                !intersection({siblings[j]}, isolated_cpus).empty();
+            if (is_rt || !is_isolated)
+            {
+                busy_siblings.push_back(siblings[j]);
+            }
+        }
+        if (busy_siblings.empty())
+        {
+            add("smt_cpu" + cpu,
+                AuditStatus::PASS,
+                "the SMT sibling(s) " + format_cpu_list(siblings) +
+                    " of CPU " + cpu + " are isolated and idle");
+        }
+        else
+        {
+            add("smt_cpu" + cpu,
+                AuditStatus::WARN,
+                "CPU " + cpu + " shares its core with CPU(s) " +
+                    format_cpu_list(busy_siblings),
+                "isolate and keep CPU(s) " + format_cpu_list(busy_siblings) +
+                    " idle, or echo off > " + parameters_.sys_root_ +
+                    "/devices/system/cpu/smt/control");
+        }
+    }
+}
+
+void RealTimeAudit::check_irq_affinity()
+{
+    if (parameters_.rt_cpu_ids_.empty())
+    {
+        return;
+    }
+    const boost::filesystem::path irq_dir(parameters_.proc_root_ + "/irq");
+    boost::system::error_code error;
+    if (!boost::filesystem::is_directory(irq_dir, error))
+    {
+        add("irq_affinity",
+            AuditStatus::WARN,
+            "cannot read " + irq_dir.string());
+        return;
+    }
+
+    std::vector<int> irqs;
+    for (boost::filesystem::directory_iterator it(irq_dir, error), end;
+         !error && it != end;
+         it.increment(error))
+    {
+        const std::string irq = it->path().filename().string();
+        if (irq.empty() || !std::isdigit(irq[0]))
+        {
+            continue;
+        }
+        std::string affinity;
+        if (!read_first_line(it->path().string() + "/smp_affinity_list",
+                             affinity))
+        {
+            continue;
+        }
+        if (!intersection(parse_cpu_list(affinity), parameters_.rt_cpu_ids_)
+                 .empty())
+        {
+            irqs.push_back(std::atoi(irq.c_str()));
+        }
+    }
+    std::sort(irqs.begin(), irqs.end());
+
+    if (irqs.empty())
+    {
+        add("irq_affinity",
+            AuditStatus::PASS,
+            "no IRQ is affine to the real time CPUs");
+        return;
+    }
+    std::string irq_list;
+    for (unsigned i = 0; i < irqs.size(); ++i)
+    {
+        irq_list += (i == 0 ? "" : " ") + std::to_string(irqs[i]);
+    }
+    std::string online;
+    read_first_line(
+        parameters_.sys_root_ + "/devices/system/cpu/online", online);
+    std::string other_cpus = format_cpu_list(
+        difference(parse_cpu_list(online), parameters_.rt_cpu_ids_));
+    if (other_cpus.empty())
+    {
+        add("irq_affinity",
+            AuditStatus::WARN,
+            "IRQ(s) " + irq_list + " may run on the real time CPUs",
+            "keep at least one CPU out of the real time CPUs for the IRQs");
+        return;
+    }
+    add("irq_affinity",
+        AuditStatus::WARN,
+        "IRQ(s) " + irq_list + " may run on the real time CPUs",
+        "echo " + other_cpus + " > " + parameters_.proc_root_ +
+            "/irq/<irq>/smp_affinity_list for these IRQs (and stop "
+            "irqbalance)");
+}
+
+void RealTimeAudit::check_transparent_huge_pages()
+{
+    const std::string file_name =
+        parameters_.sys_root_ + "/kernel/mm/transparent_hugepage/enabled";
+    std::string enabled;
+    if (!read_first_line(file_name, enabled))
+    {
+        add("transparent_hugepage",
+            AuditStatus::PASS,
+            "transparent huge pages are not available");
+    }
+    else if (enabled.find("[always]") != std::string::npos)
+    {
+        add("transparent_hugepage",
+            AuditStatus::WARN,
+            "transparent huge pages are always enabled, khugepaged may "
+            "stall the real time threads",
+            "echo madvise > " + file_name);
+    }
+    else
+    {
+        add("transparent_hugepage",
+            AuditStatus::PASS,
+            "transparent huge pages: " + enabled);
+    }
+}
+
+void RealTimeAudit::check_resource_limits()
+{
+    std::ifstream limits_file(parameters_.proc_root_ + "/self/limits");
+    std::string line, rtprio_limit, memlock_limit;
+    while (std::getline(limits_file, line))
+    {
+        const std::string rtprio_key = "Max realtime priority";
+        const std::string memlock_key = "Max locked memory";
+        if (line.compare(0, rtprio_key.size(), rtprio_key) == 0)
+        {
+            std::istringstream(line.substr(rtprio_key.size())) >> rtprio_limit;
+        }
+        else if (line.compare(0, memlock_key.size(), memlock_key) == 0)
+        {
+            std::istringstream(line.substr(memlock_key.size())) >>
+                memlock_limit;
+        }
+    }
+
+    if (parameters_.privileged_)
+    {
+        add("rlimit_rtprio",
+            AuditStatus::PASS,
+            "the process is privileged, RLIMIT_RTPRIO does not apply");
+    }
+    else if (rtprio_limit == "unlimited" ||
+             (!rtprio_limit.empty() &&
+              std::atoi(rtprio_limit.c_str()) >= parameters_.priority_))
+    {
+        add("rlimit_rtprio",
+            AuditStatus::PASS,
+            "RLIMIT_RTPRIO is " + rtprio_limit);
+    }
+    else
+    {
+        add("rlimit_rtprio",
+            AuditStatus::FAIL,
+            "RLIMIT_RTPRIO is " +
+                (rtprio_limit.empty() ? "unknown" : rtprio_limit) +
+                ", priority " + std::to_string(parameters_.priority_) +
+                " cannot be granted",
+            "add \"@realtime - rtprio 99\" to /etc/security/limits.conf and "
+            "the user to the realtime group");
+    }
+
+    if (parameters_.privileged_)
+    {
+        add("rlimit_memlock",
+            AuditStatus::PASS,
+            "the process is privileged, RLIMIT_MEMLOCK does not apply");
+    }
+    else if (memlock_limit == "unlimited")
+    {
+        add("rlimit_memlock", AuditStatus::PASS, "RLIMIT_MEMLOCK is unlimited");
+    }
+    else
+    {
+        add("rlimit_memlock",
+            AuditStatus::FAIL,
+            "RLIMIT_MEMLOCK is " +
+                (memlock_limit.empty() ? "unknown" : memlock_limit) +
+                " bytes, mlockall(MCL_CURRENT | MCL_FUTURE) will fail",
+            "add \"@realtime - memlock unlimited\" to "
+            "/etc/security/limits.conf and the user to the realtime group");
+    }
+}
+
+void RealTimeAudit::check_rt_throttling()
+{
+    const std::string file_name =
+        parameters_.proc_root_ + "/sys/kernel/sched_rt_runtime_us";
+    std::string runtime;
+    if (!read_first_line(file_name, runtime))
+    {
+        add("sched_rt_runtime_us",
+            AuditStatus::WARN,
+            "cannot read " + file_name);
+    }
+    else if (runtime == "-1")
+    {
+        add("sched_rt_runtime_us",
+            AuditStatus::PASS,
+            "real time threads are not throttled");
+    }
+    else
+    {
+        add("sched_rt_runtime_us",
+            AuditStatus::WARN,
+            "real time threads are throttled to " + runtime +
+                " us per sched_rt_period_us",
+            "echo -1 > " + file_name);
+    }
+}
+
+}  // namespace real_time_tools
@@ -0,0 +1,162 @@
+/**
+ * @file shared_memory_segment.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the mapping of the POSIX shared memory segments.
+ */
+
+#include "real_time_tools/shared_memory_segment.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include "real_time_tools/iostream.hpp"
+
+namespace real_time_tools
+{
+/**
+ * @brief Prepend a '/' to the name of a segment if missing.
+ *
+ * @param name
+ * @return std::string
+ */
+static std::string get_segment_name(const std::string& name)
+{
+    if (!name.empty() && name[0] == '/')
+    {
+        return name;
+    }
+    return "/" + name;
+}
+
+SharedMemorySegment::SharedMemorySegment()
+    : address_(nullptr), size_(0), owner_(false)
+{
+}
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+    if (address_ != nullptr)
+    {
+        munmap(address_, size_);
+    }
+    if (owner_)
+    {
+        shm_unlink(name_.c_str());
+    }
+}
+
+bool SharedMemorySegment::create(const std::string& name,
+                                 std::size_t size,
+                                 bool replace)
+{
+    if (address_ != nullptr)
+    {
+        rt_printf("SharedMemorySegment: %s is already mapped\n", name_.c_str());
+        return false;
+    }
+    name_ = get_segment_name(name);
+    int file_descriptor =
+        shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (file_descriptor == -1 && errno == EEXIST)
+    {
+        if (!replace)
+        {
+            rt_printf(
+                "SharedMemorySegment: %s already exists, another process "
+                "may be using it\n",
+                name_.c_str());
+            return false;
+        }
+        rt_printf("SharedMemorySegment: replacing the existing segment %s\n",
+                  name_.c_str());
+        shm_unlink(name_.c_str());
+        file_descriptor =
+            shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    }
+    if (file_descriptor == -1)
+    {
+        rt_printf("SharedMemorySegment: failed to create %s: %s\n",
+                  name_.c_str(),
+                  std::strerror(errno));
+        return false;
+    }
+    owner_ = true;
+    if (ftruncate(file_descriptor, size) != 0)
+    {
+        rt_printf("SharedMemorySegment: failed to resize %s: %s\n",
+                  name_.c_str(),
+                  std::strerror(errno));
+        close(file_descriptor);
+        return false;
+    }
+    return map(file_descriptor, size);
+}
+
+bool SharedMemorySegment::open(const std::string& name, std::size_t size)
+{
+    if (address_ != nullptr)
+    {
+        rt_printf("SharedMemorySegment: %s is already mapped\n", name_.c_str());
+        return false;
+    }
+    name_ = get_segment_name(name);
+    int file_descriptor = shm_open(name_.c_str(), O_RDWR, 0666);
+    if (file_descriptor == -1)
+    {
+        rt_printf("SharedMemorySegment: failed to open %s: %s\n",
+                  name_.c_str(),
+                  std::strerror(errno));
+        return false;
+    }
+    struct stat status;
+    if (fstat(file_descriptor, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < size)
+    {
+        rt_printf(
+            "SharedMemorySegment: %s is smaller than the %lu bytes expected\n",
+            name_.c_str(),
+            static_cast<unsigned long>(size));
+        close(file_descriptor);
+        return false;
+    }
+    return map(file_descriptor, size);
+}
+
+bool SharedMemorySegment::map(int file_descriptor, std::size_t size)
+{
+    void* address = mmap(nullptr,
+                         size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED,
+                         file_descriptor,
+                         0);
+    close(file_descriptor);
+    if (address == MAP_FAILED)
+    {
+        rt_printf("SharedMemorySegment: failed to map %s: %s\n",
+                  name_.c_str(),
+                  std::strerror(errno));
+        return false;
+    }
+    address_ = address;
+    size_ = size;
+    return true;
+}
+
+uint64_t hash_type_name(const char* type_name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char* c = type_name; *c != '\0'; ++c)
+    {
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+}  // namespace real_time_tools
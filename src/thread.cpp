@@ -10,13 +10,124 @@
  */
 #include "real_time_tools/thread.hpp"
 #include <stdexcept>
+#include "real_time_tools/memory.hpp"
 #include "real_time_tools/process_manager.hpp"
+#include "real_time_tools/thread_health.hpp"
+#ifndef __APPLE__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if defined NON_REAL_TIME
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <cerrno>
+#include <chrono>
+#endif
 
 namespace real_time_tools
 {
+#if defined(RT_PREEMPT) || defined(NON_REAL_TIME)
+
+THREAD_FUNCTION_RETURN_TYPE RealTimeThread::thread_entry(void* self_ptr)
+{
+    RealTimeThread* self = static_cast<RealTimeThread*>(self_ptr);
+#ifndef __APPLE__
+    self->thread_id_.store(static_cast<int>(syscall(SYS_gettid)),
+                           std::memory_order_release);
+#endif
+#if defined NON_REAL_TIME
+    self->apply_best_effort_settings();
+    self->settings_applied_.store(true, std::memory_order_release);
+#endif
+    PageFaults before_prefault;
+    bool counted = get_current_thread_page_faults(before_prefault);
+    if (self->parameters_.prefault_stack_size_ > 0)
+    {
+        prefault_stack(self->parameters_.prefault_stack_size_);
+    }
+    if (self->parameters_.heap_reserve_size_ > 0)
+    {
+        reserve_heap(self->parameters_.heap_reserve_size_);
+    }
+    if (counted &&
+        get_current_thread_page_faults(self->page_faults_after_prefault_))
+    {
+        const PageFaults& after = self->page_faults_after_prefault_;
+        self->prefault_page_faults_.minor_ =
+            after.minor_ - before_prefault.minor_;
+        self->prefault_page_faults_.major_ =
+            after.major_ - before_prefault.major_;
+        self->page_faults_recorded_.store(true, std::memory_order_release);
+    }
+    return self->thread_function_(self->thread_args_);
+}
+
+#endif  // Defined RT_PREEMPT or NON_REAL_TIME
+
+bool RealTimeThread::get_health(ThreadHealth& health) const
+{
+    int thread_id = get_thread_id();
+    if (thread_id < 0)
+    {
+        return false;
+    }
+    return get_thread_health(thread_id, health);
+}
+
+bool RealTimeThread::get_prefault_page_faults(PageFaults& page_faults) const
+{
+    if (!page_faults_recorded_.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    page_faults = prefault_page_faults_;
+    return true;
+}
+
+bool RealTimeThread::get_page_faults_since_prefault(
+    PageFaults& page_faults) const
+{
+    if (!page_faults_recorded_.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    ThreadHealth health;
+    if (!get_health(health))
+    {
+        return false;
+    }
+    page_faults.minor_ =
+        health.minor_page_faults_ - page_faults_after_prefault_.minor_;
+    page_faults.major_ =
+        health.major_page_faults_ - page_faults_after_prefault_.major_;
+    return true;
+}
+
+void RealTimeThread::print_granted_settings() const
+{
+    printf("%s: ", parameters_.keyword_.c_str());
+    if (granted_settings_.fifo_scheduling_)
+    {
+        printf("SCHED_FIFO priority %d", granted_settings_.priority_);
+    }
+    else
+    {
+        printf("SCHED_OTHER nice %d", granted_settings_.nice_);
+    }
+    printf(", cpu affinity %s, memory %s\n",
+           granted_settings_.cpu_affinity_ ? "set" : "not set",
+           granted_settings_.memory_locked_ ? "locked" : "not locked");
+}
+
 #if defined RT_PREEMPT
 
 RealTimeThread::RealTimeThread()
+    : thread_id_(-1),
+      page_faults_recorded_(false),
+      thread_function_(nullptr),
+      thread_args_(nullptr)
 {
     thread_.reset(nullptr);
 }
@@ -48,7 +159,8 @@ int RealTimeThread::create_realtime_thread(void* (*thread_function)(void*),
 {
     if (thread_ != nullptr)
     {
-        printf("Thread already running");
+        printf("Thread already running, join() it first.\n");
+        return EBUSY;
     }
 
     if (parameters_.cpu_dma_latency_ >= 0)
@@ -125,15 +237,21 @@ int RealTimeThread::create_realtime_thread(void* (*thread_function)(void*),
     }
 
     /* Create a pthread with specified attributes */
-    ret = pthread_create(thread_.get(), &attr, thread_function, args);
+    thread_function_ = thread_function;
+    thread_args_ = args;
+    ret = pthread_create(thread_.get(), &attr, &thread_entry, this);
     if (ret)
     {
+        thread_.reset(nullptr);
         printf(
             "%s %d\n",
             ("create pthread failed. Ret=" + rt_preempt_error_message).c_str(),
             ret);
         return ret;
     }
+    granted_settings_.fifo_scheduling_ = true;
+    granted_settings_.priority_ = parameters_.priority_;
+    granted_settings_.memory_locked_ = parameters_.block_memory_;
 
     if (parameters_.cpu_id_.size() > 0)
     {
@@ -144,6 +262,7 @@ int RealTimeThread::create_realtime_thread(void* (*thread_function)(void*),
             CPU_SET(parameters_.cpu_id_[i], &cpuset);
         }
         ret = pthread_setaffinity_np(*thread_, sizeof(cpu_set_t), &cpuset);
+        granted_settings_.cpu_affinity_ = (ret == 0);
         if (ret)
         {
             printf("%s %d\n",
@@ -189,6 +308,8 @@ int RealTimeThread::join()
             printf("join pthread failed.\n");
         }
         thread_.reset(nullptr);
+        thread_id_.store(-1, std::memory_order_release);
+        page_faults_recorded_.store(false, std::memory_order_release);
     }
     return ret;
 }
@@ -210,6 +331,7 @@ void RealTimeThread::block_memory()
 #if defined XENOMAI
 
 RealTimeThread::RealTimeThread()
+    : thread_id_(-1), page_faults_recorded_(false)
 {
 }
 
@@ -274,6 +396,11 @@ void RealTimeThread::block_memory()
 #if defined NON_REAL_TIME
 
 RealTimeThread::RealTimeThread()
+    : thread_id_(-1),
+      page_faults_recorded_(false),
+      settings_applied_(false),
+      thread_function_(nullptr),
+      thread_args_(nullptr)
 {
     thread_.reset(nullptr);
 }
@@ -287,13 +414,80 @@ RealTimeThread::~RealTimeThread()
 int RealTimeThread::create_realtime_thread(void* (*thread_function)(void*),
                                            void* args)
 {
-    printf("Warning this thread is not going to be real time.\n");
+    if (thread_ != nullptr)
+    {
+        printf("Thread already running, join() it first.\n");
+        return EBUSY;
+    }
+
+    granted_settings_ = GrantedThreadSettings();
+    if (parameters_.block_memory_)
+    {
+        block_memory();
+    }
 
     /* Create a standard thread for non-real time OS */
-    thread_.reset(new std::thread(thread_function, args));
+    thread_function_ = thread_function;
+    thread_args_ = args;
+    settings_applied_.store(false, std::memory_order_release);
+    thread_.reset(new std::thread(&thread_entry, this));
+
+    /* Wait for the thread to report what it was granted */
+    while (!settings_applied_.load(std::memory_order_acquire))
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    if (!granted_settings_.fifo_scheduling_)
+    {
+        printf("Warning this thread is not going to be real time.\n");
+    }
+    print_granted_settings();
     return 0;
 }
 
+void RealTimeThread::apply_best_effort_settings()
+{
+    /* cpu affinity */
+#ifndef __APPLE__
+    if (parameters_.cpu_id_.size() > 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (unsigned i = 0; i < parameters_.cpu_id_.size(); ++i)
+        {
+            CPU_SET(parameters_.cpu_id_[i], &cpuset);
+        }
+        granted_settings_.cpu_affinity_ =
+            pthread_setaffinity_np(
+                pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+    }
+#endif
+
+    /* SCHED_FIFO if we have the permission */
+    struct sched_param param;
+    param.sched_priority = parameters_.priority_;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+    {
+        granted_settings_.fifo_scheduling_ = true;
+        granted_settings_.priority_ = parameters_.priority_;
+        return;
+    }
+
+    /* otherwise the lowest nice level allowed (RLIMIT_NICE) */
+#ifndef __APPLE__
+    id_t thread_id = static_cast<id_t>(syscall(SYS_gettid));
+    for (int nice = -20; nice < 0; ++nice)
+    {
+        if (setpriority(PRIO_PROCESS, thread_id, nice) == 0)
+        {
+            break;
+        }
+    }
+    errno = 0;
+    granted_settings_.nice_ = getpriority(PRIO_PROCESS, thread_id);
+#endif
+}
+
 int RealTimeThread::join()
 {
     if (thread_ != nullptr)
@@ -302,13 +496,18 @@ int RealTimeThread::join()
         {
             thread_->join();
         }
+        thread_.reset(nullptr);
+        thread_id_.store(-1, std::memory_order_release);
+        page_faults_recorded_.store(false, std::memory_order_release);
     }
     return 0;
 }
 
 void RealTimeThread::block_memory()
 {
-    // do nothing
+    /* Lock memory if we are allowed to, it is not fatal otherwise */
+    granted_settings_.memory_locked_ =
+        mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
 }
 #endif  // Defined NON_REAL_TIME
 
@@ -0,0 +1,299 @@
+/**
+ * @file thread_health.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the sampling of the thread statistics.
+ */
+
+#include "real_time_tools/thread_health.hpp"
+#include <fstream>
+#include <sstream>
+#ifndef __APPLE__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#include "real_time_tools/iostream.hpp"
+#include "real_time_tools/thread.hpp"
+
+namespace real_time_tools
+{
+ThreadHealth::ThreadHealth()
+    : voluntary_context_switches_(-1),
+      involuntary_context_switches_(-1),
+      minor_page_faults_(-1),
+      major_page_faults_(-1),
+      cpu_migrations_(-1),
+      current_cpu_(-1)
+{
+}
+
+bool get_current_thread_health(ThreadHealth& health)
+{
+    health = ThreadHealth();
+#ifdef __APPLE__
+    return false;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+    {
+        return false;
+    }
+    health.voluntary_context_switches_ = usage.ru_nvcsw;
+    health.involuntary_context_switches_ = usage.ru_nivcsw;
+    health.minor_page_faults_ = usage.ru_minflt;
+    health.major_page_faults_ = usage.ru_majflt;
+    health.current_cpu_ = sched_getcpu();
+    return true;
+#endif
+}
+
+/**
+ * @brief Read the value of a "key: value" line of a /proc file.
+ *
+ * @param file_name is the /proc file.
+ * @param key is the beginning of the line.
+ * @param[out] value is the value read.
+ * @return true if the key was found.
+ */
+static bool read_proc_value(const std::string& file_name,
+                            const std::string& key,
+                            long& value)
+{
+    std::ifstream file(file_name);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, key.size(), key) != 0)
+        {
+            continue;
+        }
+        std::size_t separator = line.find(':', key.size());
+        if (separator == std::string::npos)
+        {
+            return false;
+        }
+        std::istringstream value_stream(line.substr(separator + 1));
+        return static_cast<bool>(value_stream >> value);
+    }
+    return false;
+}
+
+bool get_thread_health(int thread_id, ThreadHealth& health)
+{
+    health = ThreadHealth();
+#ifdef __APPLE__
+    return false;
+#else
+    const std::string task_dir =
+        "/proc/self/task/" + std::to_string(thread_id) + "/";
+
+    // /proc/self/task/<tid>/stat: the command name (field 2) may contain
+    // spaces, so we parse the fields after the last parenthesis. The first
+    // one is the state (field 3).
+    std::ifstream stat_file(task_dir + "stat");
+    std::string stat;
+    if (!std::getline(stat_file, stat))
+    {
+        return false;
+    }
+    std::size_t command_end = stat.rfind(')');
+    if (command_end == std::string::npos)
+    {
+        return false;
+    }
+    std::istringstream stat_stream(stat.substr(command_end + 1));
+    std::vector<std::string> fields;
+    std::string field;
+    while (stat_stream >> field)
+    {
+        fields.push_back(field);
+    }
+    // field n of proc(5) is at index n - 3.
+    if (fields.size() <= 39 - 3)
+    {
+        return false;
+    }
+    health.minor_page_faults_ = std::stol(fields[10 - 3]);
+    health.major_page_faults_ = std::stol(fields[12 - 3]);
+    health.current_cpu_ = std::stoi(fields[39 - 3]);
+
+    read_proc_value(task_dir + "status",
+                    "voluntary_ctxt_switches",
+                    health.voluntary_context_switches_);
+    read_proc_value(task_dir + "status",
+                    "nonvoluntary_ctxt_switches",
+                    health.involuntary_context_switches_);
+    // Only available with CONFIG_SCHED_DEBUG.
+    if (!read_proc_value(
+            task_dir + "sched", "se.nr_migrations", health.cpu_migrations_))
+    {
+        health.cpu_migrations_ = -1;
+    }
+    return true;
+#endif
+}
+
+void print_thread_health(const std::string& name, const ThreadHealth& health)
+{
+    rt_printf("%s --------------------------------\n", name.c_str());
+    rt_printf(
+        "voluntary_context_switches: %ld\n"
+        "involuntary_context_switches: %ld\n"
+        "minor_page_faults: %ld\n"
+        "major_page_faults: %ld\n"
+        "cpu_migrations: %ld\n"
+        "current_cpu: %d\n",
+        health.voluntary_context_switches_,
+        health.involuntary_context_switches_,
+        health.minor_page_faults_,
+        health.major_page_faults_,
+        health.cpu_migrations_,
+        health.current_cpu_);
+    rt_printf("--------------------------------------------\n");
+}
+
+ThreadHealthMonitor::ThreadHealthMonitor(double period_sec)
+    : period_sec_(period_sec), running_(false)
+{
+}
+
+ThreadHealthMonitor::~ThreadHealthMonitor()
+{
+    stop();
+}
+
+void ThreadHealthMonitor::add_thread(const std::string& name,
+                                     const RealTimeThread& thread)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry;
+    entry.name_ = name;
+    entry.thread_ = &thread;
+    entry.thread_id_ = -1;
+    entry.sampled_ = false;
+    entry.observed_migrations_ = 0;
+    entries_.push_back(entry);
+}
+
+void ThreadHealthMonitor::add_thread(const std::string& name, int thread_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry;
+    entry.name_ = name;
+    entry.thread_ = nullptr;
+    entry.thread_id_ = thread_id;
+    entry.sampled_ = false;
+    entry.observed_migrations_ = 0;
+    entries_.push_back(entry);
+}
+
+void ThreadHealthMonitor::start()
+{
+    if (running_.exchange(true))
+    {
+        return;
+    }
+    thread_.reset(new std::thread(&ThreadHealthMonitor::loop, this));
+}
+
+void ThreadHealthMonitor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    condition_.notify_all();
+    if (thread_ != nullptr && thread_->joinable())
+    {
+        thread_->join();
+    }
+    thread_.reset(nullptr);
+}
+
+bool ThreadHealthMonitor::get(const std::string& name,
+                              ThreadHealth& health) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry& entry : entries_)
+    {
+        if (entry.name_ == name && entry.sampled_)
+        {
+            health = entry.health_;
+            if (health.cpu_migrations_ < 0)
+            {
+                health.cpu_migrations_ = entry.observed_migrations_;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadHealthMonitor::print() const
+{
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Entry& entry : entries_)
+        {
+            names.push_back(entry.name_);
+        }
+    }
+    for (const std::string& name : names)
+    {
+        ThreadHealth health;
+        if (get(name, health))
+        {
+            print_thread_health(name, health);
+        }
+    }
+}
+
+void ThreadHealthMonitor::sample()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Entry& entry : entries_)
+    {
+        int thread_id = entry.thread_ != nullptr
+                            ? entry.thread_->get_thread_id()
+                            : entry.thread_id_;
+        ThreadHealth health;
+        if (thread_id < 0 || !get_thread_health(thread_id, health))
+        {
+            continue;
+        }
+        if (entry.sampled_ &&
+            health.current_cpu_ != entry.health_.current_cpu_)
+        {
+            ++entry.observed_migrations_;
+        }
+        entry.health_ = health;
+        entry.sampled_ = true;
+    }
+}
+
+void ThreadHealthMonitor::loop()
+{
+#ifndef __APPLE__
+    // Lowest priority of the normal scheduling class, we do not want to
+    // compete with anything.
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        lock.unlock();
+        sample();
+        lock.lock();
+        condition_.wait_for(lock,
+                            std::chrono::duration<double>(period_sec_),
+                            [this] { return !running_; });
+    }
+}
+
+}  // namespace real_time_tools
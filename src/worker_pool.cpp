@@ -0,0 +1,191 @@
+/**
+ * @file worker_pool.cpp
+ * license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ *
+ * @brief Implement the pool of real time worker threads.
+ */
+
+#include "real_time_tools/worker_pool.hpp"
+#include "real_time_tools/futex.hpp"
+#include "real_time_tools/timer.hpp"
+
+namespace real_time_tools
+{
+WorkerPool::WorkerPool()
+    : spin_duration_sec_(50e-6),
+      generation_(0),
+      nb_sleeping_workers_(0),
+      nb_pending_workers_(0),
+      joiner_sleeping_(false),
+      next_task_(0),
+      stopping_(false),
+      task_(nullptr),
+      task_args_(nullptr),
+      nb_tasks_(0)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+bool WorkerPool::start(const std::vector<int>& cpu_ids,
+                       const RealTimeThreadParameters& parameters)
+{
+    stop();
+    stopping_ = false;
+    // Every worker decrements this once it is ready to receive jobs.
+    nb_pending_workers_ = static_cast<uint32_t>(cpu_ids.size());
+    for (std::size_t i = 0; i < cpu_ids.size(); ++i)
+    {
+        std::unique_ptr<RealTimeThread> worker(new RealTimeThread());
+        worker->parameters_ = parameters;
+        worker->parameters_.cpu_id_ = {cpu_ids[i]};
+        // The memory of the process is locked once at most.
+        worker->parameters_.block_memory_ = parameters.block_memory_ && i == 0;
+        int ret =
+            worker->create_realtime_thread(&WorkerPool::worker_loop, this);
+        if (ret != 0)
+        {
+            rt_printf("WorkerPool: could not spawn worker %lu. Ret= %d\n",
+                      static_cast<unsigned long>(i),
+                      ret);
+            nb_pending_workers_ -= static_cast<uint32_t>(cpu_ids.size() - i);
+            stop();
+            return false;
+        }
+        workers_.push_back(std::move(worker));
+    }
+    while (nb_pending_workers_.load() != 0)
+    {
+        Timer::sleep_sec(1e-4);
+    }
+    return true;
+}
+
+void WorkerPool::stop()
+{
+    stopping_ = true;
+    generation_.fetch_add(1);
+    futex_wake(generation_);
+    for (std::size_t i = 0; i < workers_.size(); ++i)
+    {
+        workers_[i]->join();
+    }
+    workers_.clear();
+}
+
+void WorkerPool::run_tasks()
+{
+    std::size_t task_index = next_task_.fetch_add(1);
+    while (task_index < nb_tasks_)
+    {
+        task_(task_args_, task_index);
+        task_index = next_task_.fetch_add(1);
+    }
+}
+
+void WorkerPool::parallel_for(TaskFunction task,
+                              void* args,
+                              std::size_t nb_tasks)
+{
+    if (workers_.empty() || nb_tasks <= 1)
+    {
+        for (std::size_t i = 0; i < nb_tasks; ++i)
+        {
+            task(args, i);
+        }
+        return;
+    }
+
+    // fork ----------------------------------------------------------------
+    // All workers finished the previous job, nobody reads these.
+    task_ = task;
+    task_args_ = args;
+    nb_tasks_ = nb_tasks;
+    next_task_.store(0, std::memory_order_relaxed);
+    nb_pending_workers_.store(static_cast<uint32_t>(workers_.size()),
+                              std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_seq_cst);
+    if (nb_sleeping_workers_.load(std::memory_order_seq_cst) != 0)
+    {
+        futex_wake(generation_);
+    }
+
+    run_tasks();
+
+    // join ----------------------------------------------------------------
+    double spin_deadline = Timer::get_current_time_sec() + spin_duration_sec_;
+    unsigned count = 0;
+    while (nb_pending_workers_.load(std::memory_order_acquire) != 0)
+    {
+        cpu_relax();
+        if (++count % 64 == 0 &&
+            Timer::get_current_time_sec() > spin_deadline)
+        {
+            joiner_sleeping_.store(true, std::memory_order_seq_cst);
+            uint32_t pending;
+            while ((pending = nb_pending_workers_.load(
+                        std::memory_order_seq_cst)) != 0)
+            {
+                futex_wait(nb_pending_workers_, pending);
+            }
+            joiner_sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+THREAD_FUNCTION_RETURN_TYPE WorkerPool::worker_loop(void* pool_ptr)
+{
+    WorkerPool* pool = static_cast<WorkerPool*>(pool_ptr);
+    uint32_t last_generation = pool->generation_.load();
+    pool->nb_pending_workers_.fetch_sub(1);
+
+    while (true)
+    {
+        // wait for the next job --------------------------------------------
+        double spin_deadline =
+            Timer::get_current_time_sec() + pool->spin_duration_sec_;
+        unsigned count = 0;
+        uint32_t generation;
+        while ((generation = pool->generation_.load(
+                    std::memory_order_acquire)) == last_generation)
+        {
+            // stop() may have been called before we read the generation.
+            if (pool->stopping_.load())
+            {
+                return THREAD_FUNCTION_RETURN_VALUE;
+            }
+            cpu_relax();
+            if (++count % 64 == 0 &&
+                Timer::get_current_time_sec() > spin_deadline)
+            {
+                pool->nb_sleeping_workers_.fetch_add(1,
+                                                     std::memory_order_seq_cst);
+                futex_wait(pool->generation_, last_generation);
+                pool->nb_sleeping_workers_.fetch_sub(1);
+            }
+        }
+        last_generation = generation;
+        if (pool->stopping_.load())
+        {
+            break;
+        }
+
+        // work -------------------------------------------------------------
+        pool->run_tasks();
+
+        // signal the end of the job ----------------------------------------
+        pool->nb_pending_workers_.fetch_sub(1, std::memory_order_seq_cst);
+        if (pool->joiner_sleeping_.load(std::memory_order_seq_cst))
+        {
+            futex_wake(pool->nb_pending_workers_);
+        }
+    }
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+}  // namespace real_time_tools
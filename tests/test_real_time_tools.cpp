@@ -12,14 +12,22 @@
  */
 
 #include <gtest/gtest.h>
+#include <cerrno>
 #include <fstream>
 #include <memory>
+#include "real_time_tools/cpu_topology.hpp"
 #include "real_time_tools/frequency_manager.hpp"
 #include "real_time_tools/iostream.hpp"
+#include "real_time_tools/memory.hpp"
+#include "real_time_tools/periodic_task.hpp"
+#include "real_time_tools/process_manager.hpp"
+#include "real_time_tools/realtime_audit.hpp"
 #include "real_time_tools/realtime_check.hpp"
 #include "real_time_tools/spinner.hpp"
 #include "real_time_tools/thread.hpp"
+#include "real_time_tools/thread_health.hpp"
 #include "real_time_tools/timer.hpp"
+#include "real_time_tools/worker_pool.hpp"
 
 // We use this in the unnittest for code simplicity
 using namespace real_time_tools;
@@ -152,6 +160,191 @@ TEST_F(TestRealTimeTools, test_thread_execution)
     ASSERT_TRUE(data);
 }
 
+/**
+ * @brief Memory used by every cycle of rt_thread_page_faults(), it fits in
+ * the pre-faulted stack and heap.
+ */
+const std::size_t CYCLE_MEMORY_SIZE = 64 * 1024;
+
+/**
+ * @brief Arguments of rt_thread_page_faults().
+ */
+struct PageFaultLoop
+{
+    PageFaultLoop() : counter(100), stop(false)
+    {
+    }
+    /** @brief Counts the page faults of the cycles. */
+    PageFaultCounter counter;
+    /** @brief The thread exits once it is set, after the cycles. */
+    std::atomic<bool> stop;
+};
+
+void* rt_thread_page_faults(void* loop_pointer)
+{
+    PageFaultLoop* loop = static_cast<PageFaultLoop*>(loop_pointer);
+    PageFaultCounter* counter = &loop->counter;
+    counter->start();
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        volatile char on_stack[CYCLE_MEMORY_SIZE];
+        on_stack[0] = 1;
+        on_stack[CYCLE_MEMORY_SIZE - 1] = 1;
+        std::unique_ptr<char[]> on_heap(new char[CYCLE_MEMORY_SIZE]);
+        for (std::size_t j = 0; j < CYCLE_MEMORY_SIZE; j += 1024)
+        {
+            on_heap[j] = on_stack[0];
+        }
+        counter->tick();
+    }
+    while (!loop->stop.load())
+    {
+        Timer::sleep_sec(0.001);
+    }
+    return nullptr;
+}
+
+TEST_F(TestRealTimeTools, test_thread_prefault_memory)
+{
+    PageFaultLoop loop;
+    PageFaultCounter& counter = loop.counter;
+    RealTimeThread thread;
+    thread.parameters_.prefault_stack_size_ = 4 * CYCLE_MEMORY_SIZE;
+    thread.parameters_.heap_reserve_size_ = 4 * CYCLE_MEMORY_SIZE;
+    thread.create_realtime_thread(rt_thread_page_faults, &loop);
+    while (!counter.is_done())
+    {
+        Timer::sleep_sec(0.001);
+    }
+    PageFaults prefault, since_prefault;
+    bool prefault_counted = thread.get_prefault_page_faults(prefault);
+    bool since_prefault_counted =
+        thread.get_page_faults_since_prefault(since_prefault);
+    loop.stop = true;
+    thread.join();
+    // the faults were taken by the pre-faulting, none since.
+    ASSERT_TRUE(prefault_counted);
+    ASSERT_GE(prefault.minor_, 0);
+    ASSERT_TRUE(since_prefault_counted);
+    ASSERT_EQ(since_prefault.major_, 0);
+    ASSERT_EQ(since_prefault.minor_, 0);
+    ASSERT_FALSE(thread.get_prefault_page_faults(prefault));
+    counter.print();
+    ASSERT_TRUE(counter.is_done());
+    ASSERT_EQ(counter.get_major_page_faults(), 0);
+    ASSERT_EQ(counter.get_minor_page_faults(), 0);
+}
+
+void* rt_thread_sleep_until_stopped(void* stop_pointer)
+{
+    std::atomic<bool>* stop = static_cast<std::atomic<bool>*>(stop_pointer);
+    while (!stop->load())
+    {
+        Timer::sleep_sec(0.001);
+    }
+    return nullptr;
+}
+
+TEST_F(TestRealTimeTools, test_thread_restart)
+{
+    std::atomic<bool> stop(false);
+    RealTimeThread thread;
+    ASSERT_EQ(thread.create_realtime_thread(rt_thread_sleep_until_stopped,
+                                            &stop),
+              0);
+    // a running thread is not replaced.
+    ASSERT_EQ(thread.create_realtime_thread(rt_thread_sleep_until_stopped,
+                                            &stop),
+              EBUSY);
+    stop = true;
+    thread.join();
+    // a joined thread can be started again.
+    bool data = false;
+    ASSERT_EQ(thread.create_realtime_thread(set_bool_to_true, &data), 0);
+    thread.join();
+    ASSERT_TRUE(data);
+}
+
+TEST_F(TestRealTimeTools, test_thread_health_monitor)
+{
+    ThreadHealth own_health;
+    ASSERT_TRUE(get_current_thread_health(own_health));
+    ASSERT_GE(own_health.current_cpu_, 0);
+    ASSERT_GE(own_health.minor_page_faults_, 0);
+
+    std::atomic<bool> stop(false);
+    RealTimeThread thread;
+    ThreadHealthMonitor monitor(0.01);
+    monitor.add_thread("sleeping thread", thread);
+    monitor.start();
+    thread.create_realtime_thread(rt_thread_sleep_until_stopped, &stop);
+    Timer::sleep_sec(0.2);
+
+    ThreadHealth health;
+    ASSERT_TRUE(monitor.get("sleeping thread", health));
+    ASSERT_FALSE(monitor.get("unknown thread", health));
+    monitor.print();
+    // the thread sleeps every millisecond
+    ASSERT_GT(health.voluntary_context_switches_, 0);
+    ASSERT_GE(health.involuntary_context_switches_, 0);
+    ASSERT_GE(health.minor_page_faults_, 0);
+    ASSERT_GE(health.major_page_faults_, 0);
+    ASSERT_GE(health.cpu_migrations_, 0);
+    ASSERT_GE(health.current_cpu_, 0);
+
+    stop = true;
+    thread.join();
+    monitor.stop();
+    ASSERT_FALSE(thread.get_health(health));
+}
+
+/**
+ * @brief Scheduling observed from within a thread.
+ */
+struct ObservedScheduling
+{
+    int cpu_;
+    int policy_;
+    int priority_;
+};
+
+void* observe_scheduling(void* data)
+{
+    ObservedScheduling* observed = static_cast<ObservedScheduling*>(data);
+    struct sched_param param;
+    pthread_getschedparam(pthread_self(), &observed->policy_, &param);
+    observed->priority_ = param.sched_priority;
+    observed->cpu_ = sched_getcpu();
+    return nullptr;
+}
+
+TEST_F(TestRealTimeTools, test_thread_granted_settings)
+{
+    ObservedScheduling observed;
+    RealTimeThread thread;
+    thread.parameters_.cpu_id_ = {0};
+    thread.parameters_.priority_ = 10;
+    thread.parameters_.block_memory_ = false;
+    thread.create_realtime_thread(observe_scheduling, &observed);
+    thread.join();
+
+    const GrantedThreadSettings& granted = thread.get_granted_settings();
+    if (granted.cpu_affinity_)
+    {
+        ASSERT_EQ(observed.cpu_, 0);
+    }
+    if (granted.fifo_scheduling_)
+    {
+        ASSERT_EQ(observed.policy_, SCHED_FIFO);
+        ASSERT_EQ(observed.priority_, 10);
+    }
+    else
+    {
+        ASSERT_EQ(observed.policy_, SCHED_OTHER);
+    }
+    ASSERT_FALSE(granted.memory_locked_);
+}
+
 TEST_F(TestRealTimeTools, test_timer_dump)
 {
     for (unsigned i = 0; i < 1000; ++i)
@@ -229,6 +422,389 @@ TEST_F(TestRealTimeTools, test_iostream_get_current_date_str)
     std::cout << real_time_tools::Timer::get_current_date_str() << std::endl;
 }
 
+/**
+ * @brief Write a file of a fake sysfs/procfs tree, creating the directories.
+ */
+void write_fixture_file(const std::string& file_name,
+                        const std::string& content)
+{
+    boost::filesystem::create_directories(
+        boost::filesystem::path(file_name).parent_path());
+    std::ofstream file(file_name);
+    file << content;
+}
+
+/**
+ * @brief Read the first word of a file of a fake sysfs/procfs tree.
+ */
+std::string read_fixture_file(const std::string& file_name)
+{
+    std::ifstream file(file_name);
+    std::string content;
+    file >> content;
+    return content;
+}
+
+TEST_F(TestRealTimeTools, test_dma_latency_guard_per_cpu)
+{
+    std::string sys_root = "/tmp/.real_time_tools_test/sys";
+    boost::filesystem::remove_all(sys_root);
+    std::string cpu_dir = sys_root + "/devices/system/cpu/cpu0/";
+    write_fixture_file(cpu_dir + "power/pm_qos_resume_latency_us", "0\n");
+    const char* names[] = {"POLL", "C1", "C6"};
+    const char* latencies[] = {"0", "2", "85"};
+    for (int i = 0; i < 3; ++i)
+    {
+        std::string state_dir = cpu_dir + "cpuidle/state" + std::to_string(i);
+        write_fixture_file(state_dir + "/name", names[i]);
+        write_fixture_file(state_dir + "/latency", latencies[i]);
+        write_fixture_file(state_dir + "/disable", "0");
+        write_fixture_file(state_dir + "/usage", "5");
+    }
+
+    std::vector<CpuIdleState> states;
+    ASSERT_TRUE(get_cpu_idle_states(0, states, sys_root));
+    ASSERT_EQ(states.size(), 3u);
+    ASSERT_EQ(states[2].name_, "C6");
+    ASSERT_EQ(states[2].latency_us_, 85);
+    ASSERT_EQ(states[2].usage_, 5u);
+    ASSERT_FALSE(get_cpu_idle_states(1, states, sys_root));
+
+    // only the states still entered and not disabled are reported.
+    std::vector<CpuIdleState> states_before, states_after;
+    ASSERT_TRUE(get_cpu_idle_states(0, states_before, sys_root));
+    write_fixture_file(cpu_dir + "cpuidle/state0/usage", "9");
+    write_fixture_file(cpu_dir + "cpuidle/state2/usage", "6");
+    write_fixture_file(cpu_dir + "cpuidle/state2/disable", "1");
+    ASSERT_TRUE(get_cpu_idle_states(0, states_after, sys_root));
+    states = get_entered_idle_states(states_before, states_after);
+    ASSERT_EQ(states.size(), 1u);
+    ASSERT_EQ(states[0].name_, "POLL");
+    write_fixture_file(cpu_dir + "cpuidle/state2/disable", "0");
+    ASSERT_TRUE(get_cpu_idle_states(0, states_after, sys_root));
+    states = get_entered_idle_states(states_before, states_after);
+    ASSERT_EQ(states.size(), 2u);
+    ASSERT_EQ(states[1].name_, "C6");
+
+    {
+        DmaLatencyGuard guard(10, {0}, sys_root);
+        ASSERT_TRUE(guard.is_active());
+        ASSERT_EQ(read_fixture_file(cpu_dir + "power/pm_qos_resume_latency_us"),
+                  "10");
+        ASSERT_TRUE(guard.is_applied(0));
+        ASSERT_FALSE(guard.is_applied(1));
+        // the fake CPU never idles: no state is entered.
+        ASSERT_TRUE(guard.get_enabled_idle_states(0, states, 0.0));
+        ASSERT_TRUE(states.empty());
+        // the CPUs that the guard does not constrain are not checked.
+        ASSERT_FALSE(guard.get_enabled_idle_states(1, states, 0.0));
+        // the value read back tells if the kernel kept the constraint.
+        write_fixture_file(cpu_dir + "power/pm_qos_resume_latency_us", "0");
+        ASSERT_FALSE(guard.is_applied(0));
+    }
+    ASSERT_EQ(read_fixture_file(cpu_dir + "power/pm_qos_resume_latency_us"),
+              "0");
+
+    {
+        // 0 us is written "n/a" as "0" means no constraint
+        DmaLatencyGuard guard(0, {0}, sys_root);
+        ASSERT_EQ(read_fixture_file(cpu_dir + "power/pm_qos_resume_latency_us"),
+                  "n/a");
+        ASSERT_TRUE(guard.is_applied(0));
+    }
+    ASSERT_EQ(read_fixture_file(cpu_dir + "power/pm_qos_resume_latency_us"),
+              "0");
+
+    DmaLatencyGuard missing_cpu(0, {7}, sys_root);
+    ASSERT_FALSE(missing_cpu.is_active());
+}
+
+TEST_F(TestRealTimeTools, test_cpu_performance_guard)
+{
+    std::string sys_root = "/tmp/.real_time_tools_test/cpufreq/sys";
+    boost::filesystem::remove_all(sys_root);
+    std::string cpu_dir = sys_root + "/devices/system/cpu/cpu1/";
+    write_fixture_file(cpu_dir + "cpufreq/scaling_governor", "powersave\n");
+    write_fixture_file(cpu_dir + "cpufreq/scaling_min_freq", "800000\n");
+    write_fixture_file(cpu_dir + "cpufreq/cpuinfo_max_freq", "4200000\n");
+    const char* names[] = {"POLL", "C1", "C6"};
+    const char* latencies[] = {"0", "2", "85"};
+    for (int i = 0; i < 3; ++i)
+    {
+        std::string state_dir = cpu_dir + "cpuidle/state" + std::to_string(i);
+        write_fixture_file(state_dir + "/name", names[i]);
+        write_fixture_file(state_dir + "/latency", latencies[i]);
+        write_fixture_file(state_dir + "/disable", "0");
+    }
+
+    {
+        CpuPerformanceGuard guard({1}, sys_root);
+        ASSERT_TRUE(guard.set_governor());
+        ASSERT_TRUE(guard.set_min_frequency());
+        ASSERT_TRUE(guard.disable_idle_state("C6"));
+        ASSERT_EQ(read_fixture_file(cpu_dir + "cpufreq/scaling_governor"),
+                  "performance");
+        ASSERT_EQ(read_fixture_file(cpu_dir + "cpufreq/scaling_min_freq"),
+                  "4200000");
+        ASSERT_EQ(read_fixture_file(cpu_dir + "cpuidle/state2/disable"), "1");
+        ASSERT_EQ(read_fixture_file(cpu_dir + "cpuidle/state1/disable"), "0");
+        ASSERT_TRUE(guard.disable_idle_states(0));
+        ASSERT_EQ(read_fixture_file(cpu_dir + "cpuidle/state1/disable"), "1");
+        ASSERT_EQ(read_fixture_file(cpu_dir + "cpuidle/state0/disable"), "0");
+        ASSERT_FALSE(guard.disable_idle_state("C10"));
+    }
+    ASSERT_EQ(read_fixture_file(cpu_dir + "cpufreq/scaling_governor"),
+              "powersave");
+    ASSERT_EQ(read_fixture_file(cpu_dir + "cpufreq/scaling_min_freq"),
+              "800000");
+    ASSERT_EQ(read_fixture_file(cpu_dir + "cpuidle/state1/disable"), "0");
+    ASSERT_EQ(read_fixture_file(cpu_dir + "cpuidle/state2/disable"), "0");
+
+    CpuPerformanceGuard missing_cpu({7}, sys_root);
+    ASSERT_FALSE(missing_cpu.set_governor());
+    ASSERT_FALSE(missing_cpu.disable_idle_states(0));
+}
+
+TEST_F(TestRealTimeTools, test_irq_affinity_guard)
+{
+    std::string proc_root = "/tmp/.real_time_tools_test/irq/proc";
+    boost::filesystem::remove_all(proc_root);
+    write_fixture_file(proc_root + "/irq/0/smp_affinity_list", "0\n");
+    write_fixture_file(proc_root + "/irq/16/smp_affinity_list", "0-3\n");
+    boost::filesystem::create_directories(proc_root + "/irq/16/ehci_hcd:usb1");
+    boost::filesystem::create_directories(proc_root + "/irq/16/i801_smbus");
+    write_fixture_file(proc_root + "/irq/42/smp_affinity_list", "0-3\n");
+    boost::filesystem::create_directories(proc_root + "/irq/42/xhci_hcd");
+    write_fixture_file(proc_root + "/irq/default_smp_affinity", "f\n");
+
+    std::vector<IrqInfo> irqs;
+    ASSERT_TRUE(get_irqs(irqs, proc_root));
+    ASSERT_EQ(irqs.size(), 3u);
+    ASSERT_EQ(irqs[1].irq_, 16);
+    ASSERT_EQ(irqs[1].devices_,
+              std::vector<std::string>({"ehci_hcd:usb1", "i801_smbus"}));
+    ASSERT_EQ(irqs[1].cpu_ids_, std::vector<int>({0, 1, 2, 3}));
+    ASSERT_TRUE(find_irqs("hcd", irqs, proc_root));
+    ASSERT_EQ(irqs.size(), 2u);
+    ASSERT_FALSE(get_irqs(irqs, proc_root + "/missing"));
+
+    {
+        IrqAffinityGuard guard(proc_root);
+        // the USB controller goes to the cpu reading the device ...
+        ASSERT_EQ(guard.move_irqs_to("xhci", {3}), 1);
+        ASSERT_EQ(read_fixture_file(proc_root + "/irq/42/smp_affinity_list"),
+                  "3");
+        // ... and everything else away from the real time cpus 2-3.
+        ASSERT_EQ(guard.move_irqs_away_from("", {2, 3}), 1);
+        ASSERT_EQ(read_fixture_file(proc_root + "/irq/16/smp_affinity_list"),
+                  "0-1");
+        ASSERT_EQ(read_fixture_file(proc_root + "/irq/0/smp_affinity_list"),
+                  "0");
+        ASSERT_EQ(guard.get_moved_irqs(), std::vector<int>({42, 16}));
+    }
+    ASSERT_EQ(read_fixture_file(proc_root + "/irq/42/smp_affinity_list"),
+              "0-3");
+    ASSERT_EQ(read_fixture_file(proc_root + "/irq/16/smp_affinity_list"),
+              "0-3");
+}
+
+TEST_F(TestRealTimeTools, test_cpu_list)
+{
+    std::vector<int> cpus = parse_cpu_list("nohz,domain,5,0-2,2");
+    ASSERT_EQ(cpus, std::vector<int>({0, 1, 2, 5}));
+    ASSERT_EQ(format_cpu_list(cpus), "0-2,5");
+    ASSERT_EQ(format_cpu_list({7, 3, 4}), "3-4,7");
+    ASSERT_TRUE(parse_cpu_list("").empty());
+}
+
+TEST_F(TestRealTimeTools, test_cpu_list_groups)
+{
+    // the first 2 CPUs of each group of 4.
+    ASSERT_EQ(parse_cpu_list("0-7:2/4"), std::vector<int>({0, 1, 4, 5}));
+    ASSERT_EQ(parse_cpu_list("nohz,2-9:1/3,12"),
+              std::vector<int>({2, 5, 8, 12}));
+    ASSERT_EQ(parse_cpu_list("0-3:4/4"), std::vector<int>({0, 1, 2, 3}));
+    // malformed groups are ignored rather than read as the whole range.
+    ASSERT_TRUE(parse_cpu_list("0-7:2").empty());
+    ASSERT_TRUE(parse_cpu_list("0-7:5/4").empty());
+    ASSERT_TRUE(parse_cpu_list("0-7:2/0").empty());
+}
+
+/**
+ * @brief Get the status of a check of the audit by name.
+ */
+AuditStatus get_audit_status(const RealTimeAudit& audit,
+                             const std::string& name)
+{
+    for (const AuditCheck& check : audit.get_checks())
+    {
+        if (check.name_ == name)
+        {
+            return check.status_;
+        }
+    }
+    ADD_FAILURE() << "no check named " << name;
+    return AuditStatus::FAIL;
+}
+
+TEST_F(TestRealTimeTools, test_realtime_audit)
+{
+    std::string root = "/tmp/.real_time_tools_test/audit";
+    boost::filesystem::remove_all(root);
+    std::string proc = root + "/proc";
+    std::string cpu_dir = root + "/sys/devices/system/cpu/";
+
+    // a badly configured host: only isolcpus covers the real time cpus 2-3.
+    write_fixture_file(proc + "/cmdline",
+                       "BOOT_IMAGE=/vmlinuz isolcpus=nohz,domain,2-3 "
+                       "nohz_full=3\n");
+    write_fixture_file(proc + "/version", "Linux version 5.15.0-generic\n");
+    write_fixture_file(cpu_dir + "online", "0-3\n");
+    const char* siblings[] = {"0,2", "1,3", "0,2", "1,3"};
+    for (int cpu = 0; cpu < 4; ++cpu)
+    {
+        std::string dir = cpu_dir + "cpu" + std::to_string(cpu);
+        write_fixture_file(dir + "/topology/thread_siblings_list",
+                           siblings[cpu]);
+        write_fixture_file(dir + "/cpufreq/scaling_governor",
+                           cpu == 2 ? "powersave\n" : "performance\n");
+    }
+    write_fixture_file(proc + "/irq/0/smp_affinity_list", "0\n");
+    write_fixture_file(proc + "/irq/42/smp_affinity_list", "0-3\n");
+    write_fixture_file(root + "/sys/kernel/mm/transparent_hugepage/enabled",
+                       "[always] madvise never\n");
+    write_fixture_file(proc + "/self/limits",
+                       "Limit                     Soft Limit           "
+                       "Hard Limit           Units\n"
+                       "Max locked memory         8388608              "
+                       "8388608              bytes\n"
+                       "Max realtime priority     0                    "
+                       "0\n");
+    write_fixture_file(proc + "/sys/kernel/sched_rt_runtime_us", "950000\n");
+
+    RealTimeAuditParameters parameters;
+    parameters.rt_cpu_ids_ = {2, 3};
+    parameters.proc_root_ = proc;
+    parameters.sys_root_ = root + "/sys";
+    parameters.privileged_ = false;
+    RealTimeAudit audit(parameters);
+    audit.run();
+    audit.print();
+
+    ASSERT_EQ(audit.get_status(), AuditStatus::FAIL);
+    ASSERT_EQ(get_audit_status(audit, "isolcpus"), AuditStatus::PASS);
+    ASSERT_EQ(get_audit_status(audit, "nohz_full"), AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "rcu_nocbs"), AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "preempt_rt"), AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "governor_cpu2"), AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "governor_cpu3"), AuditStatus::PASS);
+    ASSERT_EQ(get_audit_status(audit, "smt_cpu2"), AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "irq_affinity"), AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "transparent_hugepage"),
+              AuditStatus::WARN);
+    ASSERT_EQ(get_audit_status(audit, "rlimit_rtprio"), AuditStatus::FAIL);
+    ASSERT_EQ(get_audit_status(audit, "rlimit_memlock"), AuditStatus::FAIL);
+    ASSERT_EQ(get_audit_status(audit, "sched_rt_runtime_us"),
+              AuditStatus::WARN);
+    for (const AuditCheck& check : audit.get_checks())
+    {
+        ASSERT_TRUE(check.status_ == AuditStatus::PASS || !check.fix_.empty())
+            << check.name_;
+    }
+
+    // fix everything.
+    write_fixture_file(proc + "/cmdline",
+                       "isolcpus=0-3 nohz_full=2-3 rcu_nocbs=2-3\n");
+    write_fixture_file(root + "/sys/kernel/realtime", "1\n");
+    write_fixture_file(cpu_dir + "cpu2/cpufreq/scaling_governor",
+                       "performance\n");
+    write_fixture_file(proc + "/irq/42/smp_affinity_list", "0-1\n");
+    write_fixture_file(root + "/sys/kernel/mm/transparent_hugepage/enabled",
+                       "always [madvise] never\n");
+    write_fixture_file(proc + "/self/limits",
+                       "Max locked memory         unlimited            "
+                       "unlimited            bytes\n"
+                       "Max realtime priority     99                   "
+                       "99\n");
+    write_fixture_file(proc + "/sys/kernel/sched_rt_runtime_us", "-1\n");
+    audit.run();
+    audit.print();
+    ASSERT_EQ(audit.get_status(), AuditStatus::PASS);
+}
+
+TEST_F(TestRealTimeTools, test_cpu_topology)
+{
+    // 4 cores with 2 hyperthreads (cpu i and i + 4), cores 0-1 and 2-3 share
+    // an L2, cores 2 and 3 are isolated.
+    std::string sys_root = "/tmp/.real_time_tools_test/topology";
+    boost::filesystem::remove_all(sys_root);
+    std::string cpu_root = sys_root + "/devices/system/cpu/";
+    write_fixture_file(cpu_root + "online", "0-7\n");
+    write_fixture_file(cpu_root + "isolated", "2-3,6-7\n");
+    for (int cpu = 0; cpu < 8; ++cpu)
+    {
+        int core = cpu % 4;
+        std::string dir = cpu_root + "cpu" + std::to_string(cpu) + "/";
+        write_fixture_file(dir + "topology/physical_package_id", "0\n");
+        write_fixture_file(dir + "topology/core_id", std::to_string(core));
+        write_fixture_file(dir + "topology/thread_siblings_list",
+                           format_cpu_list({core, core + 4}));
+        write_fixture_file(dir + "cache/index0/level", "1\n");
+        write_fixture_file(dir + "cache/index0/type", "Data\n");
+        write_fixture_file(dir + "cache/index0/size", "48K\n");
+        write_fixture_file(dir + "cache/index0/shared_cpu_list",
+                           format_cpu_list({core, core + 4}));
+        int cluster = core / 2 * 2;
+        write_fixture_file(dir + "cache/index1/level", "2\n");
+        write_fixture_file(dir + "cache/index1/type", "Unified\n");
+        write_fixture_file(dir + "cache/index1/size", "2M\n");
+        write_fixture_file(
+            dir + "cache/index1/shared_cpu_list",
+            format_cpu_list({cluster, cluster + 1, cluster + 4, cluster + 5}));
+    }
+
+    CpuTopology topology;
+    ASSERT_FALSE(topology.load(sys_root + "/missing"));
+    ASSERT_TRUE(topology.load(sys_root));
+    topology.print();
+    ASSERT_EQ(topology.get_cpus().size(), 8u);
+    ASSERT_EQ(topology.get_physical_cores().size(), 4u);
+    ASSERT_EQ(topology.get_isolated_cpus(), std::vector<int>({2, 3, 6, 7}));
+    CpuInfo cpu;
+    ASSERT_TRUE(topology.get_cpu(5, cpu));
+    ASSERT_EQ(cpu.core_id_, 1);
+    ASSERT_EQ(cpu.caches_.size(), 2u);
+    ASSERT_EQ(cpu.caches_[1].size_kb_, 2048);
+    ASSERT_EQ(topology.get_cache_shared_cpus(5, 2),
+              std::vector<int>({0, 1, 4, 5}));
+
+    ASSERT_EQ(topology.find_isolated_core(), 2);
+    ASSERT_EQ(topology.find_isolated_core({6}), 3);
+    std::vector<int> cpu_ids;
+    ASSERT_TRUE(topology.find_isolated_cores(2, cpu_ids));
+    ASSERT_EQ(cpu_ids, std::vector<int>({2, 3}));
+    ASSERT_FALSE(topology.find_isolated_cores(3, cpu_ids));
+
+    int first_cpu_id = -1, second_cpu_id = -1;
+    ASSERT_TRUE(topology.find_physical_cores_sharing_cache(
+        2, first_cpu_id, second_cpu_id));
+    ASSERT_EQ(first_cpu_id, 2);
+    ASSERT_EQ(second_cpu_id, 3);
+    // the L1 is only shared by the SMT siblings of a core.
+    ASSERT_FALSE(topology.find_physical_cores_sharing_cache(
+        1, first_cpu_id, second_cpu_id));
+
+    // an SMT sibling that is not isolated makes the core unavailable.
+    write_fixture_file(cpu_root + "isolated", "2-3,6\n");
+    ASSERT_TRUE(topology.load(sys_root));
+    ASSERT_EQ(topology.find_isolated_core(), 2);
+    ASSERT_FALSE(topology.find_isolated_cores(2, cpu_ids));
+    ASSERT_TRUE(topology.find_physical_cores_sharing_cache(
+        2, first_cpu_id, second_cpu_id));
+    ASSERT_EQ(first_cpu_id, 0);
+    ASSERT_EQ(second_cpu_id, 1);
+}
+
 TEST_F(TestRealTimeTools, test_spinner_normal_behavior)
 {
     // some parameters
@@ -305,3 +881,88 @@ TEST_F(TestRealTimeTools, test_frequency_manager)
         ASSERT_EQ(success, false);
     }
 }
+
+void square_task(void* data, std::size_t index)
+{
+    std::vector<double>* vector = static_cast<std::vector<double>*>(data);
+    (*vector)[index] = static_cast<double>(index * index);
+}
+
+TEST_F(TestRealTimeTools, test_worker_pool_parallel_for)
+{
+    WorkerPool pool;
+    RealTimeThreadParameters parameters;
+    parameters.block_memory_ = false;
+    ASSERT_TRUE(pool.start({0, 0}, parameters));
+    ASSERT_EQ(pool.get_nb_workers(), 2u);
+
+    std::vector<double> squares(16, -1.0);
+    std::vector<std::atomic<int>> counts(16);
+    for (unsigned cycle = 0; cycle < 1000; ++cycle)
+    {
+        pool.parallel_for(&square_task, &squares, squares.size());
+        pool.parallel_for(counts.size(),
+                          [&counts](std::size_t i) { counts[i] += 1; });
+    }
+    pool.stop();
+    ASSERT_EQ(pool.get_nb_workers(), 0u);
+
+    for (std::size_t i = 0; i < squares.size(); ++i)
+    {
+        ASSERT_EQ(squares[i], static_cast<double>(i * i));
+        // every task ran exactly once per cycle
+        ASSERT_EQ(counts[i].load(), 1000);
+    }
+}
+
+TEST_F(TestRealTimeTools, test_periodic_task)
+{
+    double period_sec = 0.002;
+    std::atomic<int> nb_calls(0);
+    PeriodicTask task([&nb_calls]() { nb_calls += 1; }, period_sec);
+    task.get_thread_parameters().block_memory_ = false;
+
+    Timer timer;
+    timer.tic();
+    ASSERT_TRUE(task.start());
+    ASSERT_TRUE(task.is_running());
+    ASSERT_FALSE(task.start());
+    Timer::sleep_sec(0.5);
+    PeriodicTaskStatistics running_statistics = task.get_statistics();
+    task.stop();
+    double duration = timer.tac();
+    ASSERT_FALSE(task.is_running());
+
+    PeriodicTaskStatistics statistics = task.get_statistics();
+    task.print_statistics();
+    ASSERT_LE(running_statistics.nb_cycles_, statistics.nb_cycles_);
+    ASSERT_EQ(statistics.nb_cycles_, static_cast<uint64_t>(nb_calls.load()));
+    // the deadlines do not drift, the skipped ones are counted.
+    ASSERT_NEAR(static_cast<double>(statistics.nb_cycles_ +
+                                    statistics.nb_missed_deadlines_),
+                duration / period_sec,
+                5.0);
+    ASSERT_GE(statistics.min_wakeup_latency_, 0.0);
+    ASSERT_LE(statistics.min_wakeup_latency_, statistics.avg_wakeup_latency_);
+    ASSERT_LE(statistics.avg_wakeup_latency_, statistics.max_wakeup_latency_);
+    ASSERT_GE(statistics.min_execution_time_, 0.0);
+    ASSERT_LE(statistics.min_execution_time_, statistics.avg_execution_time_);
+    ASSERT_LE(statistics.avg_execution_time_, statistics.max_execution_time_);
+}
+
+TEST_F(TestRealTimeTools, test_periodic_task_overrun)
+{
+    double period_sec = 0.002;
+    PeriodicTask task([]() { Timer::sleep_sec(0.005); }, period_sec);
+    task.get_thread_parameters().block_memory_ = false;
+    ASSERT_TRUE(task.start());
+    Timer::sleep_sec(0.1);
+    task.stop();
+
+    PeriodicTaskStatistics statistics = task.get_statistics();
+    ASSERT_GT(statistics.nb_cycles_, 0u);
+    // every cycle overruns and skips at least two deadlines
+    ASSERT_EQ(statistics.nb_overruns_, statistics.nb_cycles_);
+    ASSERT_GE(statistics.nb_missed_deadlines_, 2 * statistics.nb_cycles_);
+    ASSERT_GE(statistics.min_execution_time_, 0.005);
+}
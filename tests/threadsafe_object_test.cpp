@@ -1,14 +1,61 @@
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/Geometry>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include "real_time_tools/thread.hpp"
+#include "real_time_tools/threadsafe/mpmc_queue.hpp"
+#include "real_time_tools/threadsafe/spsc_queue.hpp"
+#include "real_time_tools/threadsafe/threadsafe_history.hpp"
 #include "real_time_tools/threadsafe/threadsafe_object.hpp"
+#include "real_time_tools/threadsafe/triple_buffer.hpp"
 #include "real_time_tools/timer.hpp"
 
 using namespace real_time_tools;
 
+/**
+ * @brief Sample stored through a seqlock, all its values are equal unless a
+ * read is torn.
+ */
+struct SeqlockSample
+{
+    double values[32];
+};
+
+namespace real_time_tools
+{
+template <>
+struct use_seqlock_storage<SeqlockSample> : std::true_type
+{
+};
+}  // namespace real_time_tools
+
+/**
+ * @brief Another type of the same size as SeqlockSample.
+ */
+struct OtherSeqlockSample
+{
+    float values[64];
+};
+
+namespace real_time_tools
+{
+template <>
+struct use_seqlock_storage<OtherSeqlockSample> : std::true_type
+{
+};
+}  // namespace real_time_tools
+
 const int DATA_LENGTH = 10000;
 const int OUTPUT_COUNT = 5;
 
@@ -25,6 +72,9 @@ typedef std::tuple<std::array<Type0, DATA_LENGTH>,
 
 DataType input_data;
 std::array<DataType, OUTPUT_COUNT> output_data;
+// number of updates received and skipped by each output, for each data index.
+std::array<std::array<size_t, 4>, OUTPUT_COUNT> nb_received;
+std::array<std::array<size_t, 4>, OUTPUT_COUNT> nb_skipped;
 
 template <int INDEX, typename ThreadsafeObjectType>
 THREAD_FUNCTION_RETURN_TYPE input_function(void* void_ptr)
@@ -59,13 +109,22 @@ THREAD_FUNCTION_RETURN_TYPE output_function(void* void_ptr)
     logger.set_name("output " + std::to_string(DATA_INDEX) + ", " +
                     std::to_string(OUTPUT_INDEX));
 
-    for (size_t i = 0; i < DATA_LENGTH; i++)
+    // the reader may be slower than the writer, the updates it does not see
+    // are counted as skipped.
+    size_t sequence = 0;
+    size_t i = 0;
+    while (sequence < DATA_LENGTH)
     {
-        threadsafe_object_ptr->template wait_for_update<DATA_INDEX>();
-        std::get<DATA_INDEX>(output_data[OUTPUT_INDEX])[i] =
+        ThreadsafeUpdate update =
+            threadsafe_object_ptr->template wait_for_update<DATA_INDEX>(
+                sequence);
+        sequence = update.sequence_;
+        nb_skipped[OUTPUT_INDEX][DATA_INDEX] += update.nb_skipped_;
+        std::get<DATA_INDEX>(output_data[OUTPUT_INDEX])[i++] =
             threadsafe_object_ptr->template get<DATA_INDEX>();
         logger.tac_tic();
     }
+    nb_received[OUTPUT_INDEX][DATA_INDEX] = i;
 
     //    logger.print_statistics();
 
@@ -82,11 +141,15 @@ THREAD_FUNCTION_RETURN_TYPE complete_output_function(void* void_ptr)
     logger.set_memory_size(100);
     logger.set_name("complete output " + std::to_string(OUTPUT_INDEX));
 
-    int i_0, i_1, i_2, i_3 = 0;
-    for (size_t i = 0; i < 4 * DATA_LENGTH; i++)
+    int i_0 = 0, i_1 = 0, i_2 = 0, i_3 = 0;
+    size_t total_sequence = 0;
+    while (total_sequence < 4 * DATA_LENGTH)
     {
-        unsigned data_index = threadsafe_object_ptr->wait_for_update();
-        switch (data_index)
+        ThreadsafeUpdate update =
+            threadsafe_object_ptr->wait_for_any_update(total_sequence);
+        total_sequence = update.sequence_;
+        nb_skipped[OUTPUT_INDEX][0] += update.nb_skipped_;
+        switch (update.index_)
         {
             case 0:
                 std::get<0>(output_data[OUTPUT_INDEX])[i_0++] =
@@ -107,6 +170,7 @@ THREAD_FUNCTION_RETURN_TYPE complete_output_function(void* void_ptr)
         }
         logger.tac_tic();
     }
+    nb_received[OUTPUT_INDEX][0] = i_0 + i_1 + i_2 + i_3;
 
     logger.print_statistics();
 
@@ -130,3 +194,976 @@ void initialize_data_randomly()
         std::get<3>(input_data)[i] = Type3::Random();
     }
 }
+
+TEST(threadsafe_object, sequence_numbers)
+{
+    SingletypeThreadsafeObject<double, 2> singletype_object;
+    singletype_object.set(1.0, 1);
+    singletype_object.set(2.0, 1);
+    singletype_object.set(3.0, 1);
+    // the updates happened before the call, nothing blocks.
+    ThreadsafeUpdate update = singletype_object.wait_for_update(1, 0);
+    ASSERT_EQ(update.index_, 1u);
+    ASSERT_EQ(update.sequence_, 3u);
+    ASSERT_EQ(update.nb_skipped_, 2u);
+    singletype_object.set(4.0, 0);
+    update = singletype_object.wait_for_any_update(3);
+    ASSERT_EQ(update.index_, 0u);
+    ASSERT_EQ(update.sequence_, 4u);
+    ASSERT_EQ(update.nb_skipped_, 0u);
+    ASSERT_EQ(singletype_object.get_sequence(0), 1u);
+    ASSERT_EQ(singletype_object.get_total_sequence(), 4u);
+
+    ThreadsafeObject<int, double> object;
+    object.set<1>(1.0);
+    object.set<1>(2.0);
+    update = object.wait_for_update<1>(0);
+    ASSERT_EQ(update.sequence_, 2u);
+    ASSERT_EQ(update.nb_skipped_, 1u);
+    ASSERT_EQ(object.wait_for_any_update(1).index_, 1u);
+}
+
+TEST(threadsafe_object, producer_consumer_throughput)
+{
+    typedef ThreadsafeObject<Type0, Type1, Type2, Type3> ObjectType;
+    initialize_data_randomly();
+    ObjectType object;
+    for (size_t i = 0; i < OUTPUT_COUNT; i++)
+    {
+        nb_received[i].fill(0);
+        nb_skipped[i].fill(0);
+    }
+
+    // the consumers start first to see the first updates.
+    std::vector<std::shared_ptr<RealTimeThread> > threads;
+    for (int i = 0; i < 9; i++)
+    {
+        threads.push_back(std::make_shared<RealTimeThread>());
+    }
+    threads[0]->create_realtime_thread(&output_function<0, 0, ObjectType>,
+                                       &object);
+    threads[1]->create_realtime_thread(&output_function<1, 0, ObjectType>,
+                                       &object);
+    threads[2]->create_realtime_thread(&output_function<2, 0, ObjectType>,
+                                       &object);
+    threads[3]->create_realtime_thread(&output_function<3, 0, ObjectType>,
+                                       &object);
+    threads[4]->create_realtime_thread(&complete_output_function<1, ObjectType>,
+                                       &object);
+    Timer::sleep_sec(0.01);
+
+    double start_date = Timer::get_current_time_sec();
+    threads[5]->create_realtime_thread(&input_function<0, ObjectType>,
+                                       &object);
+    threads[6]->create_realtime_thread(&input_function<1, ObjectType>,
+                                       &object);
+    threads[7]->create_realtime_thread(&input_function<2, ObjectType>,
+                                       &object);
+    threads[8]->create_realtime_thread(&input_function<3, ObjectType>,
+                                       &object);
+    for (int i = 8; i >= 0; i--)
+    {
+        threads[i]->join();
+    }
+    double duration = Timer::get_current_time_sec() - start_date;
+
+    // every update is either received or reported as skipped.
+    size_t nb_received_total = 0;
+    for (int data_index = 0; data_index < 4; data_index++)
+    {
+        ASSERT_EQ(nb_received[0][data_index] + nb_skipped[0][data_index],
+                  static_cast<size_t>(DATA_LENGTH));
+        nb_received_total += nb_received[0][data_index];
+    }
+    ASSERT_EQ(nb_received[1][0] + nb_skipped[1][0],
+              static_cast<size_t>(4 * DATA_LENGTH));
+    // the last value read is the last value written.
+    ASSERT_EQ(std::get<2>(output_data[0])[nb_received[0][2] - 1],
+              std::get<2>(input_data)[DATA_LENGTH - 1]);
+
+    rt_printf(
+        "threadsafe object throughput: %f updates/s written, %f updates/s "
+        "received per index (%lu of %d), %f updates/s received by the "
+        "complete output (%lu of %d)\n",
+        4 * DATA_LENGTH / duration,
+        nb_received_total / duration,
+        static_cast<unsigned long>(nb_received_total),
+        4 * DATA_LENGTH,
+        nb_received[1][0] / duration,
+        static_cast<unsigned long>(nb_received[1][0]),
+        4 * DATA_LENGTH);
+}
+
+TEST(threadsafe_object, per_index_wakeups)
+{
+    SingletypeThreadsafeObject<double, 2> object;
+    std::atomic<int> nb_woken_0(0);
+    std::atomic<int> nb_woken_1(0);
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 6; i++)
+    {
+        size_t index = i % 2;
+        std::atomic<int>* nb_woken = index == 0 ? &nb_woken_0 : &nb_woken_1;
+        waiters.push_back(std::thread([&object, index, nb_woken]() {
+            object.wait_for_update(index, 0);
+            ++(*nb_woken);
+        }));
+    }
+    Timer::sleep_sec(0.01);
+
+    // the updates of index 0 only release the waiters of index 0.
+    object.set(1.0, 0);
+    while (nb_woken_0 < 3)
+    {
+        Timer::sleep_sec(0.001);
+    }
+    Timer::sleep_sec(0.01);
+    ASSERT_EQ(nb_woken_1, 0);
+
+    object.set(2.0, 1);
+    for (std::thread& waiter : waiters)
+    {
+        waiter.join();
+    }
+    ASSERT_EQ(nb_woken_1, 3);
+}
+
+TEST(threadsafe_object, names)
+{
+    constexpr ThreadsafeNames<3> names("hip", "knee", "ankle");
+    static_assert(names.index("knee") == 1, "resolved at compile time");
+    static_assert(names.name(2) == "ankle", "resolved at compile time");
+
+    SingletypeThreadsafeObject<double, names.size()> object(names);
+    object.set<names.index("knee")>(1.0);
+    ASSERT_EQ(object.get(1), 1.0);
+    ASSERT_EQ(object.get("knee"), 1.0);
+    object.set(2.0, std::string("ankle"));
+    ASSERT_EQ(object.get<names.index("ankle")>(), 2.0);
+    ASSERT_EQ(object.get_index("hip"), 0u);
+    ASSERT_THROW(object.get("elbow"), std::out_of_range);
+
+    // the names given at run time.
+    SingletypeThreadsafeObject<double, 2> runtime_object({"left", "right"});
+    runtime_object.set(3.0, "right");
+    ASSERT_EQ(runtime_object.get(1), 3.0);
+    ASSERT_EQ(runtime_object.get_sequence(1), 1u);
+}
+
+TEST(threadsafe_object, wait_with_timeout)
+{
+    SingletypeThreadsafeObject<double, 2> object;
+    ThreadsafeUpdate update;
+
+    // nobody writes: the wait returns after the timeout.
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    ASSERT_FALSE(
+        object.wait_for_update_for(1, std::chrono::milliseconds(20), update));
+    ASSERT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(20));
+    ASSERT_FALSE(object.wait_for_update_until(1, start, update, 0));
+
+    // the update is already there, even with a past deadline.
+    object.set(1.0, 1);
+    object.set(2.0, 1);
+    ASSERT_TRUE(object.wait_for_update_until(1, start, update, 0));
+    ASSERT_EQ(update.index_, 1u);
+    ASSERT_EQ(update.sequence_, 2u);
+    ASSERT_EQ(update.nb_skipped_, 1u);
+    ASSERT_TRUE(
+        object.wait_for_update_for(1, std::chrono::seconds(0), update, 1));
+    ASSERT_EQ(update.sequence_, 2u);
+
+    // an update wakes up the waiter before the deadline.
+    ThreadsafeObject<int, double> multitype_object;
+    std::thread writer([&multitype_object]() {
+        Timer::sleep_sec(0.01);
+        multitype_object.set<1>(3.0);
+    });
+    start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(multitype_object.wait_for_update_for(
+        1, std::chrono::seconds(10), update, 0));
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::seconds(5));
+    writer.join();
+    ASSERT_EQ(update.index_, 1u);
+    ASSERT_EQ(update.sequence_, 1u);
+    ASSERT_EQ(multitype_object.get<1>(), 3.0);
+    ASSERT_FALSE(multitype_object.wait_for_update_for(
+        0, std::chrono::microseconds(100), update));
+}
+
+TEST(threadsafe_object, transactions)
+{
+    ThreadsafeObject<int, double, Type3> object;
+    object.set_many<0, 1>(1, 2.0);
+    ASSERT_EQ(object.get_sequence(0), 1u);
+    ASSERT_EQ(object.get_sequence(1), 1u);
+    ASSERT_EQ(object.get_sequence(2), 0u);
+    // one update for the threads waiting for any index.
+    ASSERT_EQ(object.get_total_sequence(), 1u);
+    ASSERT_EQ(object.wait_for_any_update(0).nb_skipped_, 0u);
+    std::tuple<int, double> snapshot = object.get_many<0, 1>();
+    ASSERT_EQ(std::get<0>(snapshot), 1);
+    ASSERT_EQ(std::get<1>(snapshot), 2.0);
+
+    // the reader never sees the fields of different transactions.
+    const int nb_transactions = 20000;
+    object.set_many<0, 1, 2>(0, 0.0, Type3::Zero());
+    std::atomic<bool> stop(false);
+    std::thread writer([&object, &stop]() {
+        for (int i = 0; i < nb_transactions; i++)
+        {
+            object.set_many<0, 1, 2>(i, -i, Type3::Constant(i));
+        }
+        stop = true;
+    });
+    int nb_inconsistent = 0;
+    while (!stop)
+    {
+        std::tuple<int, double, Type3> snapshot =
+            object.get_many<0, 1, 2>();
+        if (std::get<0>(snapshot) != -std::get<1>(snapshot) ||
+            std::get<2>(snapshot)(2, 2) != std::get<0>(snapshot) ||
+            std::get<2>(snapshot)(0, 0) != std::get<0>(snapshot))
+        {
+            nb_inconsistent++;
+        }
+    }
+    writer.join();
+    ASSERT_EQ(nb_inconsistent, 0);
+    ASSERT_EQ(std::get<0>(object.get_many<0>()), nb_transactions - 1);
+}
+
+TEST(threadsafe_object, cache_aligned_layout)
+{
+    typedef ThreadsafeSlot<double, ThreadsafeLayout::CACHE_ALIGNED> Slot;
+    static_assert(alignof(Slot) == 64, "the slots start a cache line");
+    static_assert(sizeof(Slot) % 64 == 0, "the slots end a cache line");
+
+    SingletypeThreadsafeObject<double, 4, ThreadsafeLayout::CACHE_ALIGNED>
+        object;
+    std::vector<std::thread> writers;
+    for (size_t index = 0; index < 4; index++)
+    {
+        writers.push_back(std::thread([&object, index]() {
+            for (int i = 0; i < 1000; i++)
+            {
+                object.set(i + index, index);
+            }
+        }));
+    }
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    for (size_t index = 0; index < 4; index++)
+    {
+        ASSERT_EQ(object.get(index), 999.0 + index);
+        ASSERT_EQ(object.get_sequence(index), 1000u);
+    }
+    ASSERT_EQ(object.get_total_sequence(), 4000u);
+}
+
+/**
+ * @brief Large payload that counts its copies.
+ */
+struct CountedPayload
+{
+    CountedPayload() = default;
+    CountedPayload(size_t size, double value) : values(size, value)
+    {
+    }
+    CountedPayload(const CountedPayload& other) : values(other.values)
+    {
+        nb_copies++;
+    }
+    CountedPayload(CountedPayload&&) = default;
+    CountedPayload& operator=(const CountedPayload& other)
+    {
+        values = other.values;
+        nb_copies++;
+        return *this;
+    }
+    CountedPayload& operator=(CountedPayload&&) = default;
+
+    std::vector<double> values;
+    static int nb_copies;
+};
+int CountedPayload::nb_copies = 0;
+
+TEST(threadsafe_object, zero_copy)
+{
+    SingletypeThreadsafeObject<CountedPayload, 2> object;
+    CountedPayload payload(1000, 1.0);
+    const double* values = payload.values.data();
+    CountedPayload::nb_copies = 0;
+    object.set(std::move(payload), 1);
+    object.emplace(0, 1000, 2.0);
+    const double* read_values = object.read(
+        [](const CountedPayload& stored) { return stored.values.data(); }, 1);
+    ASSERT_EQ(read_values, values);
+    double last_value = object.read(
+        [](const CountedPayload& stored) { return stored.values[999]; });
+    ASSERT_EQ(last_value, 2.0);
+    ASSERT_EQ(CountedPayload::nb_copies, 0);
+    ASSERT_EQ(object.get_sequence(0), 1u);
+    ASSERT_EQ(object.get_sequence(1), 1u);
+    ASSERT_EQ(object.get_total_sequence(), 2u);
+
+    ThreadsafeObject<int, CountedPayload> multitype_object;
+    multitype_object.set<1>(CountedPayload(1000, 3.0));
+    multitype_object.emplace<1>(1000, 4.0);
+    double sum = multitype_object.read<1>([](const CountedPayload& stored) {
+        double sum = 0.0;
+        for (double value : stored.values)
+        {
+            sum += value;
+        }
+        return sum;
+    });
+    ASSERT_EQ(sum, 4000.0);
+    ASSERT_EQ(CountedPayload::nb_copies, 0);
+    ASSERT_EQ(multitype_object.get_sequence(1), 2u);
+
+    // the seqlock storage calls the callable on a copy.
+    SingletypeThreadsafeObject<SeqlockSample, 1> seqlock_object;
+    seqlock_object.emplace(0, SeqlockSample{{5.0}});
+    ASSERT_EQ(seqlock_object.read(
+                  [](const SeqlockSample& sample) { return sample.values[0]; }),
+              5.0);
+}
+
+TEST(threadsafe_object, history)
+{
+    ThreadsafeHistory<int, 4> history;
+    HistoryElement<int> element;
+    ASSERT_EQ(history.get(0, element), HistoryStatus::NOT_ADDED_YET);
+    ASSERT_EQ(history.add(10, 1.0), 0u);
+    ASSERT_EQ(history.add(11, 2.0), 1u);
+    ASSERT_EQ(history.get(1, element), HistoryStatus::OK);
+    ASSERT_EQ(element.id_, 1u);
+    ASSERT_EQ(element.timestamp_, 2.0);
+    ASSERT_EQ(element.datum_, 11);
+    ASSERT_EQ(history.try_get_next(1, element), HistoryStatus::NOT_ADDED_YET);
+
+    // the reader of the element 1 falls behind.
+    for (int i = 2; i < 10; i++)
+    {
+        history.add(10 + i, i + 1.0);
+    }
+    ASSERT_EQ(history.get_newest_id(), 9u);
+    ASSERT_EQ(history.get_oldest_id(), 6u);
+    ASSERT_EQ(history.get(1, element), HistoryStatus::OVERWRITTEN);
+    // it skips the lost elements, up to the one before the resume point.
+    ASSERT_EQ(history.try_get_next(1, element, HistoryResume::OLDEST),
+              HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(element.id_, 5u);
+    ASSERT_EQ(history.try_get_next(1, element, HistoryResume::NEWEST),
+              HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(element.id_, 8u);
+    ASSERT_EQ(history.try_get_next(1, element), HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(element.id_, 7u);
+    ASSERT_EQ(history.get_next(element.id_, element), HistoryStatus::OK);
+    ASSERT_EQ(element.id_, 8u);
+    ASSERT_EQ(element.datum_, 18);
+    ASSERT_EQ(history.get_newest().datum_, 19);
+}
+
+TEST(threadsafe_object, history_at)
+{
+    ThreadsafeHistory<double, 8> history;
+    HistoryElement<double> element;
+    ASSERT_EQ(history.at(0.0, element), HistoryStatus::NOT_ADDED_YET);
+    // the value 10 * t every 0.1 s, from t = 0 to t = 1.
+    for (int i = 0; i <= 10; i++)
+    {
+        history.add(i, 0.1 * i);
+    }
+    ASSERT_EQ(history.at(0.25, element), HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(history.at(0.55, element, HistoryLookup::PREVIOUS),
+              HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 5.0);
+    ASSERT_EQ(history.at(0.58, element, HistoryLookup::NEAREST),
+              HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 6.0);
+    ASSERT_EQ(element.id_, 6u);
+    ASSERT_EQ(history.at(0.725, element, HistoryLookup::INTERPOLATE),
+              HistoryStatus::OK);
+    ASSERT_NEAR(element.datum_, 7.25, 1e-9);
+    ASSERT_EQ(element.id_, 7u);
+    ASSERT_EQ(history.at(1.0, element, HistoryLookup::INTERPOLATE),
+              HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 10.0);
+    // no extrapolation.
+    ASSERT_EQ(history.at(1.5, element, HistoryLookup::INTERPOLATE),
+              HistoryStatus::NOT_ADDED_YET);
+    ASSERT_EQ(history.at(1.5, element, HistoryLookup::PREVIOUS),
+              HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 10.0);
+
+    // Eigen vectors are interpolated linearly, quaternions with slerp.
+    ThreadsafeHistory<Eigen::Vector3d, 4> vectors;
+    vectors.add(Eigen::Vector3d::Zero(), 0.0);
+    vectors.add(Eigen::Vector3d::Ones(), 1.0);
+    HistoryElement<Eigen::Vector3d> vector;
+    vectors.at(0.5, vector, HistoryLookup::INTERPOLATE);
+    ASSERT_TRUE(vector.datum_.isApprox(Eigen::Vector3d::Constant(0.5)));
+
+    ThreadsafeHistory<Eigen::Quaterniond, 4> orientations;
+    orientations.add(Eigen::Quaterniond::Identity(), 0.0);
+    Eigen::Vector3d z_axis = Eigen::Vector3d::UnitZ();
+    orientations.add(Eigen::Quaterniond(Eigen::AngleAxisd(M_PI / 2, z_axis)),
+                     1.0);
+    HistoryElement<Eigen::Quaterniond> orientation;
+    orientations.at(0.5, orientation, HistoryLookup::INTERPOLATE);
+    ASSERT_TRUE(orientation.datum_.isApprox(
+        Eigen::Quaterniond(Eigen::AngleAxisd(M_PI / 4, z_axis))));
+}
+
+TEST(threadsafe_object, history_concurrent_readers)
+{
+    const size_t nb_elements = 100000;
+    const size_t nb_readers = 3;
+    ThreadsafeHistory<SeqlockSample, 64> history;
+    std::array<size_t, nb_readers> nb_read_or_lost;
+    std::array<size_t, nb_readers> first_ids;
+    std::array<bool, nb_readers> consistent;
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < nb_readers; r++)
+    {
+        readers.push_back(std::thread([&, r]() {
+            HistoryElement<SeqlockSample> element;
+            first_ids[r] = history.get_oldest_id();
+            element.id_ = first_ids[r];
+            nb_read_or_lost[r] = 1;
+            consistent[r] = true;
+            while (element.id_ + 1 < nb_elements)
+            {
+                size_t id = element.id_;
+                HistoryStatus status = history.get_next(id, element);
+                // the elements lost are reported in the id.
+                nb_read_or_lost[r] += element.id_ - id;
+                // every value of the element n holds n.
+                consistent[r] = consistent[r] &&
+                                (status == HistoryStatus::OVERWRITTEN ||
+                                 (element.datum_.values[0] == element.id_ &&
+                                  element.datum_.values[31] == element.id_ &&
+                                  element.timestamp_ == element.id_));
+            }
+        }));
+    }
+
+    SeqlockSample sample;
+    for (size_t i = 0; i < nb_elements; i++)
+    {
+        for (double& value : sample.values)
+        {
+            value = i;
+        }
+        history.add(sample, i);
+    }
+    for (size_t r = 0; r < nb_readers; r++)
+    {
+        readers[r].join();
+        ASSERT_TRUE(consistent[r]);
+        ASSERT_EQ(nb_read_or_lost[r], nb_elements - first_ids[r]);
+    }
+}
+
+TEST(threadsafe_object, shared_memory)
+{
+    typedef SingletypeThreadsafeObject<SeqlockSample, 2> ObjectType;
+    const std::string segment_name = "real_time_tools_test_shared_memory";
+    ObjectType reader;
+    ASSERT_FALSE(reader.open_shared_memory(segment_name));
+
+    ObjectType writer;
+    ASSERT_TRUE(writer.create_shared_memory(segment_name));
+    ASSERT_TRUE(reader.open_shared_memory(segment_name));
+    SingletypeThreadsafeObject<SeqlockSample, 3> other_size;
+    ASSERT_FALSE(other_size.open_shared_memory(segment_name));
+    static_assert(sizeof(OtherSeqlockSample) == sizeof(SeqlockSample),
+                  "only the type differs");
+    SingletypeThreadsafeObject<OtherSeqlockSample, 2> other_type;
+    ASSERT_FALSE(other_type.open_shared_memory(segment_name));
+    // the segment of a running writer is not replaced by accident.
+    ObjectType other_writer;
+    ASSERT_FALSE(other_writer.create_shared_memory(segment_name));
+
+    // a child process waits for the update of the index 1.
+    pid_t child = fork();
+    if (child == 0)
+    {
+        ObjectType object;
+        if (!object.open_shared_memory(segment_name))
+        {
+            _exit(2);
+        }
+        ThreadsafeUpdate update = object.wait_for_update(1, 0);
+        _exit(update.sequence_ == 1 && object.get(1).values[31] == 42.0
+                  ? 0
+                  : 1);
+    }
+    ASSERT_GT(child, 0);
+    Timer::sleep_sec(0.05);
+    SeqlockSample sample;
+    for (double& value : sample.values)
+    {
+        value = 42.0;
+    }
+    writer.set(sample, 1);
+    int status = -1;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    // the other mapping of this process sees the update too.
+    ASSERT_EQ(reader.get_sequence(1), 1u);
+    ASSERT_EQ(reader.get(1).values[0], 42.0);
+}
+
+TEST(threadsafe_object, shared_memory_replace)
+{
+    typedef SingletypeThreadsafeObject<SeqlockSample, 2> ObjectType;
+    const std::string segment_name = "real_time_tools_test_shared_memory_left";
+    // a segment left by a process that crashed.
+    int file_descriptor = shm_open(
+        ("/" + segment_name).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+    ASSERT_NE(file_descriptor, -1);
+    close(file_descriptor);
+
+    ObjectType writer;
+    ASSERT_FALSE(writer.create_shared_memory(segment_name));
+    ASSERT_TRUE(writer.create_shared_memory(segment_name, true));
+    ObjectType reader;
+    ASSERT_TRUE(reader.open_shared_memory(segment_name));
+    writer.set(SeqlockSample{{3.0}}, 0);
+    ASSERT_EQ(reader.get(0).values[0], 3.0);
+}
+
+TEST(threadsafe_object, seqlock_storage)
+{
+    static_assert(!use_seqlock_storage<double>::value,
+                  "the mutex storage is the default");
+    SingletypeThreadsafeObject<SeqlockSample, 2> object;
+    ASSERT_EQ(object.get(1).values[31], 0.0);
+
+    // readers check that no read is torn while the writer never stops.
+    std::atomic<bool> stop(false);
+    std::atomic<int> nb_torn_reads(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; i++)
+    {
+        readers.push_back(std::thread([&object, &stop, &nb_torn_reads]() {
+            while (!stop)
+            {
+                SeqlockSample sample = object.get(1);
+                for (int j = 1; j < 32; j++)
+                {
+                    if (sample.values[j] != sample.values[0])
+                    {
+                        ++nb_torn_reads;
+                        break;
+                    }
+                }
+            }
+        }));
+    }
+    SeqlockSample sample;
+    for (int i = 1; i <= 100000; i++)
+    {
+        std::fill(sample.values, sample.values + 32, static_cast<double>(i));
+        object.set(sample, 1);
+    }
+    stop = true;
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    ASSERT_EQ(nb_torn_reads, 0);
+    ASSERT_EQ(object.get(1).values[0], 100000.0);
+    ASSERT_EQ(object.get_sequence(1), 100000u);
+}
+
+TEST(threadsafe_object, triple_buffer)
+{
+    TripleBuffer<SeqlockSample> buffer;
+    ASSERT_FALSE(buffer.update());
+    ASSERT_EQ(buffer.get_front_buffer().values[0], 0.0);
+
+    // the reader sees complete values, in order, and the last one.
+    const int nb_values = 100000;
+    std::atomic<bool> stop(false);
+    bool consistent = true;
+    double last_value = 0.0;
+    std::thread reader([&]() {
+        while (!stop || buffer.has_update())
+        {
+            const SeqlockSample& sample = buffer.get();
+            for (int j = 1; j < 32; j++)
+            {
+                consistent = consistent && sample.values[j] == sample.values[0];
+            }
+            consistent = consistent && sample.values[0] >= last_value;
+            last_value = sample.values[0];
+        }
+    });
+    for (int i = 1; i <= nb_values; i++)
+    {
+        SeqlockSample& sample = buffer.get_back_buffer();
+        std::fill(sample.values, sample.values + 32, static_cast<double>(i));
+        buffer.publish();
+    }
+    stop = true;
+    reader.join();
+    ASSERT_TRUE(consistent);
+    ASSERT_EQ(last_value, static_cast<double>(nb_values));
+}
+
+TEST(threadsafe_object, mpmc_queue)
+{
+    MpmcQueue<int, 4> queue;
+    int datum = 0;
+    ASSERT_FALSE(queue.try_pop(datum));
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(queue.try_push(i));
+    }
+    ASSERT_FALSE(queue.try_push(5));
+    ASSERT_EQ(queue.size(), 4u);
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(queue.try_pop(datum));
+        ASSERT_EQ(datum, i);
+    }
+    ASSERT_FALSE(queue.try_pop(datum));
+
+    // every element pushed by the producers is popped exactly once, in the
+    // order of its producer.
+    const int nb_producers = 3;
+    const int nb_consumers = 2;
+    const int nb_elements = 20000;
+    MpmcQueue<std::pair<int, int>, 64> pairs;
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < nb_producers; producer++)
+    {
+        threads.push_back(std::thread([&pairs, producer]() {
+            for (int i = 0; i < nb_elements; i++)
+            {
+                pairs.push(std::make_pair(producer, i));
+            }
+        }));
+    }
+    std::vector<std::vector<int>> received(nb_consumers * nb_producers);
+    for (int consumer = 0; consumer < nb_consumers; consumer++)
+    {
+        threads.push_back(std::thread([&pairs, &received, consumer]() {
+            for (int i = 0; i < nb_producers * nb_elements / nb_consumers; i++)
+            {
+                std::pair<int, int> pair;
+                pairs.pop(pair);
+                received[consumer * nb_producers + pair.first].push_back(
+                    pair.second);
+            }
+        }));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    std::vector<int> nb_received(nb_producers, 0);
+    for (int consumer = 0; consumer < nb_consumers; consumer++)
+    {
+        for (int producer = 0; producer < nb_producers; producer++)
+        {
+            const std::vector<int>& values =
+                received[consumer * nb_producers + producer];
+            ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+            nb_received[producer] += values.size();
+        }
+    }
+    for (int producer = 0; producer < nb_producers; producer++)
+    {
+        ASSERT_EQ(nb_received[producer], nb_elements);
+    }
+    ASSERT_EQ(pairs.size(), 0u);
+}
+
+TEST(threadsafe_object, spsc_queue)
+{
+    SpscQueue<int, 8> queue(4);
+    int data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ASSERT_EQ(queue.push_n(data, 6), 6u);
+    ASSERT_EQ(queue.push_n(data + 6, 4), 2u);
+    ASSERT_FALSE(queue.try_push(8));
+    int popped[10];
+    ASSERT_EQ(queue.pop_n(popped, 5), 5u);
+    ASSERT_EQ(popped[4], 4);
+    ASSERT_EQ(queue.push_n(data + 8, 2), 2u);
+
+    // the span stops at the end of the ring.
+    SpscSpan<const int> span = queue.peek();
+    ASSERT_EQ(span.size(), 3u);
+    ASSERT_EQ(span[0], 5);
+    queue.consume(span.size());
+    span = queue.peek();
+    ASSERT_EQ(span.size(), 2u);
+    ASSERT_EQ(span[1], 9);
+    queue.consume(2);
+    ASSERT_EQ(queue.size(), 0u);
+
+    // consuming more than queued only removes the queued elements.
+    queue.push_n(data, 3);
+    ASSERT_EQ(queue.consume(5), 3u);
+    ASSERT_EQ(queue.size(), 0u);
+    ASSERT_EQ(queue.consume(1), 0u);
+    ASSERT_EQ(queue.peek().size(), 0u);
+    ASSERT_TRUE(queue.try_push(42));
+    ASSERT_TRUE(queue.try_pop(popped[0]));
+    ASSERT_EQ(popped[0], 42);
+
+    // below the watermark, the consumer sleeps until the timeout.
+    queue.try_push(0);
+    ASSERT_FALSE(queue.wait_for_elements_for(std::chrono::milliseconds(5)));
+    queue.pop_n(popped, 10);
+
+    // the consumer sees all the elements in order, woken up by batches.
+    const int nb_elements = 100000;
+    SpscQueue<int, 256> stream(32);
+    std::thread producer([&stream]() {
+        int batch[7];
+        int next = 0;
+        while (next < nb_elements)
+        {
+            int batch_size = std::min(1 + next % 7, nb_elements - next);
+            for (int i = 0; i < batch_size; i++)
+            {
+                batch[i] = next + i;
+            }
+            next += stream.push_n(batch, batch_size);
+        }
+    });
+    int expected = 0;
+    bool in_order = true;
+    while (expected < nb_elements)
+    {
+        stream.wait_for_elements_for(std::chrono::milliseconds(1));
+        SpscSpan<const int> values = stream.peek();
+        for (int value : values)
+        {
+            in_order = in_order && value == expected;
+            expected++;
+        }
+        stream.consume(values.size());
+    }
+    producer.join();
+    ASSERT_TRUE(in_order);
+    ASSERT_EQ(stream.size(), 0u);
+}
+
+TEST(threadsafe_object, history_reader)
+{
+    ThreadsafeHistory<int, 8> history;
+    HistoryReader<int, 8> fast_reader(history);
+    HistoryReader<int, 8> slow_reader(history);
+    HistoryElement<int> element;
+    ASSERT_EQ(fast_reader.try_read(element), HistoryStatus::NOT_ADDED_YET);
+
+    // every reader sees every element, at its own pace.
+    for (int i = 0; i < 5; i++)
+    {
+        history.add(i);
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_EQ(fast_reader.try_read(element), HistoryStatus::OK);
+        ASSERT_EQ(element.datum_, i);
+    }
+    ASSERT_EQ(fast_reader.get_lag(), 0u);
+    ASSERT_EQ(slow_reader.get_lag(), 5u);
+    ASSERT_EQ(slow_reader.read(element), HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 0);
+
+    // the writer overruns the slow readers: they skip the lost elements and
+    // resume at the oldest one or half the capacity behind the newest one.
+    HistoryReader<int, 8> oldest_reader(history, HistoryResume::OLDEST);
+    for (int i = 5; i < 20; i++)
+    {
+        history.add(i);
+    }
+    ASSERT_EQ(slow_reader.get_lag(), 19u);
+    ASSERT_EQ(slow_reader.try_read(element), HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(slow_reader.get_cursor(), 16u);
+    ASSERT_EQ(slow_reader.get_nb_lost_elements(), 15u);
+    ASSERT_EQ(slow_reader.get_nb_overruns(), 1u);
+    ASSERT_EQ(slow_reader.try_read(element), HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 16);
+    ASSERT_EQ(oldest_reader.read(element), HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(oldest_reader.get_cursor(), 12u);
+    ASSERT_EQ(oldest_reader.get_nb_lost_elements(), 7u);
+    ASSERT_EQ(oldest_reader.read(element), HistoryStatus::OK);
+    ASSERT_EQ(element.datum_, 12);
+    ASSERT_EQ(fast_reader.get_nb_overruns(), 0u);
+
+    // concurrent readers see increasing elements, read or counted as lost.
+    const int nb_elements = 100000;
+    ThreadsafeHistory<int, 64> stream;
+    std::vector<HistoryReader<int, 64>> readers(
+        4, HistoryReader<int, 64>(stream));
+    std::vector<std::thread> reader_threads;
+    std::vector<size_t> nb_read(readers.size(), 0);
+    std::vector<int> in_order(readers.size(), true);
+    for (size_t r = 0; r < readers.size(); r++)
+    {
+        reader_threads.push_back(std::thread([&, r]() {
+            HistoryElement<int> value;
+            value.datum_ = -1;
+            while (value.datum_ < nb_elements - 1)
+            {
+                int last = value.datum_;
+                if (readers[r].read(value) == HistoryStatus::OK)
+                {
+                    in_order[r] = in_order[r] && value.datum_ > last;
+                    nb_read[r]++;
+                }
+            }
+        }));
+    }
+    for (int i = 0; i < nb_elements; i++)
+    {
+        stream.add(i, i);
+    }
+    for (size_t r = 0; r < readers.size(); r++)
+    {
+        reader_threads[r].join();
+        ASSERT_TRUE(in_order[r]);
+        ASSERT_EQ(nb_read[r] + readers[r].get_nb_lost_elements(),
+                  static_cast<size_t>(nb_elements));
+    }
+}
+
+TEST(threadsafe_object, history_reader_overrun)
+{
+    // slow readers are overrun again and again while the writer keeps
+    // adding, whatever they resume at.
+    const int nb_elements = 20000;
+    ThreadsafeHistory<int, 8> history;
+    std::vector<HistoryReader<int, 8>> readers = {
+        HistoryReader<int, 8>(history, HistoryResume::OLDEST),
+        HistoryReader<int, 8>(history, HistoryResume::HALF_CAPACITY),
+        HistoryReader<int, 8>(history, HistoryResume::NEWEST)};
+    std::vector<std::thread> reader_threads;
+    std::vector<size_t> nb_read(readers.size(), 0);
+    std::vector<int> in_order(readers.size(), true);
+    for (size_t r = 0; r < readers.size(); r++)
+    {
+        reader_threads.push_back(std::thread([&, r]() {
+            HistoryElement<int> element;
+            int last = -1;
+            while (readers[r].get_cursor() < static_cast<size_t>(nb_elements))
+            {
+                if (readers[r].read(element) == HistoryStatus::OK)
+                {
+                    in_order[r] = in_order[r] && element.datum_ > last &&
+                                  element.datum_ == int(element.id_);
+                    last = element.datum_;
+                    nb_read[r]++;
+                }
+                std::this_thread::yield();
+            }
+        }));
+    }
+    for (int i = 0; i < nb_elements; i++)
+    {
+        history.add(i, i);
+        if (i % 64 == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (size_t r = 0; r < readers.size(); r++)
+    {
+        reader_threads[r].join();
+        ASSERT_TRUE(in_order[r]);
+        ASSERT_EQ(nb_read[r] + readers[r].get_nb_lost_elements(),
+                  static_cast<size_t>(nb_elements));
+        ASSERT_EQ(readers[r].get_cursor(), static_cast<size_t>(nb_elements));
+    }
+}
+
+/**
+ * @brief A type stored with a mutex, whose copies wait while blocked is set.
+ */
+struct SlowCopy
+{
+    SlowCopy(int value = 0) : value(value)
+    {
+    }
+    SlowCopy(const SlowCopy& other) : value(other.value)
+    {
+        copying = true;
+        while (blocked)
+        {
+            std::this_thread::yield();
+        }
+    }
+    SlowCopy& operator=(const SlowCopy& other) = default;
+    int value;
+    static std::atomic<bool> blocked;
+    static std::atomic<bool> copying;
+};
+std::atomic<bool> SlowCopy::blocked(false);
+std::atomic<bool> SlowCopy::copying(false);
+
+namespace real_time_tools
+{
+template <>
+struct history_interpolation<SlowCopy>
+{
+    static SlowCopy interpolate(const SlowCopy& before,
+                                const SlowCopy&,
+                                double)
+    {
+        return before;
+    }
+};
+}  // namespace real_time_tools
+
+TEST(threadsafe_object, history_drop)
+{
+    ThreadsafeHistory<SlowCopy, 2> history;
+    history.add(SlowCopy(0), 0.0);
+    history.add(SlowCopy(1), 1.0);
+
+    // a reader is copying the oldest element when the writer wraps around.
+    SlowCopy::blocked = true;
+    SlowCopy::copying = false;
+    HistoryStatus reader_status = HistoryStatus::OK;
+    std::thread reader([&history, &reader_status]() {
+        HistoryElement<SlowCopy> element;
+        reader_status = history.get(0, element);
+    });
+    while (!SlowCopy::copying)
+    {
+        std::this_thread::yield();
+    }
+    // the writer does not wait for it, it drops the element 2 instead.
+    ASSERT_EQ(history.add(SlowCopy(2), 2.0), 2u);
+    SlowCopy::blocked = false;
+    reader.join();
+    ASSERT_EQ(reader_status, HistoryStatus::OVERWRITTEN);
+
+    HistoryElement<SlowCopy> element;
+    ASSERT_EQ(history.get(2, element), HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(history.get_newest().datum_.value, 1);
+    ASSERT_EQ(history.at(2.5, element), HistoryStatus::OVERWRITTEN);
+    // the readers skip the dropped element only.
+    ASSERT_EQ(history.try_get_next(1, element), HistoryStatus::OVERWRITTEN);
+    ASSERT_EQ(element.id_, 2u);
+    history.add(SlowCopy(3), 3.0);
+    ASSERT_EQ(history.try_get_next(2, element), HistoryStatus::OK);
+    ASSERT_EQ(element.datum_.value, 3);
+    ASSERT_EQ(history.get_newest().datum_.value, 3);
+}